@@ -7,6 +7,7 @@
 
 #include <iostream>
 #include "gambit.h"
+#include "games/gametable.h"
 #include "solvers/gnm/gnm.h"
 #include "../include/gambit_c_api.h"
 
@@ -38,18 +39,7 @@ double* nfggnm_c(const int num_players, const double *pay_off_data, const int da
     Game game = nfg;
     nfg->SetTitle("NA");
     nfg->SetComment("NA");
-    
-    StrategyProfileIterator iter(StrategySupportProfile(static_cast<GameRep *>(nfg)));
-    int pl = 1;
-    
-    for (int i = 0; i < data_length; i++) {
-      std::string currentNumber = std::to_string(pay_off_data[i]);
-      (*iter)->GetOutcome()->SetPayoff(pl, currentNumber);
-      if (++pl > nfg->NumPlayers()) {
-        iter++;
-        pl = 1;
-      }
-    }
+    dynamic_cast<GameTableRep &>(*nfg).SetPayoffs(pay_off_data, data_length);
     
     shared_ptr<StrategyProfileRenderer<double> > renderer;
     renderer = new MixedStrategyNullRenderer<double>();
@@ -85,8 +75,11 @@ double* nfggnm_c(const int num_players, const double *pay_off_data, const int da
     }
     return equilibriums_buffer;
   }
-  catch (std::runtime_error &e) {
+  catch (std::exception &e) {
+    // Errors from the game or the solver must not cross the C interface
     std::cerr << "Error: " << e.what() << std::endl;
+    *number_of_equilibriums = 0;
+    *equilibriums_buffer_size = 0;
     return 0;
   }
 }
@@ -0,0 +1,16 @@
+//
+//  threads_c_api.cpp
+//
+//  Setting the number of threads used by the solvers
+//
+
+#include "gambit.h"
+#include "../include/gambit_c_api.h"
+
+int gambit_set_num_threads(const int num_threads) {
+  if (num_threads < 0) {
+    return -1;
+  }
+  Gambit::SetNumThreads(num_threads);
+  return 0;
+}
@@ -0,0 +1,141 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2022, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/number.cc
+// Implementation of class for storing numerical data in a game
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+#include "gambit.h"
+
+namespace Gambit {
+
+/// The largest integer below which all integers are exact as doubles
+static const double MaxExactInteger = 9007199254740992.0;   // 2^53
+
+Number::Number(const std::string &p_text)
+  : m_fromDouble(false), m_exact(0)
+{
+  // We call lexical_cast<Rational>() first because it throws a
+  // ValueException if the conversion of the text fails
+  Rational value = lexical_cast<Rational>(p_text);
+  m_double = (double) value;
+  m_exact = new Exact(p_text, value);
+}
+
+Number::Number(double p_value)
+  : m_double(p_value), m_fromDouble(true), m_exact(0)
+{
+  if (!std::isfinite(p_value)) {
+    throw ValueException();
+  }
+}
+
+Number::Number(long long p_value)
+  : m_double((double) p_value), m_fromDouble(true), m_exact(0)
+{
+  if (std::fabs(m_double) >= MaxExactInteger) {
+    // The double is not enough to recover the integer
+    m_fromDouble = false;
+    char text[32];
+    snprintf(text, sizeof(text), "%lld", p_value);
+    m_exact = new Exact(text, lexical_cast<Rational>(std::string(text)));
+  }
+}
+
+Number::Number(const Number &p_number)
+  : m_double(p_number.m_double), m_fromDouble(p_number.m_fromDouble),
+    m_exact(0)
+{
+  Exact *exact = p_number.m_exact.load(std::memory_order_acquire);
+  if (exact) {
+    m_exact = new Exact(*exact);
+  }
+}
+
+Number &Number::operator=(const Number &p_number)
+{
+  if (this != &p_number) {
+    Exact *exact = p_number.m_exact.load(std::memory_order_acquire);
+    delete m_exact.exchange((exact) ? new Exact(*exact) : 0);
+    m_double = p_number.m_double;
+    m_fromDouble = p_number.m_fromDouble;
+  }
+  return *this;
+}
+
+Number &Number::operator=(Number &&p_number)
+{
+  if (this != &p_number) {
+    delete m_exact.exchange(p_number.m_exact.exchange(0));
+    m_double = p_number.m_double;
+    m_fromDouble = p_number.m_fromDouble;
+  }
+  return *this;
+}
+
+Number &Number::operator=(const std::string &p_text)
+{
+  // As in the constructor, the text is converted before anything changes
+  Rational value = lexical_cast<Rational>(p_text);
+  delete m_exact.exchange(new Exact(p_text, value));
+  m_double = (double) value;
+  m_fromDouble = false;
+  return *this;
+}
+
+///
+/// Computes the text and rational value of a number given as a double.
+/// If another thread has stored them in the meantime, the ones computed
+/// here are discarded in favor of those.
+///
+const Number::Exact &Number::MakeExact(void) const
+{
+  char text[32];
+  if (m_double == std::floor(m_double) && std::fabs(m_double) < MaxExactInteger) {
+    snprintf(text, sizeof(text), "%.0f", m_double);
+  }
+  else {
+    for (int prec = 15; prec <= 17; prec++) {
+      snprintf(text, sizeof(text), "%.*g", prec, m_double);
+      if (strtod(text, 0) == m_double) {
+	break;
+      }
+    }
+  }
+  std::string value(text);
+  // lexical_cast<Rational>() does not accept a '+' in an exponent
+  std::string::size_type exponent = value.find("e+");
+  if (exponent != std::string::npos) {
+    value.erase(exponent + 1, 1);
+  }
+
+  Exact *exact = new Exact(value, lexical_cast<Rational>(value));
+  Exact *expected = 0;
+  if (!m_exact.compare_exchange_strong(expected, exact,
+				       std::memory_order_acq_rel)) {
+    delete exact;
+    return *expected;
+  }
+  return *exact;
+}
+
+}  // end namespace Gambit
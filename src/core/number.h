@@ -23,36 +23,76 @@
 #ifndef LIBGAMBIT_NUMBER_H
 #define LIBGAMBIT_NUMBER_H
 
+#include <atomic>
+
 namespace Gambit {
 
 /// This simple class stores a numerical datum.
+///
+/// A number given as text keeps the text, its exact value as a
+/// rational, and the double nearest it.  A number given as a double
+/// or an integer keeps only the double; its text and rational value
+/// are computed from the double when first asked for, which for the
+/// payoffs seen by most solvers is never.  This may happen on several
+/// threads at once; the first result to be stored is kept.
 class Number {
 private:
-  std::string m_text;
-  Rational m_rational;
+  /// The text and exact value of a number
+  struct Exact {
+    std::string m_text;
+    Rational m_rational;
+
+    Exact(const std::string &p_text, const Rational &p_rational)
+      : m_text(p_text), m_rational(p_rational) { }
+  };
+
   double m_double;
+  /// True if the exact value is that computed from the double
+  bool m_fromDouble;
+  mutable std::atomic<Exact *> m_exact;
 
-public:
-  Number(void)
-    : m_text("0"), m_rational(0), m_double(0.0) { }
-  Number(const std::string &p_text)
-    : m_text(p_text), m_rational(lexical_cast<Rational>(p_text)), 
-      m_double((double) m_rational)
-  { }
-  
-  Number &operator=(const std::string &p_text)
+  const Exact &GetExact(void) const
   {
-    // We call lexical_cast<Rational>() first because it throws a ValueException
-    // if the conversion of the text fails
-    m_rational = lexical_cast<Rational>(p_text);
-    m_text = p_text;
-    m_double = (double) m_rational;
-    return *this; 
+    Exact *exact = m_exact.load(std::memory_order_acquire);
+    return (exact) ? *exact : MakeExact();
   }
+  const Exact &MakeExact(void) const;
+
+public:
+  Number(void) : m_double(0.0), m_fromDouble(true), m_exact(0) { }
+  Number(const std::string &p_text);
+  /// Construct from a double, which must be finite.  Its text is the
+  /// shortest which reads back as the same double, and its rational
+  /// value that of the text.
+  explicit Number(double p_value);
+  /// Construct from an integer
+  explicit Number(long long p_value);
+  /// Construct from text whose value has already been computed, as
+  /// an exact rational and as the double nearest it
+  Number(const std::string &p_text, const Rational &p_rational,
+	 double p_double)
+    : m_double(p_double), m_fromDouble(false),
+      m_exact(new Exact(p_text, p_rational))
+  { }
+  Number(const Number &p_number);
+  Number(Number &&p_number)
+    : m_double(p_number.m_double), m_fromDouble(p_number.m_fromDouble),
+      m_exact(p_number.m_exact.exchange(0))
+  { }
+  ~Number() { delete m_exact.load(std::memory_order_relaxed); }
+
+  Number &operator=(const Number &p_number);
+  Number &operator=(Number &&p_number);
+  Number &operator=(const std::string &p_text);
+
+  /// Returns true if the exact value of the number is computed from
+  /// its double.  Two such numbers are equal, or ordered, exactly when
+  /// their doubles are, so they can be compared without their rationals.
+  bool IsFromDouble(void) const { return m_fromDouble; }
 
   operator const double &(void) const { return m_double; }
-  operator const Rational &(void) const { return m_rational; }
-  operator const std::string &(void) const { return m_text; }
+  operator const Rational &(void) const { return GetExact().m_rational; }
+  operator const std::string &(void) const { return GetExact().m_text; }
 };
 
 }
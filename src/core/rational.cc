@@ -33,6 +33,7 @@ Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
 #include <cmath>
 #include <cfloat>
 #include <cctype>
+#include <limits>
 
 namespace Gambit {
 
@@ -537,9 +538,58 @@ Rational Rational::operator/(const Rational &y) const
 }
 
 
+//
+// Reads numbers of the form -ddd.ddd with few enough digits that the
+// numerator and denominator fit in an int, which covers most numbers
+// in game files, without Integer arithmetic.  Returns false if the
+// text is not of that form.
+//
+static bool ReadShortDecimal(const std::string &f, Rational &r)
+{
+  const char *c = f.c_str(), *end = c + f.length();
+  bool negative = (*c == '-');
+  if (negative) {
+    c++;
+  }
+
+  int num = 0, denom = 1, digits = 0;
+  bool point = false;
+  for (; c != end; c++) {
+    if (*c >= '0' && *c <= '9') {
+      if (++digits > std::numeric_limits<int>::digits10) {
+	return false;
+      }
+      num = 10 * num + (*c - '0');
+      if (point) {
+	denom *= 10;
+      }
+    }
+    else if (*c == '.' && !point) {
+      point = true;
+    }
+    else {
+      return false;
+    }
+  }
+  if (digits == 0) {
+    return false;
+  }
+
+  if (negative) {
+    num = -num;
+  }
+  r = (denom == 1) ? Rational(num) : Rational(num, denom);
+  return true;
+}
+
 template<>
 Rational lexical_cast(const std::string &f)
 {
+  Rational r;
+  if (ReadShortDecimal(f, r)) {
+    return r;
+  }
+
   char ch = ' ';
   int sign = 1;
   unsigned int index = 0, length = f.length();
@@ -0,0 +1,68 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2022, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/core/threads.cc
+// The number of threads solvers may use
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <atomic>
+#include <thread>
+
+#include "gambit.h"
+#include "threads.h"
+
+namespace Gambit {
+
+namespace {
+
+std::atomic<int> numThreads(1);
+thread_local bool workerThread = false;
+
+}  // end anonymous namespace
+
+void SetNumThreads(int p_numThreads)
+{
+  if (p_numThreads < 0) {
+    throw ValueException();
+  }
+  numThreads = p_numThreads;
+}
+
+int GetNumThreads(void)
+{
+  if (workerThread) {
+    return 1;
+  }
+  int threads = numThreads;
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+  return (threads > 0) ? threads : 1;
+}
+
+bool IsWorkerThread(void)
+{
+  return workerThread;
+}
+
+void SetWorkerThread(void)
+{
+  workerThread = true;
+}
+
+}  // end namespace Gambit
@@ -0,0 +1,50 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2022, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/core/threads.h
+// The number of threads solvers may use
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LIBGAMBIT_THREADS_H
+#define LIBGAMBIT_THREADS_H
+
+namespace Gambit {
+
+/// @name Threads used by the library
+//@{
+/// Sets the number of threads on which the library may do its work.
+/// One, the default, keeps all work on the calling thread; zero asks
+/// for one thread per hardware thread.  Throws ValueException if the
+/// number is negative.
+void SetNumThreads(int p_numThreads);
+/// Returns the number of threads a computation started on the calling
+/// thread may use.  This is always one on a worker thread of the
+/// library, so that parallel layers called from one another do not
+/// multiply their threads.
+int GetNumThreads(void);
+/// Returns whether the calling thread is a worker thread of the library
+bool IsWorkerThread(void);
+/// Marks the calling thread as a worker thread of the library.  A
+/// thread the library starts calls this before doing any work which
+/// may itself start threads.
+void SetWorkerThread(void);
+//@}
+
+}  // end namespace Gambit
+
+#endif  // LIBGAMBIT_THREADS_H
@@ -122,6 +122,7 @@ public:
 #include "core/recarray.h"
 #include "core/vector.h"
 #include "core/matrix.h"
+#include "core/threads.h"
 
 #include "core/rational.h"
 
@@ -136,5 +137,6 @@ public:
 #include "games/stratspt.h"
 #include "games/mixed.h"
 #include "games/stratitr.h"
+#include "games/redstrat.h"
 
 #endif // LIBGAMBIT_H
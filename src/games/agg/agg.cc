@@ -27,8 +27,10 @@
 #include <sstream>
 #include <cassert>
 #include <algorithm>
+#include "gambit.h"
 #include "games/agg/gray.h"
 #include "games/agg/agg.h"
+#include "games/agg/tokenizer.h"
 
 using namespace std;
 
@@ -45,7 +47,6 @@ AGG::AGG(int numPlayers, std::vector<int> &_actions, int numANodes, int _numPNod
  vector<vector<vector<config> > >& proj,
  vector<vector<proj_func*> > & projF,
  vector<vector<vector<int> > >& Po,
- vector<aggdistrib> &P,
  vector<aggpayoff>& _payoffs) :
 numPlayers(numPlayers),
 numActionNodes(numANodes),
@@ -55,14 +56,11 @@ neighbors(neighb),
 projectionTypes(projTypes),
 payoffs(_payoffs),
 projection(proj),
-projectedStrat(projS),
 fullProjectedStrat(projS),
 projFunctions(projF),
 Porder(Po),
-Pr(P),
 isPure(numANodes,true),
 node2Action(numANodes,vector<int>(numPlayers)),
-cache(numPlayers+1),
 player2Class(numPlayers),
 kSymStrategyOffset(1,0)
 {
@@ -133,8 +131,83 @@ kSymStrategyOffset(1,0)
     for(int j=0;j<actions[i];j++)
 	node2Action[actionSets[i][j]][i]=j;
 
+  //set up dense storage for small action nodes
+  isDense.assign(numANodes,false);
+  denseSize.assign(numANodes,0);
+  denseOffsets.resize(numANodes);
+  denseSlot.resize(numANodes);
+  densePayoffs.resize(numANodes);
+  for (int i=0;i<numANodes;i++) setDense(i);
+
+  //set maxPayoff and minPayoff
+  bool first=true;
+  maxPayoff=minPayoff=0;
+  for (int i=0;i<numANodes;i++)
+    for (aggpayoff::const_iterator it=payoffs[i].begin();it!=payoffs[i].end();++it){
+      if (first || it->second>maxPayoff) maxPayoff=it->second;
+      if (first || it->second<minPayoff) minPayoff=it->second;
+      first=false;
+    }
 }
 
+void AGG::setDense(int Node)
+{
+  int numNei=neighbors[Node].size();
+  //bound on each coordinate of a configuration
+  vector<int> bound(numNei,0);
+  for (int j=0;j<numNei;j++){
+    if (projFunctions[Node][j]->Type!=P_SUM) return;
+    for (int i=0;i<numPlayers;i++){
+      int m=0;
+      for (int a=0;a<actions[i];a++){
+	if (projection[Node][i][a][j]<0) return;
+	m=max(m,projection[Node][i][a][j]);
+      }
+      bound[j]+=m;
+    }
+  }
+  vector<int> stride(numNei);
+  double size=1;
+  for (int j=0;j<numNei;j++){
+    stride[j]=(int)size;
+    size*=bound[j]+1;
+    if (size>MAX_DENSE_SIZE) return;
+  }
+
+  AggNumberVector pays((size_t)size,(AggNumber)0);
+  for (aggpayoff::const_iterator p=payoffs[Node].begin();p!=payoffs[Node].end();++p){
+    if ((int)p->first.size()!=numNei) return;
+    int offset=0;
+    for (int j=0;j<numNei;j++){
+      if (p->first[j]<0 || p->first[j]>bound[j]) return;
+      offset+=p->first[j]*stride[j];
+    }
+    pays[offset]=p->second;
+  }
+
+  denseOffsets[Node].resize(numPlayers);
+  denseSlot[Node].resize(numPlayers);
+  for (int i=0;i<numPlayers;i++){
+    vector<int> &offsets=denseOffsets[Node][i];
+    for (int a=0;a<actions[i];a++){
+      int offset=0;
+      for (int j=0;j<numNei;j++) offset+=projection[Node][i][a][j]*stride[j];
+      vector<int>::iterator f=find(offsets.begin(),offsets.end(),offset);
+      denseSlot[Node][i].push_back(f-offsets.begin());
+      if (f==offsets.end()) offsets.push_back(offset);
+    }
+  }
+  densePayoffs[Node].swap(pays);
+  denseSize[Node]=(int)size;
+  isDense[Node]=true;
+}
+
+AGG::EvalContext::EvalContext(const AGG &g)
+  : projectedStrat(g.numActionNodes, vector<aggdistrib>(g.numPlayers)),
+    Pr(g.numPlayers),
+    cache(g.numPlayers+1)
+{ }
+
 /*
 AGG::AGG(const agg& other, bool completeGraph)
 :
@@ -213,190 +286,153 @@ b    numActionNodes=other.numActionNodes;
 }
 */
 
-void AGG::stripComment(istream& in){
-  in>>ws;
-  char c =in.peek();
-  stringbuf discard(ios_base::out);
-  if(c== AGG::COMMENT_CHAR){
-    in.get (discard);
-#ifdef AGGDEBUG
-    cerr<<discard.str()<<endl;
-#endif
-    stripComment(in);
-  }
-}
-
-
 AGG *AGG::makeAGG(char* filename){
   ifstream in(filename);
   return AGG::makeAGG(in);
 }
 AGG *AGG::makeAGG(istream &in){
-  int i,j,n,S,P;
-  int neighb_size;
-  
-  if(in.good() && !in.eof()) {
-    stripComment(in);
-    in>>n;
-    if(!in.good()) {
-      cout<<"Error reading the number of players"<<endl;
-      return 0;
-    }
-    stripComment(in);
-    in>>S;
-    if(!in.good()) {
-      cout<<"Error reading the number of action nodes"<<endl;
-      return 0;
-    }
-    stripComment(in);
-    in>>P;
-    if(!in.good()) {
-      cout<<"Error reading the number of function nodes"<<endl;
-      return 0;
-    }
-    stripComment(in);
+  int i,j;
 
-    //enter sizes of action sets:
-    std::vector<int> size(n);
-    for (i=0;i<n;i++){
-      in >> size[i];
-      if(in.eof()||in.fail()) {
-              cout << "Error in game file while trying to read the size of action set of player "<<i<<".\n";
-              return 0;
-      }
-      //sumActionSets+=size[i];
+  if(!in.good()) {
+    throw InvalidFileException("Bad game file");
+  }
+  Tokenizer tok(in, AGG::COMMENT_CHAR);
+  int n=tok.getInt("the number of players");
+  int S=tok.getInt("the number of action nodes");
+  int P=tok.getInt("the number of function nodes");
+  if (n<1 || S<0 || P<0) {
+    tok.error("Error in game file: bad numbers of players or nodes");
+  }
+
+  //enter sizes of action sets:
+  std::vector<int> size(n);
+  for (i=0;i<n;i++){
+    ostringstream what;
+    what<<"the size of action set of player "<<i;
+    size[i]=tok.getInt(what.str());
+    if (size[i]<1) {
+      tok.error("Error in game file: "+what.str()+" is not positive");
     }
+  }
 
-    stripComment(in);
-    vector<vector<int> > ASets(n); //action sets
-    for (i=0;i<n;i++){
-      stripComment(in);
-      for (j=0;j<size[i];j++){
-	int aindex;
-	in>>aindex;
-	if(in.eof()||in.fail()) {
-	        cout<< "Error in game file while trying to read the node index of action "<<j<< " of player "
-	            <<i<<".\n";
-	        return 0;
-	}
-	ASets[i].push_back(aindex);
+  vector<vector<int> > ASets(n); //action sets
+  for (i=0;i<n;i++){
+    ASets[i].reserve(size[i]);
+    for (j=0;j<size[i];j++){
+      ostringstream what;
+      what<<"the node index of action "<<j<<" of player "<<i;
+      int aindex=tok.getInt(what.str());
+      if (aindex<0 || aindex>=S) {
+        tok.error("Error in game file: "+what.str()+" is out of range");
       }
+      ASets[i].push_back(aindex);
     }
+  }
+  return makeAGG(tok,n,S,P,ASets);
+}
+
+AGG *AGG::makeAGG(Tokenizer &tok, int n, int S, int P, vector<vector<int> > &ASets){
+  int i,j;
+  int neighb_size;
 
-    stripComment(in);
-    vector<vector<int> > neighb(S+P); //neighbor lists
-    for(i=0;i<S+P;i++){
+  std::vector<int> size(n);
+  for (i=0;i<n;i++){
+    size[i]=ASets[i].size();
+  }
 
-      stripComment(in);
-      in>>neighb_size;
-      if(in.eof()||in.fail()) {
-        cout << "Error in game file while trying to read the size of the neighbor list of node "<<i<<".\n";
-        return 0;
-      }
-      for(j=0;j<neighb_size;j++){
-	int nindex;
-	in>>nindex;
-	if(!in.good()){
-	  cout<<"Error while reading neighor #"<<j<<" of node "<<i<<".\n";
-	  return 0;
-	}
-	neighb[i].push_back(nindex);
+  vector<vector<int> > neighb(S+P); //neighbor lists
+  for(i=0;i<S+P;i++){
+    ostringstream what;
+    what<<"the size of the neighbor list of node "<<i;
+    neighb_size=tok.getInt(what.str());
+    if (neighb_size<0) {
+      tok.error("Error in game file: "+what.str()+" is negative");
+    }
+    neighb[i].reserve(neighb_size);
+    for(j=0;j<neighb_size;j++){
+      ostringstream what;
+      what<<"neighbor #"<<j<<" of node "<<i;
+      int nindex=tok.getInt(what.str());
+      if (nindex<0 || nindex>=S+P) {
+        tok.error("Error in game file: "+what.str()+" is out of range");
       }
+      neighb[i].push_back(nindex);
     }
+  }
 
-    stripComment(in);
-    //enter the projection types:
-    vector<projtype> projTypes(P);
-    for (i=0;i<P;++i) {
-	int pt;
-	stripComment(in);
-	in >> pt;
-        if (in.eof()||in.fail()){
-          cout<<"Error in game file: expected integer for type of function node #"<<i<<endl;
-          return 0;
-        }
-	projTypes[i] = make_proj_func((TypeEnum)pt,in,S,P);
-    }
+  //enter the projection types:
+  vector<projtype> projTypes(P);
+  for (i=0;i<P;++i) {
+    ostringstream what;
+    what<<"the type of function node #"<<i;
+    int pt=tok.getInt(what.str());
+    //the parameters of the type are read from the stream itself
+    tok.skip();
+    projTypes[i] = make_proj_func((TypeEnum)pt,tok.stream(),S,P);
+  }
 
-    vector<vector<aggdistrib > > projS;
-    vector<vector<vector<config> > > proj;
-    setProjections(projS,proj,n,S,P, ASets, neighb,projTypes);
+  vector<vector<aggdistrib > > projS;
+  vector<vector<vector<config> > > proj;
+  setProjections(projS,proj,n,S,P, ASets, neighb,projTypes);
 
-    vector<vector<proj_func*> > projF(S);
-    for (i=0;i<S;i++){
+  vector<vector<proj_func*> > projF(S);
+  for (i=0;i<S;i++){
 	neighb_size=neighb[i].size();
 	for(j=0;j<neighb_size; j++){
 	  projtype t=(neighb[i][j]<S)?(new proj_func_SUM):projTypes[neighb[i][j]-S];
 	  projF[i].push_back(t );
 	}
-    }
+  }
 
-    vector<vector<vector<int> > > Po(n);
-    vector<aggdistrib>  Pr(n);
-    vector<aggpayoff> pays(S); //payoffs
+  vector<vector<vector<int> > > Po(n);
+  vector<aggdistrib>  Pr(n);
+  vector<aggpayoff> pays(S); //payoffs
 
 
-    set<vector<int> > doneASets;
-    for (i=0;i<n;i++){
-      for(j=0;j<size[i] ; j++){
+  set<vector<int> > doneASets;
+  for (i=0;i<n;i++){
+    for(j=0;j<size[i] ; j++){
 	Po[i].push_back(vector<int>(n) );
 	initPorder (Po[i][j], i,n,projS[ASets[i][j]]);
-      }
-      vector<int> as = ASets[i];
-      sort(as.begin(),as.end());
-      if (doneASets.count(as)==0){
-        for(j=0;j<size[i];j++){
-          // apply i's strategy j
-          Pr[0].reset();
-          Pr[0].insert (make_pair(proj[ASets[i][j]][i][j], 1));
-
-          // apply the rest of players strats
-          for (int k=1; k<n;k++){
-            Pr[k].multiply (Pr[k-1], projS[ASets[i][j]][Po[i][j][k]],proj[ASets[i][j]][i][j].size()  ,projF[ASets[i][j]] );
-          }
-	  pays[ASets[i][j]].insert(Pr[n-1].begin(), Pr[n-1].end());
+    }
+    vector<int> as = ASets[i];
+    sort(as.begin(),as.end());
+    if (doneASets.count(as)==0){
+      for(j=0;j<size[i];j++){
+        // apply i's strategy j
+        Pr[0].reset();
+        Pr[0].insert (make_pair(proj[ASets[i][j]][i][j], 1));
+
+        // apply the rest of players strats
+        for (int k=1; k<n;k++){
+          Pr[k].multiply (Pr[k-1], projS[ASets[i][j]][Po[i][j][k]],proj[ASets[i][j]][i][j].size()  ,projF[ASets[i][j]] );
         }
-        doneASets.insert(as);
+	  pays[ASets[i][j]].insert(Pr[n-1].begin(), Pr[n-1].end());
       }
+      doneASets.insert(as);
     }
+  }
 
-    stripComment(in);
-    //read in payoffs
-    for(i=0;i<S;i++){
-      if(in.eof()||in.bad()) {
-	cout << "Error in game file: not enough payoffs.\n";
-	return 0;
-      }
-      stripComment(in);
-      int t;
-      in>>t;
-      if(!in.good()){
-        cout<< "Error reading the integer type of the utility function for action node "<<i<<endl;
-        return 0;
-      }
-      switch (t){
-        case COMPLETE:
-	    AGG::makeCOMPLETEpayoff(in,pays[i]);
-	    break;
-	case MAPPING:
-	    AGG::makeMAPPINGpayoff(in,pays[i],neighb[i].size());
-	    break;
-	case ADDITIVE:
-        default:
-	    cerr<<"Unknown payoff type "<<t 
-			<<endl;
-	    exit(1);
-      }
-      
+  //read in payoffs
+  for(i=0;i<S;i++){
+    ostringstream what;
+    what<<"the integer type of the utility function for action node "<<i;
+    int t=tok.getInt(what.str());
+    switch (t){
+      case COMPLETE:
+        AGG::makeCOMPLETEpayoff(tok,pays[i]);
+        break;
+      case MAPPING:
+        AGG::makeMAPPINGpayoff(tok,pays[i],neighb[i].size());
+        break;
+      case ADDITIVE:
+      default:
+        ostringstream msg;
+        msg<<"Unknown payoff type "<<t<<" for action node "<<i;
+        tok.error(msg.str());
     }
-    AGG *r=NULL;
-    r=new AGG(n,size,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,Pr,pays);
-    if (!r)cout<<"Failed to allocate memory for new AGG";
-    return r;
-  } else {
-    cout << "Bad game file.\n";
-    exit(1);
   }
+  return new AGG(n,size,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,pays);
 }
 
 
@@ -460,7 +496,7 @@ vector<projtype>& projTypes, int seed, bool int_payoffs, int int_factor){
 	    numPayoffs += pays[i].size();
     }
     cout << "Creating an AGG with "<<numPayoffs <<" payoff values"<<endl;
-    AGG *r= new AGG(n,actions,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,Pr,pays);
+    AGG *r= new AGG(n,actions,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,pays);
     
     return r;
  
@@ -534,11 +570,10 @@ AGG::getAn(multiset<int>& dest, vector<vector<int> >& neighb, vector<projtype>&
   //cycle check
   for (vector<int>::iterator p=path.begin();p!=path.end();++p){
     if (Node == (*p)) {
-	cout<<"ERROR: cycle of projected nodes at "<<Node  <<endl;
-	cout <<"Path: (Size "<<path.size() <<")"<<endl;
-	copy(path.begin(),path.end(),ostream_iterator<int>(cout, " "));
-	cout<<endl;
-	exit(1);
+      ostringstream msg;
+      msg<<"ERROR: cycle of projected nodes at "<<Node<<"; path: ";
+      copy(path.begin(),path.end(),ostream_iterator<int>(msg, " "));
+      throw InvalidFileException(msg.str());
     }
   }
 
@@ -547,9 +582,10 @@ AGG::getAn(multiset<int>& dest, vector<vector<int> >& neighb, vector<projtype>&
   for (int i=0; i<numNei;++i){
     //check consistency of proj. signatures
     if(neighb[Node][i]>=S && *(projTypes[neighb[Node][i]-S])!= *(projTypes[Node-S])){
-	cout<<"ERROR: projection type mismatch: Node "<< Node 
-	   <<" and its neighbor "<<neighb[Node][i]<<endl;
-	exit(1);
+      ostringstream msg;
+      msg<<"ERROR: projection type mismatch: Node "<<Node
+         <<" and its neighbor "<<neighb[Node][i];
+      throw InvalidFileException(msg.str());
     }
     getAn(dest, neighb,projTypes, S, neighb[Node][i],path);
   }
@@ -582,8 +618,9 @@ AGG::initPorder(vector<int>& Po,
 
 //compute the induced distribution 
 void
-AGG::computeP(int player, int act, int player2,int act2)
+AGG::computeP(EvalContext &ctx, int player, int act, int player2,int act2) const
 {
+  vector<aggdistrib> &Pr = ctx.Pr;
   //apply player's strat
   Pr[0].reset();
   Pr[0].insert(make_pair(projection[actionSets[player][act]][player][act], 1.0) );
@@ -604,29 +641,62 @@ AGG::computeP(int player, int act, int player2,int act2)
       }
     } else {
       Pr[k].multiply (Pr[k-1], 
-	projectedStrat[actionSets[player][act]][Porder[player][act][k]],
+	ctx.projectedStrat[actionSets[player][act]][Porder[player][act][k]],
 	numNei  ,projFunctions[actionSets[player][act]] ); 
     }
   }
     
 }
 
-void AGG:: doProjection(int Node, AggNumber* s)
+//compute the induced distribution for an action node stored densely.
+//Each player's projected strat is a distribution over the offsets
+//of her contributions, so the product is a sequence of shifted sums.
+void
+AGG::computeDenseP(EvalContext &ctx, const StrategyProfile &s, int player, int act, int player2,int act2) const
+{
+  int Node=actionSets[player][act];
+  dense_map<AggNumber> &P=ctx.denseP;
+  P.reset(denseSize[Node], denseOffsets[Node][player][denseSlot[Node][player][act]]);
+
+  for (int i=0;i<numPlayers;i++)if(i!=player){
+    const vector<int> &offsets=denseOffsets[Node][i];
+    const vector<int> &slot=denseSlot[Node][i];
+    if (i==player2){
+      //apply player2's pure strat, if any
+      if (act2!=-1) P.multiply(offsets[slot[act2]], (AggNumber)1.0);
+      continue;
+    }
+    const AggNumber *si=&s[firstAction(i)];
+    if (offsets.size()==1){
+      AggNumber p=0;
+      for (int j=0;j<actions[i];j++)if(si[j]>(AggNumber)0.0) p+=si[j];
+      if (offsets[0]!=0 || p!=(AggNumber)1.0) P.multiply(offsets[0], p);
+      continue;
+    }
+    ctx.denseProb.assign(offsets.size(),(AggNumber)0);
+    for (int j=0;j<actions[i];j++)if(si[j]>(AggNumber)0.0){
+      ctx.denseProb[slot[j]]+=si[j];
+    }
+    P.multiply(offsets, ctx.denseProb);
+  }
+}
+
+void AGG:: doProjection(EvalContext &ctx, int Node, AggNumber* s) const
 {
   for (int i=0;i<numPlayers;i++){
-    doProjection(Node,i, &(s[firstAction(i)]));
+    doProjection(ctx, Node,i, &(s[firstAction(i)]));
   }
 }
 
-void AGG:: doProjection(int Node, int i, AggNumber* s)
+void AGG:: doProjection(EvalContext &ctx, int Node, int i, AggNumber* s) const
 {
-  projectedStrat[Node][i].reset();
+  ctx.projectedStrat[Node][i].reset();
   for (int j=0;j<actions[i];j++)if(s[j]>(AggNumber)0.0){
-    projectedStrat[Node][i]+= make_pair(projection[Node][i][j],
+    ctx.projectedStrat[Node][i]+= make_pair(projection[Node][i][j],
               s[j]);
   }
 }
-AggNumber AGG::getPurePayoff(int player, std::vector<int> &s){
+AggNumber AGG::getPurePayoff(int player, std::vector<int> &s) const {
   assert(player>=0 && player < numPlayers);
   int Node = actionSets[player][s[player]]; 
   int keylen = neighbors[Node].size();
@@ -639,45 +709,174 @@ AggNumber AGG::getPurePayoff(int player, std::vector<int> &s){
   }
   aggpayoff::iterator p= payoffs[Node].find(pureprofile);
   if ( p == payoffs[Node].end() ){
-    cout<<"AGG::getPurePayoff ERROR: unable to find the following configuration"
-        <<endl;
-    cout <<"[";
-    copy(pureprofile.begin(),pureprofile.end(),ostream_iterator<int>(cout, " "));
-    cout<<"]" <<endl;
-    cout<< "\tin payoffs of action node #"<<Node<<endl;
-    exit(1);
+    ostringstream msg;
+    msg<<"AGG::getPurePayoff ERROR: unable to find the configuration [";
+    copy(pureprofile.begin(),pureprofile.end(),ostream_iterator<int>(msg, " "));
+    msg<<"] in payoffs of action node #"<<Node;
+    throw IndexException(msg.str());
   }
   return p->second;
 }
 
-AggNumber AGG::getMixedPayoff(int player, StrategyProfile &s){
+AggNumber AGG::getMixedPayoff(EvalContext &ctx, int player, StrategyProfile &s) const {
   AggNumber result=0.0;
   assert(player>=0 && player < numPlayers);
   for (int act=0;act <actions[player];++act)if (s[act+firstAction(player)]>(AggNumber)0.0){
-	result+= s[act+firstAction(player)]* getV(player, act, s);
+	result+= s[act+firstAction(player)]* getV(ctx, player, act, s);
   }
   return result;
 }
 
-void AGG::getPayoffVector(AggNumberVector &dest, int player,const StrategyProfile &s){
+void AGG::getPayoffVector(EvalContext &ctx, AggNumberVector &dest, int player,const StrategyProfile &s) const {
     assert(player>=0 && player < numPlayers);
     for (int act=0;act<actions[player]; ++act){
-	dest[act]=getV(player,act,s);
+	dest[act]=getV(ctx,player,act,s);
     }
 }
 
-AggNumber AGG::getV(int player, int act,const StrategyProfile &s){
+AggNumber AGG::getV(EvalContext &ctx, int player, int act,const StrategyProfile &s) const {
+    int Node=actionSets.at(player).at(act);
+    if (isDense[Node]){
+      computeDenseP(ctx, s, player, act);
+      return ctx.denseP.inner_prod(densePayoffs[Node]);
+    }
     //project s to the projectedStrat
-    doProjection(actionSets.at(player).at(act), s);
-    computeP(player, act);
-    return Pr[numPlayers-1].inner_prod(payoffs[actionSets[player][act]]);
+    doProjection(ctx, actionSets.at(player).at(act), s);
+    computeP(ctx, player, act);
+    return ctx.Pr[numPlayers-1].inner_prod(payoffs[actionSets[player][act]]);
+}
+
+AggNumber AGG::getJ(EvalContext &ctx, int player1, int act1, int player2,int act2,StrategyProfile &s) const
+{
+    int Node=actionSets[player1][act1];
+    if (isDense[Node]){
+      computeDenseP(ctx, s, player1, act1, player2, act2);
+      return ctx.denseP.inner_prod(densePayoffs[Node]);
+    }
+    doProjection(ctx, actionSets[player1][act1],s);
+    computeP(ctx, player1,act1,player2,act2);
+    return ctx.Pr[numPlayers-1].inner_prod(payoffs[actionSets[player1][act1]]);
+}
+
+void AGG::getPayoffVectors(EvalContext &ctx, AggNumberVector &dest, const StrategyProfile &s) const
+{
+  for (int Node=0;Node<numActionNodes;++Node){
+    int count=0;
+    for (int i=0;i<numPlayers;i++) if (node2Action[Node][i]!=-1) count++;
+    //the plan pays off once it is shared by more than two players
+    bool plan = count>2 && (!isDense[Node] || isDensePlan(Node));
+    if (plan) computePlan(ctx, Node, s);
+    for (int i=0;i<numPlayers;i++)if(node2Action[Node][i]!=-1){
+      int act=node2Action[Node][i];
+      dest[firstAction(i)+act] = plan ? getPlanV(ctx, Node, i, act) : getV(ctx, i, act, s);
+    }
+  }
+}
+
+//The plan of a node is built from the projected mixed strats X_0..X_{n-1}
+//of the players at the node.  The payoff of player i's action is its payoff
+//under the product of every X_k but X_i, which splits into the product
+//of X_0..X_{i-1} (a prefix) and that of X_{i+1}..X_{n-1} (a suffix);
+//computing all prefixes and suffixes once takes 2n products instead of
+//n products per action.
+//For a node stored densely, each suffix is folded into the payoffs
+//right away, so that a payoff is an inner product of a prefix with
+//the folded payoffs of the suffix after it.
+void AGG::computePlan(EvalContext &ctx, int Node, const StrategyProfile &s) const
+{
+  int n=numPlayers;
+  if (isDense[Node]){
+    int size=denseSize[Node];
+    ctx.denseProbs.resize(n);
+    ctx.denseForward.resize(n);
+    ctx.denseBackward.resize(n+1);
+    for (int i=0;i<n;i++){
+      const vector<int> &slot=denseSlot[Node][i];
+      vector<AggNumber> &probs=ctx.denseProbs[i];
+      probs.assign(denseOffsets[Node][i].size(),(AggNumber)0);
+      for (int j=0;j<actions[i];j++)if(s[firstAction(i)+j]>(AggNumber)0.0){
+	probs[slot[j]]+=s[firstAction(i)+j];
+      }
+    }
+    ctx.denseForward[0].reset(size, 0);
+    for (int k=1;k<n;k++){
+      ctx.denseForward[k].assign(ctx.denseForward[k-1]);
+      ctx.denseForward[k].multiply(denseOffsets[Node][k-1], ctx.denseProbs[k-1]);
+    }
+    ctx.denseBackward[n].assign(densePayoffs[Node], size);
+    for (int k=n-1;k>0;k--){
+      ctx.denseBackward[k].assign(ctx.denseBackward[k+1]);
+      ctx.denseBackward[k].correlate(denseOffsets[Node][k], ctx.denseProbs[k]);
+    }
+    return;
+  }
+
+  int numNei=neighbors[Node].size();
+  const vector<aggdistrib> &X=ctx.projectedStrat[Node];
+  doProjection(ctx, Node, s);
+  ctx.prefix.resize(n);
+  ctx.suffix.resize(n);
+  ctx.prefix[1]=X[0];
+  for (int k=2;k<n;k++){
+    ctx.prefix[k].multiply(ctx.prefix[k-1], X[k-1], numNei, projFunctions[Node]);
+  }
+  ctx.suffix[n-1]=X[n-1];
+  for (int k=n-2;k>0;k--){
+    ctx.suffix[k].multiply(ctx.suffix[k+1], X[k], numNei, projFunctions[Node]);
+  }
+}
+
+AggNumber AGG::getPlanV(EvalContext &ctx, int Node, int player, int act) const
+{
+  if (isDense[Node]){
+    int offset=denseOffsets[Node][player][denseSlot[Node][player][act]];
+    return ctx.denseForward[player].inner_prod(ctx.denseBackward[player+1], offset);
+  }
+  int numNei=neighbors[Node].size();
+  const aggdistrib *others;
+  if (player==0) {
+    others=&ctx.suffix[1];
+  }
+  else if (player==numPlayers-1) {
+    others=&ctx.prefix[numPlayers-1];
+  }
+  else {
+    ctx.Pr[0].multiply(ctx.prefix[player], ctx.suffix[player+1], numNei, projFunctions[Node]);
+    others=&ctx.Pr[0];
+  }
+  return others->inner_prod(projection[Node][player][act], numNei, projFunctions[Node], payoffs[Node]);
 }
 
-AggNumber AGG::getJ(int player1, int act1, int player2,int act2,StrategyProfile &s)
+//For player2 after player, the prefix before player is extended by
+//player's action and then by the strats up to player2, and taken against
+//the folded payoffs after player2; for player2 before player, the folded
+//payoffs after player are shifted by player's action and then folded
+//down to player2, and taken against the prefix before player2.
+//Either way, a row takes n products instead of n per entry.
+void AGG::getPlanJ(EvalContext &ctx, AggNumber *row, int Node, int player, int act) const
 {
-    doProjection(actionSets[player1][act1],s);
-    computeP(player1,act1,player2,act2);
-    return Pr[numPlayers-1].inner_prod(payoffs[actionSets[player1][act1]]);
+  const vector<vector<int> > &offsets=denseOffsets[Node];
+  dense_map<AggNumber> &P=ctx.denseP;
+  int own=offsets[player][denseSlot[Node][player][act]];
+
+  P.assign(ctx.denseForward[player]);
+  P.multiply(own, (AggNumber)1.0);
+  for (int j=player+1;j<numPlayers;j++){
+    for (int b=0;b<actions[j];b++){
+      row[firstAction(j)+b]=P.inner_prod(ctx.denseBackward[j+1], offsets[j][denseSlot[Node][j][b]]);
+    }
+    if (j<numPlayers-1) P.multiply(offsets[j], ctx.denseProbs[j]);
+  }
+
+  if (player==0) return;
+  P.assign(ctx.denseBackward[player+1]);
+  P.correlate(vector<int>(1,own), vector<AggNumber>(1,(AggNumber)1.0));
+  for (int j=player-1;j>=0;j--){
+    for (int b=0;b<actions[j];b++){
+      row[firstAction(j)+b]=ctx.denseForward[j].inner_prod(P, offsets[j][denseSlot[Node][j][b]]);
+    }
+    if (j>0) P.correlate(offsets[j], ctx.denseProbs[j]);
+  }
 }
 
 //getSymMixedPayoff: compute expected payoff under a symmetric mixed strat,
@@ -685,23 +884,21 @@ AggNumber AGG::getJ(int player1, int act1, int player2,int act2,StrategyProfile
 // parameter: s is the mixed strategy of one player. It is a vector of 
 // probabilities, indexed by the action node.
 
-AggNumber AGG::getSymMixedPayoff( StrategyProfile &s){
+AggNumber AGG::getSymMixedPayoff(EvalContext &ctx, StrategyProfile &s) const {
   AggNumber result=0;
   if (! isSymmetric() ) {
-    cerr<< "AGG::getSymMixedPayoff: the game is not symmetric!"<<endl;
-    exit(1);
+    throw UndefinedException("AGG::getSymMixedPayoff: the game is not symmetric!");
   }
 
 
   for (int node=0; node<numActionNodes; ++node)if(s[node]>(AggNumber)0.0){
-    result+= s[node]* getSymMixedPayoff(node,s);
+    result+= s[node]* getSymMixedPayoff(ctx,node,s);
   }
   return result;
 }
-void AGG::getSymPayoffVector(AggNumberVector& dest, StrategyProfile &s){
+void AGG::getSymPayoffVector(EvalContext &ctx, AggNumberVector& dest, StrategyProfile &s) const {
   if (! isSymmetric() ) {
-    cerr<< "AGG::getSymMixedPayoff: the game is not symmetric!"<<endl;
-    exit(1);
+    throw UndefinedException("AGG::getSymMixedPayoff: the game is not symmetric!");
   }
 
   //check the pureness
@@ -722,20 +919,20 @@ void AGG::getSymPayoffVector(AggNumberVector& dest, StrategyProfile &s){
   //  return;
   //}
   for (int act=0;act<numActionNodes; ++act){
-          dest[act]=getSymMixedPayoff(act,s);
+          dest[act]=getSymMixedPayoff(ctx,act,s);
   }
 }
-AggNumber AGG::getSymMixedPayoff(int node, StrategyProfile &s)
+AggNumber AGG::getSymMixedPayoff(EvalContext &ctx, int node, StrategyProfile &s) const
 {
     int numNei = neighbors[node].size();
 
     if(!isPure[node]){ // then compute EU using trie_map::power()
-      doProjection(node,0,s);
+      doProjection(ctx,node,0,s);
       assert(numPlayers>1);
       //aggdistrib *dest;
       //projectedStrat[node][0].power(numPlayers-1, dest, Pr, numNei,projFunctions[node]);
-      aggdistrib &dest = Pr[numPlayers-1];
-      projectedStrat[node][0].power(numPlayers-1, dest, Pr[numPlayers-2],numNei,projFunctions[node]);
+      aggdistrib &dest = ctx.Pr[numPlayers-1];
+      ctx.projectedStrat[node][0].power(numPlayers-1, dest, ctx.Pr[numPlayers-2],numNei,projFunctions[node]);
       return dest.inner_prod(projection[node][0][node], numNei, projFunctions[node], payoffs[node]);
     }
 
@@ -758,7 +955,7 @@ AggNumber AGG::getSymMixedPayoff(int node, StrategyProfile &s)
     //gray code
     GrayComposition gc (numPlayers-1, support.size() );
 
-    AggNumber prob = pow((support.at(0)>=0)?s[neighbors[node][support[0]]]:null_prob,
+    AggNumber prob = std::pow((support.at(0)>=0)?s[neighbors[node][support[0]]]:null_prob,
 		numPlayers-1);
 
     while (1){
@@ -790,7 +987,7 @@ AggNumber AGG::getSymMixedPayoff(int node, StrategyProfile &s)
 //plClass: the index for the player class
 //s: mixed strat for that player class
 
-void AGG::getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,int plClass2,int act2){
+void AGG::getSymConfigProb(EvalContext &ctx, int plClass, StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,int plClass2,int act2) const {
     int node = uniqueActionSets.at(ownPlClass).at(act);
     int numPl = playerClasses.at(plClass).size();
     assert(numPl>0);
@@ -805,12 +1002,12 @@ void AGG::getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int
 
     if(!isPure[node]){
       int player = playerClasses[plClass].at(0);
-      projectedStrat[node][player].reset();
+      ctx.projectedStrat[node][player].reset();
       if(numPl>0){
         for (int j=0;j<actions[player];j++)if(s[j]>(AggNumber)0.0){
-          projectedStrat[node][player]+= make_pair(projection[node][player][j], s[j]);
+          ctx.projectedStrat[node][player]+= make_pair(projection[node][player][j], s[j]);
         }
-        projectedStrat[node][player].power(numPl, dest,Pr[0],numNei, projFunctions[node]);
+        ctx.projectedStrat[node][player].power(numPl, dest,ctx.Pr[0],numNei, projFunctions[node]);
       }
       if(plClass==ownPlClass){
         aggdistrib temp;
@@ -864,7 +1061,7 @@ void AGG::getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int
     GrayComposition gc (numPl, support.size() );
 
     AggNumber prob0=(support.at(0)>=0)?s[node2Action[neighbors[node].at(support[0])][p]]:null_prob;
-    AggNumber prob = pow(prob0,numPl);
+    AggNumber prob = std::pow(prob0,numPl);
 
     while (1){
       const vector<int>& comp = gc.get();
@@ -895,50 +1092,50 @@ void AGG::getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int
   
 }
 
-AggNumber AGG::getKSymMixedPayoff( int playerClass,vector<StrategyProfile> &s){
+AggNumber AGG::getKSymMixedPayoff(EvalContext &ctx, int playerClass,vector<StrategyProfile> &s) const {
   AggNumber result=0.0;
 
   for(int act=0;act<(int)uniqueActionSets[playerClass].size();act++)if(s[playerClass][act]>(AggNumber)0.0){
 
-      result += s[playerClass][act] *getKSymMixedPayoff(playerClass, act,s);
+      result += s[playerClass][act] *getKSymMixedPayoff(ctx, playerClass, act,s);
   }
   return result;
 }
-AggNumber AGG::getKSymMixedPayoff( int playerClass,StrategyProfile &s){
+AggNumber AGG::getKSymMixedPayoff(EvalContext &ctx, int playerClass,StrategyProfile &s) const {
   AggNumber result=0.0;
 
   for(int act=0;act<(int)uniqueActionSets[playerClass].size();act++)if(s[firstKSymAction(playerClass)+act]>(AggNumber)0.0){
 
-      result += s[firstKSymAction(playerClass)+act] *getKSymMixedPayoff(s,playerClass, act);
+      result += s[firstKSymAction(playerClass)+act] *getKSymMixedPayoff(ctx,s,playerClass, act);
   }
   return result;
 }
-void AGG::getKSymPayoffVector(AggNumberVector& dest,int playerClass, StrategyProfile &s){
+void AGG::getKSymPayoffVector(EvalContext &ctx, AggNumberVector& dest,int playerClass, StrategyProfile &s) const {
   for (size_t act=0;act<uniqueActionSets[playerClass].size();++act){
-    dest[act]=getKSymMixedPayoff(s,playerClass,act);
+    dest[act]=getKSymMixedPayoff(ctx,s,playerClass,act);
   }
 }
-AggNumber AGG::getKSymMixedPayoff(int playerClass, int act, vector<StrategyProfile> &s){
+AggNumber AGG::getKSymMixedPayoff(EvalContext &ctx, int playerClass, int act, vector<StrategyProfile> &s) const {
       
       int numPC = playerClasses.size();
       
       int numNei = neighbors[uniqueActionSets[playerClass][act]].size();
 
-      static aggdistrib d,temp;
+      aggdistrib &d = ctx.d, &temp = ctx.temp;
       d.reset();
       temp.reset();
-      getSymConfigProb(0, s[0], playerClass, act, d);
+      getSymConfigProb(ctx, 0, s[0], playerClass, act, d);
       for(int pc=1;pc<numPC;pc++){
-	  getSymConfigProb(pc, s[pc], playerClass, act, temp);
+	  getSymConfigProb(ctx, pc, s[pc], playerClass, act, temp);
 	  d.multiply(temp, numNei, projFunctions[uniqueActionSets[playerClass][act]]);
       }
       return d.inner_prod(payoffs[uniqueActionSets[playerClass][act]]);
 }
 
-AggNumber AGG::getKSymMixedPayoff(const StrategyProfile &s,int pClass1,int act1,int pClass2,int act2){
+AggNumber AGG::getKSymMixedPayoff(EvalContext &ctx, const StrategyProfile &s,int pClass1,int act1,int pClass2,int act2) const {
   int numPC=playerClasses.size();
   int numNei=neighbors[uniqueActionSets[pClass1][act1]].size();
-  static aggdistrib d,temp;
+  aggdistrib &d = ctx.d, &temp = ctx.temp;
   if (pClass2>=0 && pClass1==pClass2 && playerClasses.at(pClass1).size()<=1){
     return 0;
   }
@@ -948,13 +1145,13 @@ AggNumber AGG::getKSymMixedPayoff(const StrategyProfile &s,int pClass1,int act1,
   //if (0==pClass2) s0[act2]=1;
   //else
   for (int a=firstKSymAction(0);a<lastKSymAction(0);++a)s0[a]=s[a];
-  getSymConfigProb(0,s0,pClass1,act1,d,pClass2,act2);
+  getSymConfigProb(ctx,0,s0,pClass1,act1,d,pClass2,act2);
   for (int pc=1;pc<numPC;pc++){
     StrategyProfile ss(getNumKSymActions(pc), 0.0);
     //if (pc==pClass2)ss[act2]=1;
     //else
     for (int a=0;a<getNumKSymActions(pc);++a)ss[a]=s[a+firstKSymAction(pc)];
-    getSymConfigProb(pc,ss,pClass1,act1,temp,pClass2,act2);
+    getSymConfigProb(ctx,pc,ss,pClass1,act1,temp,pClass2,act2);
     d.multiply(temp,numNei,projFunctions[uniqueActionSets[pClass1][act1]]);
   }
   return d.inner_prod(payoffs[uniqueActionSets[pClass1][act1]]);
@@ -962,134 +1159,83 @@ AggNumber AGG::getKSymMixedPayoff(const StrategyProfile &s,int pClass1,int act1,
 
 
 
-void AGG::makeMAPPINGpayoff(std::istream& in, aggpayoff& pay, int numNei){
-    int num;
-    char c;
-    AggNumber u;
-    aggpayoff temp;
-    //temp.swap(pay);
-    temp=pay;
-    pay.clear();
+namespace {
 
-    stripComment(in);
-    in>>num;
-    if(!in.good()){
-      cerr<<"Error reading the integer number of configuration-value pairs"<<endl;
-      exit(1);
-    }
-
-    while (num--){
-        in>>ws;
-        if(in.eof()||in.bad()){
-          cerr<<"ERROR: bad input"<<endl;
-          exit(1);
-        }
-
-	c = in.get();
-	assert(in.good());
-	if (c != AGG::LBRACKET){
-	    cerr<< "ERROR: "<<AGG::LBRACKET <<" expected. Instead, got "<<c <<endl;
-	    cerr<<"The rest of the line is: ";
-	    stringbuf discard(ios_base::out);
-	    in.get(discard);
-	    cerr<<discard.str()<<endl;
-	    exit(1);
-	}
-	vector<int> key;
-
-	for(int j=0;j<numNei; ++j){
-	    int cnt;
-	    in>>cnt;
-	    if(!in.good()){
-	      cerr<<"ERROR trying to read element #"<<j<<" of the configuraiton"<<endl;
-	      exit(1);
-	    }
-	    key.push_back(cnt);
-	}
-
-
-	in>>ws;
-	c=in.get(); //get right bracket
-	assert (in.good());
+//orders configuration-value pairs by configuration only, so that a
+//stable sort keeps pairs with the same configuration in file order
+struct keyLess {
+  bool operator() (const aggpayoff::value_type &x, const aggpayoff::value_type &y) const {
+    return x.first<y.first;
+  }
+};
 
-	if (c!=AGG::RBRACKET){
-	    cerr<< "ERROR: "<<AGG::RBRACKET <<" expected. Instead, got "<<c<<endl;
-	    cerr<< "current configuration: ";
-	    copy(key.begin(),key.end(), ostream_iterator<int>(cerr, " "));
-	    cerr<<endl;
-	    exit(1);
-	}
-	
-	in>>u;  //get payoff
-	if(!in.good()){
-	  cerr<<"Error trying to read the utility value for configuration ";
-	  copy(key.begin(),key.end(), ostream_iterator<int>(cerr, " "));
-	  cerr<<endl;
-	  exit(1);
-	}
+struct inputToken {
+  inputToken(Tokenizer &t): tok(t) {}
+  void operator() (aggpayoff::iterator p) {
+    p->second=tok.getNumber("a utility value");
+  }
+  Tokenizer &tok;
+};
 
+}  // end anonymous namespace
 
-	//insert
-	pair<trie_map<AggNumber>::iterator, bool> r = pay.insert(make_pair(key,u));
-	if (!r.second){
-	    cerr<<"WARNING: overwriting utility at [";
-	    copy(key.begin(),key.end(), ostream_iterator<int>(cerr, " "));
-	    cerr<<"]"<<endl;
-	    cerr<<"previous value: "<<r.first->second<<" new value: "<<u<<endl;
+void AGG::makeCOMPLETEpayoff(Tokenizer &tok, aggpayoff& pay){
+  pay.in_order(inputToken(tok));
+}
 
-	    r.first->second = u;
-	}
+void AGG::makeMAPPINGpayoff(Tokenizer &tok, aggpayoff& pay, int numNei){
+  int num=tok.getInt("the integer number of configuration-value pairs");
+  if (num<0) {
+    tok.error("Negative number of configuration-value pairs");
+  }
 
+  //the pairs are collected and sorted first, so that the trie is built
+  //in one pass over the sorted configurations
+  vector<aggpayoff::value_type> entries(num);
+  for (int k=0;k<num;++k){
+    vector<int> &key=entries[k].first;
+    key.resize(numNei);
+    tok.expect(AGG::LBRACKET, "at the start of a configuration");
+    for(int j=0;j<numNei; ++j){
+      key[j]=tok.getInt("an element of a configuration");
     }
-    //check
-    for(trie_map<AggNumber>::iterator it = temp.begin(); it!=temp.end(); ++it){
-
-	//pair<trie_map<AggNumber>::iterator,bool> res = pay.insert( *it);
-	
-	if (pay.count(it->first)==0){
-	    cerr<<"ERROR: utility at [";
-	    copy(it->first.begin(),it->first.end(), ostream_iterator<int>(cerr, " "));
-	    cerr<<"] not specified."<<endl;
-	    cerr<<"The set of configurations (requiring utility to be specified) are: "<<endl;
-	    cerr<<temp;
-	    cerr<<endl;
-	    cerr<<"The set of configurations to which utility has been specified are: "<<endl;
-	    cerr<<pay;
-	    cerr<<endl;
-	    exit(1);
-	}
+    tok.expect(AGG::RBRACKET, "at the end of a configuration");
+    entries[k].second=tok.getNumber("the utility value of a configuration");
+  }
+  stable_sort(entries.begin(),entries.end(),keyLess());
+
+  //the last of several values for a configuration is the one kept
+  size_t numUnique=0;
+  for (size_t k=0;k<entries.size();++k){
+    if (numUnique>0 && entries[numUnique-1].first==entries[k].first) {
+      cerr<<"WARNING: overwriting utility at [";
+      copy(entries[k].first.begin(),entries[k].first.end(), ostream_iterator<int>(cerr, " "));
+      cerr<<"]"<<endl;
+      cerr<<"previous value: "<<entries[numUnique-1].second<<" new value: "<<entries[k].second<<endl;
+      entries[numUnique-1].second=entries[k].second;
     }
+    else {
+      if (numUnique!=k) entries[numUnique].swap(entries[k]);
+      ++numUnique;
+    }
+  }
+  entries.resize(numUnique);
+
+  //check that every configuration which can occur has a value
+  for(trie_map<AggNumber>::iterator it = pay.begin(); it!=pay.end(); ++it){
+    if (!binary_search(entries.begin(),entries.end(),*it,keyLess())){
+      ostringstream msg;
+      msg<<"ERROR: utility at [";
+      copy(it->first.begin(),it->first.end(), ostream_iterator<int>(msg, " "));
+      msg<<"] not specified.";
+      tok.error(msg.str());
+    }
+  }
 
-
-}
-
-AggNumber AGG::getMaxPayoff(){
-  static bool done=false;
-  static AggNumber result=0;
-  if (done)return result;
-  assert(numActionNodes>0);
-  result=payoffs[0].begin()->second;
-  for (int i=1;i<numActionNodes;i++)
-    for (aggpayoff::iterator it=payoffs[i].begin();it!=payoffs[i].end();++it)
-      result=max(result, it->second);
-
-  done=true;
-  return result;
-}
-AggNumber AGG::getMinPayoff(){
-  static bool done=false;
-  static AggNumber result=0;
-  if (done)return result;
-  assert(numActionNodes>0);
-  result=payoffs[0].begin()->second;
-  for (int i=1;i<numActionNodes;i++)
-      for (aggpayoff::iterator it=payoffs[i].begin();it!=payoffs[i].end();++it)
-        result=min(result, it->second);
-  done=true;
-  return result;
+  pay.clear();
+  pay.insert_sorted(entries);
 }
 
-
 }  // end namespace Gambit::agg
 
 }  // end namespace Gambit
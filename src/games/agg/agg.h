@@ -30,6 +30,7 @@
 #include <iterator>
 #include "proj_func.h"
 #include "trie_map.h"
+#include "dense_map.h"
 
 namespace Gambit {
 
@@ -40,6 +41,9 @@ namespace gametracer {
 
 namespace agg {
 
+class Tokenizer;
+class BAGG;
+
 //data structure for mixed strategy profile:
 //alternatively: typedef std::vector<Number> ....
 #ifdef USE_CVECTOR
@@ -76,7 +80,58 @@ public:
   static const char LBRACKET='[';
   static const char RBRACKET=']';
 
+  //the largest box of configurations stored densely (see dense_map.h)
+  static const int MAX_DENSE_SIZE = 1<<18;
+
   friend class gametracer::aggame;   //wrapper class for gametracer
+  friend class BAGG;                 //reads its AGG part with makeAGG(Tokenizer&,...)
+
+  //scratch space for computing expected payoffs.
+  //Evaluating an AGG does not change it: the intermediate distributions
+  //are kept in an EvalContext supplied by the caller, so that one AGG can
+  //be evaluated from several threads at once, each with its own context.
+  class EvalContext {
+  public:
+    explicit EvalContext(const AGG &g);
+
+  private:
+    friend class AGG;
+    friend class gametracer::aggame;
+
+    //foreach s \in S, foreach i \in N, the projected mixed strat
+    //which is a prob distribution over the set of 'contributions'
+    std::vector< std::vector<aggdistrib > > projectedStrat;
+
+    //when computing the induced distribution via ComputeP():
+    //foreach k<= n-1,  
+    //prob. distrib P_k induced by the partial strat profile of agents o_1..o_k
+
+    //when computing the partial distributions for the payoff jacobian:
+    //  foreach  j \in N,
+    // the partial distribution induced by all agents except j. 
+    std::vector<aggdistrib>  Pr;
+
+    //distributions for the k-symmetric payoffs
+    aggdistrib d, temp;
+
+    //cache of jacobian entries.
+    trie_map<AggNumber> cache;
+
+    //for action nodes stored densely, the induced distribution,
+    //and the projected mixed strat of one player
+    dense_map<AggNumber> denseP;
+    std::vector<AggNumber> denseProb;
+
+    //the evaluation plan of one action node (see computePlan()).
+    //For a node stored densely: the projected mixed strat of each player,
+    //foreach k<n the distribution induced by players 0..k-1, and
+    //foreach k>0 the payoffs averaged over the strats of players k..n-1.
+    std::vector<std::vector<AggNumber> > denseProbs;
+    std::vector<dense_map<AggNumber> > denseForward, denseBackward;
+    //Otherwise, foreach 0<k<n the distributions induced by players 0..k-1
+    //and by players k..n-1
+    std::vector<aggdistrib> prefix, suffix;
+  };
 
   //read an AGG from a file
   static AGG* makeAGG(char* filename);
@@ -98,7 +153,6 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
    std::vector<std::vector<std::vector<config> > >& proj,
    std::vector<std::vector<proj_func*> > & projF,
    std::vector<std::vector<std::vector<int> > >& Po,
-   std::vector<aggdistrib> &P,
       std::vector<aggpayoff>& payoffs);
 
 
@@ -120,24 +174,24 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
   }
 
 
-  inline int getNumPlayers() {return numPlayers;}
-  inline int getNumActions() {return totalActions;}
-  inline int getNumActions(int i){return actions[i];}  
-  inline int getMaxActions() {return maxActions;}
-  inline int firstAction(int i) {return strategyOffset[i];}
-  inline int lastAction(int i) {return strategyOffset[i+1];}
+  inline int getNumPlayers() const {return numPlayers;}
+  inline int getNumActions() const {return totalActions;}
+  inline int getNumActions(int i) const {return actions[i];}  
+  inline int getMaxActions() const {return maxActions;}
+  inline int firstAction(int i) const {return strategyOffset[i];}
+  inline int lastAction(int i) const {return strategyOffset[i+1];}
 
-  inline int getNumActionNodes() {return numActionNodes;}
-  inline int getNumFunctionNodes() {return numPNodes;}
+  inline int getNumActionNodes() const {return numActionNodes;}
+  inline int getNumFunctionNodes() const {return numPNodes;}
   //inline int getNumUniqueActionSets(){return uniqueActionSets.size();}
-  inline int getNumKSymActions(){return numKSymActions;}
-  inline int getNumKSymActions(int i){return uniqueActionSets[i].size();}
-  inline int getNumPlayerClasses(){return playerClasses.size();}
-  inline const PlayerSet& getPlayerClass(int cls){return playerClasses.at(cls);}
-  inline int firstKSymAction(int i){return kSymStrategyOffset[i];}
-  inline int lastKSymAction(int i){return kSymStrategyOffset[i+1];}
-
-  inline void printActionGraph(std::ostream &s) {
+  inline int getNumKSymActions() const {return numKSymActions;}
+  inline int getNumKSymActions(int i) const {return uniqueActionSets[i].size();}
+  inline int getNumPlayerClasses() const {return playerClasses.size();}
+  inline const PlayerSet& getPlayerClass(int cls) const {return playerClasses.at(cls);}
+  inline int firstKSymAction(int i) const {return kSymStrategyOffset[i];}
+  inline int lastKSymAction(int i) const {return kSymStrategyOffset[i+1];}
+
+  inline void printActionGraph(std::ostream &s) const {
     for(size_t i=0;i< neighbors.size(); ++i){
       s<<neighbors[i].size()<<"\t";
       copy(neighbors[i].begin(),neighbors[i].end(), std::ostream_iterator<int>(s," ") );
@@ -145,7 +199,7 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
     }
   }
 
-  inline void printTypes(std::ostream &s) {
+  inline void printTypes(std::ostream &s) const {
     for(size_t i=0;i<projectionTypes.size();i++ ){
       projectionTypes[i]->print(s);
     }
@@ -153,39 +207,96 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
 
 
   //exp. payoff under mixed strat profile
-  AggNumber getMixedPayoff(int player, StrategyProfile &s);
-  void getPayoffVector(AggNumberVector &dest, int player,const StrategyProfile &s);
-  AggNumber getV (int player, int action,const StrategyProfile &s);
-  AggNumber getJ(int player,int action, int player2,int action2,StrategyProfile &s);
+  AggNumber getMixedPayoff(EvalContext &ctx, int player, StrategyProfile &s) const;
+  void getPayoffVector(EvalContext &ctx, AggNumberVector &dest, int player,const StrategyProfile &s) const;
+  //the payoff vectors of all players, indexed as s
+  void getPayoffVectors(EvalContext &ctx, AggNumberVector &dest, const StrategyProfile &s) const;
+  AggNumber getV (EvalContext &ctx, int player, int action,const StrategyProfile &s) const;
+  AggNumber getJ(EvalContext &ctx, int player,int action, int player2,int action2,StrategyProfile &s) const;
+
+  //the same, using a context of their own
+  AggNumber getMixedPayoff(int player, StrategyProfile &s) const {
+    EvalContext ctx(*this);
+    return getMixedPayoff(ctx, player, s);
+  }
+  void getPayoffVector(AggNumberVector &dest, int player,const StrategyProfile &s) const {
+    EvalContext ctx(*this);
+    getPayoffVector(ctx, dest, player, s);
+  }
+  void getPayoffVectors(AggNumberVector &dest, const StrategyProfile &s) const {
+    EvalContext ctx(*this);
+    getPayoffVectors(ctx, dest, s);
+  }
+  AggNumber getV (int player, int action,const StrategyProfile &s) const {
+    EvalContext ctx(*this);
+    return getV(ctx, player, action, s);
+  }
+  AggNumber getJ(int player,int action, int player2,int action2,StrategyProfile &s) const {
+    EvalContext ctx(*this);
+    return getJ(ctx, player, action, player2, action2, s);
+  }
 
 
-  AggNumber getPurePayoff(int player, std::vector<int> &s);
-  inline void printPayoffs(std::ostream &s, int node){
+  AggNumber getPurePayoff(int player, std::vector<int> &s) const;
+  inline void printPayoffs(std::ostream &s, int node) const {
     s << payoffs.at(node).size()<<std::endl;
     s << payoffs[node];
   }
 
-  bool isSymmetric(){
+  bool isSymmetric() const {
     for (int i=0;i<numPlayers;++i){
       if (actions[i]<numActionNodes) return false;
     }
     return true;
   }
-  AggNumber getSymMixedPayoff( StrategyProfile &s);
-  AggNumber getSymMixedPayoff(int actnode, StrategyProfile &s);
-  void getSymPayoffVector(AggNumberVector& dest, StrategyProfile &s);
-  AggNumber getKSymMixedPayoff( int playerClass,std::vector<StrategyProfile> &s);
-  AggNumber getKSymMixedPayoff( int playerClass,StrategyProfile &s);
-  AggNumber getKSymMixedPayoff(int playerClass, int act, std::vector<StrategyProfile> &s);
-  AggNumber getKSymMixedPayoff(const StrategyProfile &s,int pClass1,int act1,int pClass2=-1,int act2=-1);
-  void getKSymPayoffVector(AggNumberVector& dest, int playerClass, StrategyProfile &s);
+  AggNumber getSymMixedPayoff(EvalContext &ctx, StrategyProfile &s) const;
+  AggNumber getSymMixedPayoff(EvalContext &ctx, int actnode, StrategyProfile &s) const;
+  void getSymPayoffVector(EvalContext &ctx, AggNumberVector& dest, StrategyProfile &s) const;
+  AggNumber getKSymMixedPayoff(EvalContext &ctx, int playerClass,std::vector<StrategyProfile> &s) const;
+  AggNumber getKSymMixedPayoff(EvalContext &ctx, int playerClass,StrategyProfile &s) const;
+  AggNumber getKSymMixedPayoff(EvalContext &ctx, int playerClass, int act, std::vector<StrategyProfile> &s) const;
+  AggNumber getKSymMixedPayoff(EvalContext &ctx, const StrategyProfile &s,int pClass1,int act1,int pClass2=-1,int act2=-1) const;
+  void getKSymPayoffVector(EvalContext &ctx, AggNumberVector& dest, int playerClass, StrategyProfile &s) const;
+
+  AggNumber getSymMixedPayoff( StrategyProfile &s) const {
+    EvalContext ctx(*this);
+    return getSymMixedPayoff(ctx, s);
+  }
+  AggNumber getSymMixedPayoff(int actnode, StrategyProfile &s) const {
+    EvalContext ctx(*this);
+    return getSymMixedPayoff(ctx, actnode, s);
+  }
+  void getSymPayoffVector(AggNumberVector& dest, StrategyProfile &s) const {
+    EvalContext ctx(*this);
+    getSymPayoffVector(ctx, dest, s);
+  }
+  AggNumber getKSymMixedPayoff( int playerClass,std::vector<StrategyProfile> &s) const {
+    EvalContext ctx(*this);
+    return getKSymMixedPayoff(ctx, playerClass, s);
+  }
+  AggNumber getKSymMixedPayoff( int playerClass,StrategyProfile &s) const {
+    EvalContext ctx(*this);
+    return getKSymMixedPayoff(ctx, playerClass, s);
+  }
+  AggNumber getKSymMixedPayoff(int playerClass, int act, std::vector<StrategyProfile> &s) const {
+    EvalContext ctx(*this);
+    return getKSymMixedPayoff(ctx, playerClass, act, s);
+  }
+  AggNumber getKSymMixedPayoff(const StrategyProfile &s,int pClass1,int act1,int pClass2=-1,int act2=-1) const {
+    EvalContext ctx(*this);
+    return getKSymMixedPayoff(ctx, s, pClass1, act1, pClass2, act2);
+  }
+  void getKSymPayoffVector(AggNumberVector& dest, int playerClass, StrategyProfile &s) const {
+    EvalContext ctx(*this);
+    getKSymPayoffVector(ctx, dest, playerClass, s);
+  }
 
 
 
   //void KSymNormalizeStrategy(StrategyProfile &s);
 
 
-  AggNumberVector getExpectedConfig(StrategyProfile &s){
+  AggNumberVector getExpectedConfig(StrategyProfile &s) const {
 	  AggNumberVector res(numActionNodes, 0);
 	  for (int i=0;i<numPlayers;++i){
 		  for(int j=0;j<actions[i];++j){
@@ -195,14 +306,14 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
 	  return res;
   }
 
-  std::vector<proj_func*>& getProjFunctions(int node){return projFunctions.at(node);}
-  const std::vector<int>& getPorder(int player, int action){return Porder.at(player).at(action);}
-  const std::vector<std::vector<config> >& getProjection(int node){return projection.at(node);}
-  const std::vector<int>& getActionSet(int player){return actionSets.at(player);}
-  const aggpayoff& getPayoffMap(int node){return payoffs.at(node);}
+  const std::vector<proj_func*>& getProjFunctions(int node) const {return projFunctions.at(node);}
+  const std::vector<int>& getPorder(int player, int action) const {return Porder.at(player).at(action);}
+  const std::vector<std::vector<config> >& getProjection(int node) const {return projection.at(node);}
+  const std::vector<int>& getActionSet(int player) const {return actionSets.at(player);}
+  const aggpayoff& getPayoffMap(int node) const {return payoffs.at(node);}
 
-  AggNumber getMaxPayoff();
-  AggNumber getMinPayoff();
+  AggNumber getMaxPayoff() const {return maxPayoff;}
+  AggNumber getMinPayoff() const {return minPayoff;}
 
 
 
@@ -243,10 +354,6 @@ private:
   // the contribution of s' to D^(s)
   //std::vector<std::vector<config> > projection;
 
-  //foreach s \in S, foreach i \in N, the projected mixed strat
-  //which is a prob distribution over the set of 'contributions'
-  std::vector< std::vector<aggdistrib > > projectedStrat;
-
   // foreach s in S, i in N, the full set of projected actions.
   std::vector<std::vector<aggdistrib> >fullProjectedStrat;
 
@@ -257,24 +364,12 @@ private:
   // in which we apply the DP algorithm
   std::vector< std::vector< std::vector<int> > > Porder;
 
-  //when computing the induced distribution via ComputeP():
-  //foreach k<= n-1,  
-  //prob. distrib P_k induced by the partial strat profile of agents o_1..o_k
-
-  //when computing the partial distributions for the payoff jacobian:
-  //  foreach  j \in N,
-  // the partial distribution induced by all agents except j. 
-  std::vector<aggdistrib>  Pr;
-
   //foreach s in S, whether s's neighbors are all action nodes
   std::vector<bool> isPure;
 
   //foreach s in S, j in N, the index of s in j's action set, or -1 if N/A
   std::vector<std::vector<int> > node2Action;
 
-  //cache of jacobian entries.
-  trie_map<AggNumber> cache;
-
   //the unique action sets
   std::vector<ActionSet> uniqueActionSets;
 
@@ -290,15 +385,25 @@ private:
   //strategyOffset for kSymmetric strategy profile
   std::vector<int> kSymStrategyOffset;
 
+  //foreach s in S, whether the configurations of s are stored densely.
+  //This is the case when every neighbor of s is counted by a sum,
+  //and the box of possible configurations is at most MAX_DENSE_SIZE.
+  std::vector<bool> isDense;
+
+  //foreach s in S stored densely, the size of its box
+  std::vector<int> denseSize;
+
+  //foreach s in S stored densely, foreach i in N,
+  //the distinct offsets of the contributions of i's actions to s,
+  //and foreach s_i in S_i, the index of its offset among them
+  std::vector<std::vector<std::vector<int> > > denseOffsets, denseSlot;
+
+  //foreach s in S stored densely, the payoffs indexed by offset
+  std::vector<AggNumberVector> densePayoffs;
+
+  //the extreme payoffs over all action nodes
+  AggNumber maxPayoff, minPayoff;
 
-  //input functor 
-  struct input : public std::unary_function<aggpayoff::iterator , void>{
-    input(std::istream &i): in(i) {}
-    void operator() (aggpayoff::iterator p) {
-	in >> (*p).second;
-    }
-    std::istream &in;
-  };
 
   struct inputRand : public std::unary_function<aggpayoff::iterator, void>{
     inputRand(bool int_payoffs=false, int int_factor=100):int_payoffs(int_payoffs),int_factor(int_factor) {}
@@ -319,12 +424,13 @@ private:
   //private static methods:
 
 
-  static void makeCOMPLETEpayoff(std::istream &in, aggpayoff& pay){
-      pay.in_order(input(in));
-  }
-  static void makeMAPPINGpayoff(std::istream &in, aggpayoff& pay, int);
+  //read the rest of an AGG, from the neighbor lists onwards, given the
+  //numbers of players and nodes and the action sets
+  static AGG* makeAGG(Tokenizer &tok, int n, int S, int P,
+                      std::vector<std::vector<int> > &ASets);
 
-  static void stripComment(std::istream &in);
+  static void makeCOMPLETEpayoff(Tokenizer &tok, aggpayoff& pay);
+  static void makeMAPPINGpayoff(Tokenizer &tok, aggpayoff& pay, int);
 
   static void setProjections(std::vector<std::vector<aggdistrib > >& projS,
   std::vector<std::vector<std::vector<config> > >& proj, int N,int S,int P, std::vector<std::vector<int> >& AS, std::vector<std::vector<int> >& neighb, std::vector<projtype>& projTypes);
@@ -337,17 +443,35 @@ private:
 
 
   //private methods:
-  void computeP(int player, int act, int player2=-1,int act2=-1);
-  void doProjection(int Node,const StrategyProfile& s){
-	  doProjection (Node, &(const_cast<StrategyProfile &>(s)[0]));
+  void computeP(EvalContext &ctx, int player, int act, int player2=-1,int act2=-1) const;
+  void computeDenseP(EvalContext &ctx, const StrategyProfile &s, int player, int act, int player2=-1,int act2=-1) const;
+  void setDense(int Node);
+
+  //The evaluation plan of an action node, under the strat profile s,
+  //from which the payoffs of every player's action at the node are
+  //derived without repeating the products over the other players.
+  //A node stored densely keeps its plan densely only if numPlayers+1
+  //copies of its box fit in MAX_DENSE_SIZE.
+  bool isDensePlan(int Node) const {
+    return isDense[Node] && (double)(numPlayers+1)*denseSize[Node]<=MAX_DENSE_SIZE;
+  }
+  void computePlan(EvalContext &ctx, int Node, const StrategyProfile &s) const;
+  //getV() for an action of player at the node of the current plan
+  AggNumber getPlanV(EvalContext &ctx, int Node, int player, int act) const;
+  //getJ() for an action of player at the node of the current plan, which
+  //must be kept densely, against every action of every other player;
+  //stored in row, indexed as a strat profile
+  void getPlanJ(EvalContext &ctx, AggNumber *row, int Node, int player, int act) const;
+  void doProjection(EvalContext &ctx, int Node,const StrategyProfile& s) const {
+	  doProjection (ctx, Node, &(const_cast<StrategyProfile &>(s)[0]));
   }
-  void doProjection(int Node, int player, const StrategyProfile& s){
-	  doProjection(Node,player, &(const_cast<StrategyProfile &>(s)[firstAction(player)]));
+  void doProjection(EvalContext &ctx, int Node, int player, const StrategyProfile& s) const {
+	  doProjection(ctx, Node,player, &(const_cast<StrategyProfile &>(s)[firstAction(player)]));
   }
-  void doProjection(int Node, AggNumber* s);
-  void doProjection(int Node, int player, AggNumber* s);
+  void doProjection(EvalContext &ctx, int Node, AggNumber* s) const;
+  void doProjection(EvalContext &ctx, int Node, int player, AggNumber* s) const;
 
-  void getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,int plClass2=-1,int act2=-1);
+  void getSymConfigProb(EvalContext &ctx, int plClass, StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,int plClass2=-1,int act2=-1) const;
 };
 
 }  // end namespace Gambit::agg
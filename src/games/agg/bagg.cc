@@ -4,7 +4,9 @@
 #include <sstream>
 #include <algorithm>
 #include <cassert>
+#include "gambit.h"
 #include "games/agg/bagg.h"
+#include "games/agg/tokenizer.h"
 
 using namespace std;
 
@@ -48,16 +50,6 @@ BAGG::BAGG(int N, int S,
 }
 
 
-void BAGG::stripComment(istream& in){
-  in>>ws;
-  char c =in.peek();
-  stringbuf discard(ios_base::out);
-  if(c== BAGG::COMMENT_CHAR){
-    in.get (discard);
-    stripComment(in);
-  }
-}
-
 BAGG *BAGG::makeBAGG(char* filename)
 {
   ifstream in(filename);
@@ -65,72 +57,59 @@ BAGG *BAGG::makeBAGG(char* filename)
 }
 
 BAGG *BAGG::makeBAGG(istream& in){
-  int N,S,P;
-
-  stripComment(in);
-  in>> N;
-  stripComment(in);
-  in>>S;
-  stripComment(in);
-  in>>P;
+  if(!in.good()) {
+    throw InvalidFileException("Bad game file");
+  }
+  Tokenizer tok(in, BAGG::COMMENT_CHAR);
+  int N=tok.getInt("the number of players");
+  int S=tok.getInt("the number of action nodes");
+  int P=tok.getInt("the number of function nodes");
+  if (N<1 || S<0 || P<0) {
+    tok.error("Error in game file: bad numbers of players or nodes");
+  }
 
-  stripComment(in);
   vector<int> numTypes(N);
 
   //input number of types for each player
   for(int i=0;i<N;++i){
-    if(in.eof()||in.bad()){
-      cerr<<"Error in game file: integer expected for the number of types for player "<<i<<endl;
-      exit(1);
+    numTypes[i]=tok.getInt("the number of types for a player");
+    if (numTypes[i]<1) {
+      tok.error("Error in game file: number of types is not positive");
     }
-    in>>numTypes[i];
   }
 
   //input the type distributions
-  stripComment(in);
   vector<ProbDist> TDist;
   for(int i=0;i<N;++i){
     TDist.push_back(ProbDist(numTypes[i]) );
     for(int j=0;j<numTypes[i];++j){
-      if(in.eof()||in.bad()){
-            cerr<<"Error in game file: number expected for type distribution"<<endl;
-            exit(1);
-      }
-      in>>TDist[i][j];
+      TDist[i][j]=tok.getNumber("a probability of the type distribution");
     }
   }
 
-  stripComment(in);
   //sizes of type action sets
   vector<vector<vector<int> > > typeActionSets(N);
   for (int i=0;i<N;++i){
     for(int j=0;j<numTypes[i];++j){
-      if(in.eof()||in.bad()){
-            cerr<<"Error in game file: integer expected for size of type action set"<<endl;
-            exit(1);
+      int temp=tok.getInt("the size of a type action set");
+      if (temp<1) {
+        tok.error("Error in game file: type action set is empty");
       }
-      int temp;
-      in>>temp;
       typeActionSets[i].push_back(vector<int>(temp));
-    
     }
   }
 
-    
   //type action sets
-  stripComment(in);
   for(int i=0;i<N;++i){
     for(int j=0;j<numTypes[i];++j){
       for(size_t k=0;k<typeActionSets[i][j].size();++k){
-        if(in.eof()||in.bad()){
-              cerr<<"Error in game file: integer expected for type action set"<<endl;
-              exit(1);
+        typeActionSets[i][j][k]=tok.getInt("an action node of a type action set");
+        if (typeActionSets[i][j][k]<0 || typeActionSets[i][j][k]>=S) {
+          tok.error("Error in game file: action node of a type action set is out of range");
         }
-        in>> typeActionSets[i][j][k];
       }
     }
   }
-  stripComment(in);
 
   //action sets
   vector<vector<int> > aggActionSets;
@@ -153,29 +132,8 @@ BAGG *BAGG::makeBAGG(istream& in){
     }
   }
 
-  //stream for constructing agg
-  stringstream aggss(stringstream::in | stringstream::out);
-  aggss<<N<<endl<<S<<endl<<P<<endl;
-  for (int i=0;i<N;i++) aggss<<aggActionSets[i].size()<<endl;
-  for (int i=0;i<N;i++){
-    for(size_t j=0;j<aggActionSets[i].size();j++){
-      aggss<<aggActionSets[i][j]<<" ";
-    }
-    aggss<<endl;
-  }
-
-  //copy rest of input into aggss
-  while(in){
-    string ln;
-    getline(in,ln);
-    aggss<<ln<<endl;
-  }
-
-  AGG *aggPtr = AGG::makeAGG(aggss);
-  if(!aggPtr){
-	  cerr<<"Error in BAGG file when reading the AGG part of the input."<<endl;
-	  exit(1);
-  }
+  //the rest of the input is the AGG part, read from the same stream
+  AGG *aggPtr = AGG::makeAGG(tok, N, S, P, aggActionSets);
   return new BAGG(N, S, numTypes, TDist, typeActionSets,
 		  typeAction2ActionIndex, aggPtr);
 }
@@ -223,25 +181,32 @@ BAGG *BAGG::makeRandomBAGG(int N,vector<int> &numTypes,vector<ProbDist> &TDist,i
 }
 
 AggNumber BAGG::getMixedPayoff(int player, StrategyProfile &s){
+  AGG::EvalContext ctx(*aggPtr);
   AggNumber res(0);
   for (int tp=0;tp<numTypes[player];++tp){
-    res+=indepTypeDist[player][tp] * getMixedPayoff(player,tp,s);
+    res+=indepTypeDist[player][tp] * getMixedPayoff(ctx,player,tp,s);
   }
   return res;
 }
 
 AggNumber BAGG::getMixedPayoff(int player,int tp, StrategyProfile &s){
+    AGG::EvalContext ctx(*aggPtr);
+    return getMixedPayoff(ctx,player,tp,s);
+}
+
+AggNumber BAGG::getMixedPayoff(AGG::EvalContext &ctx, int player,int tp, StrategyProfile &s){
     AggNumber res(0);
     for (size_t act=0;act<typeActionSets[player][tp].size(); ++act)
 	if (s[act+firstAction(player,tp)]>AggNumber(0.0))
-	    res+= s[act+firstAction(player,tp)] * getV(player,tp,act,s);
+	    res+= s[act+firstAction(player,tp)] * getV(ctx,player,tp,act,s);
     return res;
 }
 
 void BAGG::getPayoffVector(AggNumberVector &dest, int player,int tp, const StrategyProfile &s){
     assert(player>=0&&player < getNumPlayers() && tp>=0 && tp<getNumTypes(player));
+    AGG::EvalContext ctx(*aggPtr);
     for(size_t act=0;act<typeActionSets[player][tp].size(); ++act){
-      dest[act] = getV(player,tp,act,s);
+      dest[act] = getV(ctx,player,tp,act,s);
     }
 }
 
@@ -265,9 +230,14 @@ void BAGG::getAGGStrat(StrategyProfile &as, const StrategyProfile &s, int player
 
 }
 AggNumber BAGG::getV (int player, int tp, int action,const StrategyProfile &s){
+    AGG::EvalContext ctx(*aggPtr);
+    return getV(ctx,player,tp,action,s);
+}
+
+AggNumber BAGG::getV (AGG::EvalContext &ctx, int player, int tp, int action,const StrategyProfile &s){
     StrategyProfile as(aggPtr->getNumActions());
     getAGGStrat(as, s, player,tp,action);
-    return aggPtr->getV(player, typeAction2ActionIndex[player][tp][action], as);
+    return aggPtr->getV(ctx, player, typeAction2ActionIndex[player][tp][action], as);
 }
 
 AggNumber BAGG::getPurePayoff(int player, int tp, std::vector<int> &ps)
@@ -294,28 +264,41 @@ void BAGG::getSymAGGStrat(StrategyProfile &as, const StrategyProfile &s)
 
 AggNumber BAGG::getSymMixedPayoff(StrategyProfile &s)
 {
+  AGG::EvalContext ctx(*aggPtr);
   AggNumber res(0);
   for (int tp=0;tp<numTypes[0];++tp){
-    res+=indepTypeDist[0][tp] * getSymMixedPayoff(tp,s);
+    res+=indepTypeDist[0][tp] * getSymMixedPayoff(ctx,tp,s);
   }
   return res;
 
 }
 
 AggNumber BAGG::getSymMixedPayoff(int tp, StrategyProfile &s)
+{
+  AGG::EvalContext ctx(*aggPtr);
+  return getSymMixedPayoff(ctx,tp,s);
+}
+
+AggNumber BAGG::getSymMixedPayoff(AGG::EvalContext &ctx, int tp, StrategyProfile &s)
 {
   AggNumber res(0);
   for (size_t act=0;act<typeActionSets[0][tp].size(); ++act)
       if (s[act+firstAction(0,tp)]>AggNumber(0.0))
-          res+= s[act+firstAction(0,tp)] * getSymMixedPayoff(tp,act,s);
+          res+= s[act+firstAction(0,tp)] * getSymMixedPayoff(ctx,tp,act,s);
   return res;
 }
 
 AggNumber BAGG::getSymMixedPayoff(int tp, int act, StrategyProfile &s)
+{
+  AGG::EvalContext ctx(*aggPtr);
+  return getSymMixedPayoff(ctx,tp,act,s);
+}
+
+AggNumber BAGG::getSymMixedPayoff(AGG::EvalContext &ctx, int tp, int act, StrategyProfile &s)
 {
   StrategyProfile as(aggPtr->getNumActionNodes());
   getSymAGGStrat(as, s);
-  return aggPtr->getSymMixedPayoff(typeActionSets[0][tp][act], as);
+  return aggPtr->getSymMixedPayoff(ctx, typeActionSets[0][tp][act], as);
 }
 
 
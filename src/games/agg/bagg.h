@@ -141,7 +141,11 @@ private:
 
   bool symmetric;
 
-  static void stripComment(std::istream &in);
+  //the evaluations above, sharing one evaluation context of aggPtr
+  AggNumber getMixedPayoff(AGG::EvalContext &ctx, int player,int tp, StrategyProfile &s);
+  AggNumber getV (AGG::EvalContext &ctx, int player, int tp, int action,const StrategyProfile &s);
+  AggNumber getSymMixedPayoff(AGG::EvalContext &ctx, int tp, StrategyProfile &s);
+  AggNumber getSymMixedPayoff(AGG::EvalContext &ctx, int tp, int act, StrategyProfile &s);
 
   void getAGGStrat(StrategyProfile &as, const StrategyProfile &s, int player=-1, int tp=-1, int action=-1);
   void getSymAGGStrat(StrategyProfile &as, const StrategyProfile &s);
@@ -0,0 +1,164 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2022, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/games/agg/dense_map.h
+// Distribution over a small box of configurations, stored as a flat array
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef GAMBIT_AGG_DENSEMAP_H
+#define GAMBIT_AGG_DENSEMAP_H
+
+//Mapping from configurations to type V, for configurations c whose
+//coordinates are counts bounded by a box 0<=c[j]<=bound[j].
+//A configuration is stored at offset sum_j c[j]*stride[j] of a flat array,
+//so that adding a contribution x to every configuration shifts the array
+//by the offset of x.  The strides and offsets are kept by the owner;
+//the map itself only sees offsets.
+
+#include <vector>
+#include <algorithm>
+
+namespace Gambit {
+
+namespace agg {
+
+template <class V> class dense_map {
+public:
+  dense_map() : hi(0) {}
+
+  //the distribution putting probability one on offset base,
+  //in a box of the given size
+  void reset(size_t size, size_t base){
+    if (data.size()<size) {
+      data.resize(size, (V)0);
+      spare.resize(size, (V)0);
+    }
+    std::fill(data.begin(), data.begin()+hi+1, (V)0);
+    hi=base;
+    data[base]=(V)1;
+  }
+
+  //polynomial multiplication by the distribution putting probability
+  //probs[k] on offsets[k].  Offsets with zero probability are skipped.
+  void multiply(const std::vector<int> &offsets, const std::vector<V> &probs){
+    size_t newhi=hi;
+    for (size_t k=0;k<offsets.size();++k)if(probs[k]>(V)0){
+      newhi=std::max(newhi, hi+offsets[k]);
+    }
+    std::fill(spare.begin(), spare.begin()+newhi+1, (V)0);
+    const V *src=&data[0];
+    for (size_t k=0;k<offsets.size();++k)if(probs[k]>(V)0){
+      V p=probs[k];
+      V *dest=&spare[offsets[k]];
+      for (size_t i=0;i<=hi;++i){
+	dest[i]+=p*src[i];
+      }
+    }
+    std::fill(data.begin(), data.begin()+hi+1, (V)0);
+    data.swap(spare);
+    hi=newhi;
+  }
+
+  //multiply by the distribution putting probability p on offset
+  void multiply(size_t offset, V p){
+    if (offset==0) {
+      for (size_t i=0;i<=hi;++i) data[i]*=p;
+      return;
+    }
+    for (size_t i=hi+1;i-->0;){
+      data[i+offset]=p*data[i];
+      data[i]=(V)0;
+    }
+    hi+=offset;
+  }
+
+  //a copy of other
+  void assign(const dense_map &other){
+    if (data.size()<other.data.size()) {
+      data.resize(other.data.size(), (V)0);
+      spare.resize(other.data.size(), (V)0);
+    }
+    std::fill(data.begin(), data.begin()+hi+1, (V)0);
+    std::copy(other.data.begin(), other.data.begin()+other.hi+1, data.begin());
+    hi=other.hi;
+  }
+
+  //values indexed by offset, in a box of the given size
+  void assign(const std::vector<V> &values, size_t size){
+    if (data.size()<size) {
+      data.resize(size, (V)0);
+      spare.resize(size, (V)0);
+    }
+    std::fill(data.begin(), data.begin()+hi+1, (V)0);
+    std::copy(values.begin(), values.begin()+size, data.begin());
+    hi=size-1;
+  }
+
+  //the transpose of multiply(), for a map holding values rather than
+  //probabilities: the value at each offset x becomes the expectation of
+  //the values at x+offsets[k] under probs.
+  void correlate(const std::vector<int> &offsets, const std::vector<V> &probs){
+    size_t lo=hi+1;
+    std::fill(spare.begin(), spare.begin()+hi+1, (V)0);
+    const V *src=&data[0];
+    for (size_t k=0;k<offsets.size();++k)if(probs[k]>(V)0 && (size_t)offsets[k]<=hi){
+      V p=probs[k];
+      lo=std::min(lo, (size_t)offsets[k]);
+      const V *s=src+offsets[k];
+      for (size_t i=0;i+offsets[k]<=hi;++i){
+	spare[i]+=p*s[i];
+      }
+    }
+    std::fill(data.begin(), data.begin()+hi+1, (V)0);
+    data.swap(spare);
+    hi=(lo<=hi)?hi-lo:0;
+  }
+
+  //inner product with values indexed by offset
+  V inner_prod(const std::vector<V> &other) const{
+    V result(0);
+    for (size_t i=0;i<=hi;++i){
+      result+=data[i]*other[i];
+    }
+    return result;
+  }
+
+  //inner product with the values of other at offsets shifted by shift
+  V inner_prod(const dense_map &other, size_t shift) const{
+    V result(0);
+    if (shift>other.hi) return result;
+    size_t n=std::min(hi, other.hi-shift);
+    const V *o=&other.data[shift];
+    for (size_t i=0;i<=n;++i){
+      result+=data[i]*o[i];
+    }
+    return result;
+  }
+
+private:
+  //data[0..hi] holds the distribution; entries past hi are zero.
+  //spare is scratch space of the same size for multiply().
+  std::vector<V> data, spare;
+  size_t hi;
+};
+
+}  // end namespace Gambit::agg
+
+}  // end namespace Gambit
+
+#endif  // GAMBIT_AGG_DENSEMAP_H
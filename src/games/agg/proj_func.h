@@ -57,28 +57,24 @@ struct proj_func{
 	proj_func(TypeEnum tp,std::istream& in,int S) : Type(tp){
 	      in>>Default;
 	      if(in.eof()||in.bad()) {
-	                        std::cout << "proj_func() error: bad input.\n";
-	                        exit(1);
+	                        throw InvalidFileException("proj_func() error: bad input.");
 	      }
 	      int w;
 	      char c;
 	      in >>std::ws>>c;
 	      if (in.eof()||in.bad()||c!='['){
-	        std::cout<<"proj_func() error: [ expected.\n";
-	        exit(1);
+	        throw InvalidFileException("proj_func() error: [ expected.");
 	      }
 	      for (int i=0;i<S;i++) {
 	        if(in.eof()||in.bad()) {
-	                std::cout << "proj_func() error: bad input.\n";
-	                exit(1);
+	                throw InvalidFileException("proj_func() error: bad input.");
 	        }
 	        in >> w;
 	        weights.push_back(w);
 	      }
 	      in>>std::ws>>c;
 	      if(in.eof()||in.bad()||c!=']'){
-	        std::cout<<"proj_func() error: ] expected.\n";
-	        exit(1);
+	        throw InvalidFileException("proj_func() error: ] expected.");
 	      }
 	}
 	virtual ~proj_func() {}
@@ -125,13 +121,11 @@ struct proj_func_EXIST: public proj_func{
 struct proj_func_EXIST2: public proj_func{
     proj_func_EXIST2(std::istream& in, int S):proj_func(P_EXIST2,in,S){
       if (Default<0){
-        std::cout<<"proj_func_EXIST2() error: default value should be nonnegative.\n";
-        exit(1);
+        throw InvalidFileException("proj_func_EXIST2() error: default value should be nonnegative.");
       }
       for (size_t i=0;i<weights.size();i++){
         if(weights[i]<0){
-          std::cout<<"proj_func_EXIST2() error: weights should be nonnegative.\n";
-          exit(1);
+          throw InvalidFileException("proj_func_EXIST2() error: weights should be nonnegative.");
         }
       }
     }
@@ -219,8 +213,7 @@ inline proj_func* make_proj_func(TypeEnum type, std::istream &in,int S,int P){
 	case P_HIGH2: return (new proj_func_HIGH2(in,S));
 	case P_LOW2: return (new proj_func_LOW2(in,S));
 	default:
-	  std::cout<<"error: function type is not recognized."<<std::endl;
-	  return NULL;
+	  throw InvalidFileException("error: function type is not recognized.");
   }
 }
 
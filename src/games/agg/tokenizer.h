@@ -0,0 +1,184 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2022, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/games/agg/tokenizer.h
+// Tokenizer for reading AGG and BAGG files
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef GAMBIT_AGG_TOKENIZER_H
+#define GAMBIT_AGG_TOKENIZER_H
+
+#include <istream>
+#include <locale>
+#include <sstream>
+#include <string>
+
+#include "gambit.h"
+
+namespace Gambit {
+
+namespace agg {
+
+//Reads the tokens of an AGG or BAGG file: integers, numbers and
+//punctuation, separated by whitespace and by comments running from
+//the comment character to the end of the line.
+//
+//Characters are taken straight from the buffer of the stream, one at a
+//time, without formatted extraction.  Nothing is read ahead beyond the
+//current character, so the stream may still be read with >> in between,
+//and is left just after the last token read.
+//
+//Numbers are read in the classic "C" locale, whatever the locale of the
+//program.  As with formatted extraction, eofbit is set on the stream when
+//the end of input is reached, and failbit when a token is not what was
+//expected; the error is then reported by throwing InvalidFileException,
+//whose message names what was expected.
+class Tokenizer {
+public:
+  explicit Tokenizer(std::istream &p_in, char p_comment='#')
+    : in(p_in), buf(p_in.rdbuf()), comment(p_comment)
+  { number.imbue(std::locale::classic()); }
+
+  std::istream &stream() { return in; }
+
+  //skip whitespace and comments
+  void skip(){
+    int c=buf->sgetc();
+    while (c!=EOF){
+      if (c==comment){
+	do {
+	  c=buf->snextc();
+	} while (c!=EOF && c!='\n');
+      }
+      else if (isSpace(c)){
+	c=buf->snextc();
+      }
+      else {
+	return;
+      }
+    }
+    in.setstate(std::ios_base::eofbit);
+  }
+
+  //whether only whitespace and comments are left
+  bool atEnd(){
+    skip();
+    return buf->sgetc()==EOF;
+  }
+
+  //the next character after whitespace and comments, without taking it
+  int peek(){
+    skip();
+    return buf->sgetc();
+  }
+
+  //take the next character after whitespace and comments, which must be c
+  void expect(char c, const std::string &what){
+    if (peek()!=c) {
+      error(std::string(1,c)+" expected "+what);
+    }
+    buf->sbumpc();
+  }
+
+  int getInt(const std::string &what){
+    skip();
+    int c=buf->sgetc();
+    bool neg=(c=='-');
+    if (c=='-' || c=='+') {
+      c=buf->snextc();
+    }
+    if (!isDigit(c)) {
+      error("Error reading "+what);
+    }
+    long long x=0;
+    do {
+      x=10*x+(c-'0');
+      if (x>2147483647LL+neg) {
+	error("Integer out of range in "+what);
+      }
+      c=buf->snextc();
+    } while (isDigit(c));
+    if (c==EOF) {
+      in.setstate(std::ios_base::eofbit);
+    }
+    return (int)(neg ? -x : x);
+  }
+
+  double getNumber(const std::string &what){
+    skip();
+    //a number ends at whitespace, a comment, or a bracket
+    char token[64];
+    size_t len=0;
+    std::string longToken;
+    int c=buf->sgetc();
+    while (c!=EOF && !isSpace(c) && c!=comment && c!='[' && c!=']'){
+      if (len<sizeof(token)-1) {
+	token[len++]=(char)c;
+      }
+      else {
+	longToken.push_back((char)c);
+      }
+      c=buf->snextc();
+    }
+    if (c==EOF) {
+      in.setstate(std::ios_base::eofbit);
+    }
+    token[len]='\0';
+    if (len==0) {
+      error("Error reading "+what);
+    }
+    const char *s=token;
+    if (!longToken.empty()) {
+      longToken.insert(0, token);
+      s=longToken.c_str();
+    }
+    double x;
+    number.clear();
+    number.str(s);
+    number>>x;
+    if (number.fail() || !number.eof()) {
+      error("Error reading "+what+": "+s);
+    }
+    return x;
+  }
+
+  void error(const std::string &message) const {
+    in.setstate(std::ios_base::failbit);
+    throw InvalidFileException(message);
+  }
+
+private:
+  std::istream &in;
+  std::streambuf *buf;
+  char comment;
+  //parses the text of a number, in the classic locale
+  std::istringstream number;
+
+  static bool isSpace(int c){
+    return c==' ' || c=='\n' || c=='\t' || c=='\r' || c=='\f' || c=='\v';
+  }
+  static bool isDigit(int c){
+    return c>='0' && c<='9';
+  }
+};
+
+}  // end namespace Gambit::agg
+
+}  // end namespace Gambit
+
+#endif  // GAMBIT_AGG_TOKENIZER_H
@@ -60,9 +60,10 @@ protected:
   /// @name Auxiliary functions for computation of interesting values
   //@{
   void GetPayoff(GameTreeNodeRep *, const T &, int, T &) const;
+  T GetActionProb(const GameTreeActionRep *) const;
   
-  void ComputeSolutionDataPass2(const GameNode &node) const;
-  void ComputeSolutionDataPass1(const GameNode &node) const;
+  void ComputeSolutionDataPass2(const GameTreeNodeRep *node) const;
+  void ComputeSolutionDataPass1(const GameTreeNodeRep *node) const;
   void ComputeSolutionData(void) const;
   //@}
 
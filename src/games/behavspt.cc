@@ -94,15 +94,16 @@ PVector<int> BehaviorSupportProfile::NumActions(void) const
 
 int BehaviorSupportProfile::GetIndex(const GameAction &a) const
 {
-  if (a->GetInfoset()->GetGame() != m_efg)  throw MismatchException();
+  GameInfosetRep *infoset = a->GetInfoset();
+  if (infoset->GetGame() != m_efg)  throw MismatchException();
 
-  int pl = a->GetInfoset()->GetPlayer()->GetNumber();
+  int pl = infoset->GetPlayer()->GetNumber();
   if (pl == 0) {
     // chance action; all chance actions are always in the support
     return a->GetNumber();
   }
   else {
-    return m_actions[pl][a->GetInfoset()->GetNumber()].Find(a);
+    return GetIndex(pl, infoset->GetNumber(), a);
   }
 }
 
@@ -89,6 +89,17 @@ public:
 
   /// Returns the position of the action in the support. 
   int GetIndex(const GameAction &) const;
+  /// Returns the position in the support of an action of the given
+  /// personal player and information set, or zero if it is not in the
+  /// support.  The action is borrowed, not retained.
+  int GetIndex(int pl, int iset, GameObjectRef<GameActionRep> p_action) const
+  {
+    const Array<GameAction> &actions = m_actions[pl][iset];
+    for (int act = 1; act <= actions.Length(); act++) {
+      if (actions[act] == p_action)  return act;
+    }
+    return 0;
+  }
 
   /// Returns whether the action is in the support.
   bool Contains(const GameAction &p_action) const
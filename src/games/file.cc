@@ -23,12 +23,17 @@
 #include <cstdlib>
 #include <cctype>
 #include <iostream>
+#include <fstream>
 #include <sstream>
 #include <map>
+#include <vector>
+#include <limits>
+#include <cmath>
 
 #include "gambit.h"
 // for explicit access to turning off canonicalization
 #include "gametree.h"
+#include "gamedouble.h"
   
 
 namespace {
@@ -47,6 +52,8 @@ typedef enum {
 //! escaped-quotes within text labels.
 //!
 class GameParserState {
+  friend class PayoffScanner;
+
 private:
   std::istream &m_file;
 
@@ -272,6 +279,170 @@ std::string GameParserState::CreateLineMsg(const std::string &msg)
   return stream.str();
 }
 
+//!
+//! This scanner reads the list of payoffs making up the body of a .nfg
+//! file in payoff format, which for large games is nearly all of the
+//! file.  Instead of going through GameParserState a character at a
+//! time, it takes the rest of the stream in blocks, and parses the
+//! common cases of integers and short decimals directly, using
+//! lexical_cast<Rational>() only for other numbers.
+//!
+class PayoffScanner {
+private:
+  std::streambuf *m_buffer;
+  std::vector<char> m_block;
+  const char *m_pos, *m_end;
+  int m_currentLine, m_currentColumn;
+  std::string m_word;
+
+  bool FillBlock(void);
+  static bool ParseDecimal(const std::string &p_text, Number &p_value);
+
+public:
+  /// Continues reading from the current position of the parser
+  PayoffScanner(GameParserState &p_state);
+
+  /// Reads the next payoff; returns false at the end of the file
+  bool GetNextPayoff(Number &p_value);
+  /// Parses the text of a payoff
+  void ParsePayoff(const std::string &p_text, Number &p_value) const;
+  std::string CreateLineMsg(const std::string &msg) const;
+};
+
+PayoffScanner::PayoffScanner(GameParserState &p_state)
+  : m_buffer(p_state.m_file.rdbuf()), m_block(65536),
+    m_pos(0), m_end(0),
+    m_currentLine(p_state.GetCurrentLine()),
+    m_currentColumn(p_state.GetCurrentColumn())
+{ }
+
+bool PayoffScanner::FillBlock(void)
+{
+  std::streamsize count = m_buffer->sgetn(&m_block[0], m_block.size());
+  m_pos = &m_block[0];
+  m_end = m_pos + ((count > 0) ? count : 0);
+  return (m_pos != m_end);
+}
+
+bool PayoffScanner::GetNextPayoff(Number &p_value)
+{
+  while (true) {
+    if (m_pos == m_end && !FillBlock()) {
+      return false;
+    }
+    char c = *m_pos;
+    if (!isspace((unsigned char) c)) {
+      break;
+    }
+    if (c == '\n') {
+      m_currentLine++;
+      m_currentColumn = 1;
+    }
+    else {
+      m_currentColumn++;
+    }
+    m_pos++;
+  }
+
+  // A payoff runs to the next whitespace, possibly across blocks
+  m_word.clear();
+  do {
+    const char *start = m_pos;
+    while (m_pos != m_end && !isspace((unsigned char) *m_pos)) {
+      m_pos++;
+    }
+    m_word.append(start, m_pos - start);
+    m_currentColumn += m_pos - start;
+  } while (m_pos == m_end && FillBlock());
+
+  ParsePayoff(m_word, p_value);
+  return true;
+}
+
+void PayoffScanner::ParsePayoff(const std::string &p_text,
+				Number &p_value) const
+{
+  if (ParseDecimal(p_text, p_value)) {
+    return;
+  }
+  try {
+    p_value = Number(p_text);
+  }
+  catch (ValueException &) {
+    throw InvalidFileException(CreateLineMsg("Expecting payoff"));
+  }
+}
+
+//
+// Parses numbers of the form -ddd.ddd, provided they have few enough
+// digits that the numerator and denominator fit in an int.  Returns
+// false if the text is not of that form.
+//
+bool PayoffScanner::ParseDecimal(const std::string &p_text, Number &p_value)
+{
+  const char *c = p_text.c_str(), *end = c + p_text.length();
+  bool negative = (*c == '-');
+  if (negative) {
+    c++;
+  }
+
+  int numerator = 0, denominator = 1, digits = 0, intDigits = 0;
+  bool point = false;
+  for (; c != end; c++) {
+    if (*c >= '0' && *c <= '9') {
+      if (++digits > std::numeric_limits<int>::digits10) {
+	return false;
+      }
+      numerator = 10 * numerator + (*c - '0');
+      if (point) {
+	denominator *= 10;
+      }
+      else {
+	intDigits++;
+      }
+    }
+    else if (*c == '.' && !point) {
+      point = true;
+    }
+    else {
+      return false;
+    }
+  }
+  if (digits == 0) {
+    return false;
+  }
+
+  if (negative) {
+    numerator = -numerator;
+  }
+  // Both are exact as doubles, so their quotient is correctly rounded
+  double value = (double) numerator / (double) denominator;
+
+  // If the text is just as Number would write the double, there is no
+  // need to keep the text and rational
+  const char *first = p_text.c_str() + negative;
+  if (intDigits > 0 && (intDigits == 1 || *first != '0') &&
+      (!point || (digits > intDigits && *(end - 1) != '0')) &&
+      (numerator != 0 || (!negative && !point)) &&
+      (numerator == 0 || std::fabs(value) >= 1.0e-4)) {
+    p_value = Number(value);
+  }
+  else if (denominator == 1) {
+    p_value = Number(p_text, Rational(numerator), value);
+  }
+  else {
+    p_value = Number(p_text, Rational(numerator, denominator), value);
+  }
+  return true;
+}
+
+std::string PayoffScanner::CreateLineMsg(const std::string &msg) const
+{
+  std::stringstream stream;
+  stream << "line " << m_currentLine << ":" << m_currentColumn << ": " << msg;
+  return stream.str();
+}
+
 class TableFilePlayer {
 public:
   std::string m_name;
@@ -603,24 +774,30 @@ void ParseOutcomeBody(GameParserState &p_parser, GameRep *p_nfg)
   }
 }
 
+//
+// The game is a new table with one outcome for each contingency, in the
+// order in which the contingencies are listed.  Payoffs after the first,
+// which the parser has already read, are read by a PayoffScanner.
+//
 void ParsePayoffBody(GameParserState &p_parser, GameRep *p_nfg)
 {
-  StrategyProfileIterator iter(StrategySupportProfile(static_cast<GameRep *>(p_nfg)));
-  int pl = 1;
+  PayoffScanner scanner(p_parser);
+  int numPlayers = p_nfg->NumPlayers(), numOutcomes = p_nfg->NumOutcomes();
+  Number payoff;
+  scanner.ParsePayoff(p_parser.GetLastText(), payoff);
 
-  while (p_parser.GetCurrentToken() != TOKEN_EOF) {
-    if (p_parser.GetCurrentToken() == TOKEN_NUMBER) {
-      (*iter)->GetOutcome()->SetPayoff(pl, p_parser.GetLastText());
-    }
-    else {
-      throw InvalidFileException(p_parser.CreateLineMsg("Expecting payoff"));
+  for (int outc = 1; ; outc++) {
+    if (outc > numOutcomes) {
+      throw InvalidFileException(
+	scanner.CreateLineMsg("More payoffs than contingencies"));
     }
-
-    if (++pl > p_nfg->NumPlayers()) {
-      iter++;
-      pl = 1;
+    GameOutcome outcome = p_nfg->GetOutcome(outc);
+    for (int pl = 1; pl <= numPlayers; pl++) {
+      outcome->SetPayoff(pl, payoff);
+      if (!scanner.GetNextPayoff(payoff)) {
+	return;
+      }
     }
-    p_parser.GetNextToken();
   }
 }
 
@@ -1048,11 +1225,16 @@ Game GameXMLSavefile::GetGame(void) const
 }
 
 //=========================================================================
-//    ReadGame: Global visible function to read an .efg or .nfg file
+//    ReadGame: Global visible function to read an .efg, .nfg or .nfb file
 //=========================================================================
 
 Game ReadGame(std::istream &p_file)
 {
+  if (p_file.peek() == 0x89) {
+    // The first byte of the signature of the binary .nfb format
+    return GameDoubleTableRep::ReadNfbFile(p_file);
+  }
+
   std::stringstream buffer;
   buffer << p_file.rdbuf();
   try {
@@ -1077,9 +1259,9 @@ Game ReadGame(std::istream &p_file)
     else if (parser.GetLastText() == "EFG") {
       TreeData treeData;
       Game game = NewTree();
-      dynamic_cast<GameTreeRep &>(*game).SetCanonicalization(false);
+      GameTreeUpdate update(dynamic_cast<GameTreeRep &>(*game));
       ParseEfg(parser, game, treeData);
-      dynamic_cast<GameTreeRep &>(*game).SetCanonicalization(true);
+      update.Commit();
       return game;
     }
     else if (parser.GetLastText() == "#AGG") {
@@ -1097,4 +1279,19 @@ Game ReadGame(std::istream &p_file)
   }
 }
 
+Game ReadGame(const std::string &p_filename)
+{
+  std::ifstream file(p_filename.c_str(), std::ios::in | std::ios::binary);
+  if (!file.good()) {
+    throw InvalidFileException("Unable to open " + p_filename);
+  }
+  if (file.peek() == 0x89) {
+    // A .nfb file is read from the name, so that its payoffs may be
+    // mapped into memory rather than copied
+    file.close();
+    return GameDoubleTableRep::ReadNfbFile(p_filename);
+  }
+  return ReadGame(file);
+}
+
 } // end namespace Gambit
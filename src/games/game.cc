@@ -20,12 +20,14 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
+#include <climits>
 #include <iostream>
 #include <sstream>
 
 #include "gambit.h"
 #include "gametree.h"
 #include "gametable.h"
+#include "gamedouble.h"
 
 namespace Gambit {
 
@@ -38,6 +40,18 @@ GameOutcomeRep::GameOutcomeRep(GameRep *p_game, int p_number)
     m_payoffs(m_game->NumPlayers()), m_unrestricted(0)
 { }
 
+void GameOutcomeRep::SetPayoff(int pl, const std::string &p_value)
+{
+  m_payoffs[pl] = p_value;
+  m_game->ClearPayoffSummaries();
+}
+
+void GameOutcomeRep::SetPayoff(int pl, const Number &p_value)
+{
+  m_payoffs[pl] = p_value;
+  m_game->ClearPayoffSummaries();
+}
+
 
 //========================================================================
 //                      class GameStrategyRep
@@ -53,6 +67,7 @@ void GameStrategyRep::DeleteStrategy(void)
     m_player->m_strategies[st]->m_number = st;
   }
   //m_player->m_game->RebuildTable();
+  m_player->m_game->IncrementVersion();
   this->Invalidate();
 }
 
@@ -88,21 +103,27 @@ GameStrategy GamePlayerRep::NewStrategy(void)
   return strategy;
 }
 
-void GamePlayerRep::MakeStrategy(void)
+int GamePlayerRep::NumStrategies(void) const
 {
-  Array<int> c(NumInfosets());
-  
-  for (int i = 1; i <= NumInfosets(); i++)  {
-    if (m_infosets[i]->flag == 1)
-      c[i] = m_infosets[i]->whichbranch;
-    else
-      c[i] = 0;
+  // In a tree with perfect recall, the reduced strategies can be
+  // counted without building them
+  if (m_game->IsTree() && !m_game->HasComputedValues() && !IsChance() &&
+      m_game->IsPerfectRecall()) {
+    const GameTreeRep *tree = dynamic_cast<const GameTreeRep *>(m_game);
+    long count = tree->GetReducedStrategies(const_cast<GamePlayerRep *>(this)).NumStrategies();
+    if (count > INT_MAX) {
+      throw UndefinedException("Too many strategies to count with an int");
+    }
+    return (int) count;
   }
-  
+  m_game->BuildComputedValues();
+  return m_strategies.Length();
+}
+
+GameStrategyRep *GamePlayerRep::NewReducedStrategy(const Array<int> &p_behav)
+{
   GameStrategyRep *strategy = new GameStrategyRep(this);
-  m_strategies.Append(strategy);
-  strategy->m_number = m_strategies.Length();
-  strategy->m_behav = c;
+  strategy->m_behav = p_behav;
   strategy->m_label = "";
 
   // We generate a default labeling -- probably should be changed in future
@@ -119,6 +140,23 @@ void GamePlayerRep::MakeStrategy(void)
   else {
     strategy->m_label = "*";
   }
+  return strategy;
+}
+
+void GamePlayerRep::MakeStrategy(void)
+{
+  Array<int> c(NumInfosets());
+  
+  for (int i = 1; i <= NumInfosets(); i++)  {
+    if (m_infosets[i]->flag == 1)
+      c[i] = m_infosets[i]->whichbranch;
+    else
+      c[i] = 0;
+  }
+  
+  GameStrategyRep *strategy = NewReducedStrategy(c);
+  m_strategies.Append(strategy);
+  strategy->m_number = m_strategies.Length();
 }
 
 void GamePlayerRep::MakeReducedStrats(GameTreeNodeRep *n, GameTreeNodeRep *nn)
@@ -400,6 +438,16 @@ PureBehaviorProfile::ToMixedBehaviorProfile(void) const
 //                            class GameRep
 //========================================================================
 
+//------------------------------------------------------------------------
+//                     GameRep: General data access
+//------------------------------------------------------------------------
+
+PayoffSummary GameRep::GetPayoffSummary(int pl) const
+{
+  Rational minPay = GetMinPayoff(pl), maxPay = GetMaxPayoff(pl);
+  return PayoffSummary(minPay, (double) minPay, maxPay, (double) maxPay);
+}
+
 //------------------------------------------------------------------------
 //                     GameRep: Writing data files
 //------------------------------------------------------------------------
@@ -462,6 +510,39 @@ void GameRep::WriteNfgFile(std::ostream &p_file) const
 }
 
 
+///
+/// Write the game to a savefile in the binary .nfb format.
+///
+/// Like WriteNfgFile(), this uses only publicly-accessible operations,
+/// and so is valid for any game.  If all payoffs are integers which
+/// doubles represent exactly, they are written as 64-bit integers;
+/// otherwise they are written as doubles.
+///
+void GameRep::WriteNfbFile(std::ostream &p_file) const
+{
+  long numContingencies = 1L;
+  for (int pl = 1; pl <= NumPlayers(); pl++) {
+    numContingencies *= GetPlayer(pl)->NumStrategies();
+  }
+
+  std::vector<double> payoffs(numContingencies * NumPlayers());
+  const Rational largest(9007199254740992.0);   // 2^53
+  bool integer = true;
+  long index = 0L;
+  for (StrategyProfileIterator iter(Game(const_cast<GameRep *>(this)));
+       !iter.AtEnd(); iter++, index++) {
+    for (int pl = 1; pl <= NumPlayers(); pl++) {
+      Rational payoff = (*iter)->GetPayoff(pl);
+      if (integer && (payoff.denominator() != 1 || abs(payoff) > largest)) {
+	integer = false;
+      }
+      payoffs[(pl - 1) * numContingencies + index] = (double) payoff;
+    }
+  }
+  Gambit::WriteNfbFile(p_file, *this, &payoffs[0], integer);
+}
+
+
 //========================================================================
 //                       class GameExplicitRep
 //========================================================================
@@ -482,52 +563,67 @@ GameExplicitRep::~GameExplicitRep()
 //                  GameExplicitRep: General data access
 //------------------------------------------------------------------------
 
-Rational GameExplicitRep::GetMinPayoff(int player) const
-{
-  int index, p, p1, p2;
-  
-  if (m_outcomes.Length() == 0)  return Rational(0);
+namespace {
 
-  if (player) {
-    p1 = p2 = player;
+/// Compares payoffs on their doubles, and on their rationals only where
+/// these are equal and the rationals are not simply those of the doubles
+bool PayoffLess(const Number &a, const Number &b)
+{
+  if ((double) a != (double) b) {
+    return (double) a < (double) b;
   }
-  else {
-    p1 = 1;
-    p2 = NumPlayers();
+  if (a.IsFromDouble() && b.IsFromDouble()) {
+    return false;
   }
-  
-  Rational minpay = m_outcomes[1]->GetPayoff<Rational>(p1);
-  for (index = 1; index <= m_outcomes.Length(); index++)  {
-    for (p = p1; p <= p2; p++) {
-      if (m_outcomes[index]->GetPayoff<Rational>(p) < minpay) {
-	minpay = m_outcomes[index]->GetPayoff<Rational>(p);
+  return (const Rational &) a < (const Rational &) b;
+}
+
+}  // end anonymous namespace
+
+///
+/// Computes the summary of the payoffs of each player in one pass over
+/// the outcomes, and that of all players from these.  The summaries are
+/// kept until an outcome is added or removed, or a payoff is set.
+///
+const PayoffSummary &GameExplicitRep::GetCachedPayoffSummary(int pl) const
+{
+  if (m_payoffSummaries.Length() == 0) {
+    Array<PayoffSummary> summaries(0, m_players.Length());
+    if (m_outcomes.Length() > 0) {
+      Array<const Number *> minima(m_players.Length()), maxima(m_players.Length());
+      for (int p = 1; p <= m_players.Length(); p++) {
+	minima[p] = maxima[p] = &m_outcomes[1]->m_payoffs[p];
       }
+      for (int outc = 2; outc <= m_outcomes.Length(); outc++) {
+	const Array<Number> &payoffs = m_outcomes[outc]->m_payoffs;
+	for (int p = 1; p <= m_players.Length(); p++) {
+	  if (PayoffLess(payoffs[p], *minima[p]))  minima[p] = &payoffs[p];
+	  if (PayoffLess(*maxima[p], payoffs[p]))  maxima[p] = &payoffs[p];
+	}
+      }
+
+      const Number *minimum = minima[1], *maximum = maxima[1];
+      for (int p = 1; p <= m_players.Length(); p++) {
+	summaries[p] = PayoffSummary(*minima[p], *minima[p],
+				     *maxima[p], *maxima[p]);
+	if (PayoffLess(*minima[p], *minimum))  minimum = minima[p];
+	if (PayoffLess(*maximum, *maxima[p]))  maximum = maxima[p];
+      }
+      summaries[0] = PayoffSummary(*minimum, *minimum, *maximum, *maximum);
     }
+    m_payoffSummaries = summaries;
   }
-  return minpay;
+  return m_payoffSummaries[pl];
 }
 
-Rational GameExplicitRep::GetMaxPayoff(int player) const
+Rational GameExplicitRep::GetMinPayoff(int player) const
 {
-  int index, p, p1, p2;
-
-  if (m_outcomes.Length() == 0)  return Rational(0);
-
-  if (player) {
-    p1 = p2 = player;
-  }
-  else {
-    p1 = 1;
-    p2 = NumPlayers();
-  }
+  return GetCachedPayoffSummary(player).GetMin<Rational>();
+}
 
-  Rational maxpay = m_outcomes[1]->GetPayoff<Rational>(p1);
-  for (index = 1; index <= m_outcomes.Length(); index++)  {
-    for (p = p1; p <= p2; p++)
-      if (m_outcomes[index]->GetPayoff<Rational>(p) > maxpay)
-	maxpay = m_outcomes[index]->GetPayoff<Rational>(p);
-  }
-  return maxpay;
+Rational GameExplicitRep::GetMaxPayoff(int player) const
+{
+  return GetCachedPayoffSummary(player).GetMax<Rational>();
 }
 
 //------------------------------------------------------------------------
@@ -536,10 +632,9 @@ Rational GameExplicitRep::GetMaxPayoff(int player) const
 
 Array<int> GameExplicitRep::NumStrategies(void) const
 {
-  const_cast<GameExplicitRep *>(this)->BuildComputedValues();
   Array<int> dim(m_players.Length());
   for (int pl = 1; pl <= m_players.Length(); pl++) {
-    dim[pl] = m_players[pl]->m_strategies.Length();
+    dim[pl] = m_players[pl]->NumStrategies();
   }
   return dim;
 }
@@ -559,20 +654,18 @@ GameStrategy GameExplicitRep::GetStrategy(int p_index) const
 
 int GameExplicitRep::NumStrategyContingencies(void) const
 {
-  const_cast<GameExplicitRep *>(this)->BuildComputedValues();
   int ncont = 1;
   for (int pl = 1; pl <= m_players.Length(); pl++) {
-    ncont *= m_players[pl]->m_strategies.Length();
+    ncont *= m_players[pl]->NumStrategies();
   }
   return ncont;
 }
 
 int GameExplicitRep::MixedProfileLength(void) const
 {
-  const_cast<GameExplicitRep *>(this)->BuildComputedValues();
   int strats = 0;
   for (int i = 1; i <= m_players.Length();
-       strats += m_players[i++]->m_strategies.Length());
+       strats += m_players[i++]->NumStrategies());
   return strats;
 }
 
@@ -584,6 +677,7 @@ int GameExplicitRep::MixedProfileLength(void) const
 GameOutcome GameExplicitRep::NewOutcome(void)
 {
   m_outcomes.Append(new GameOutcomeRep(this, m_outcomes.Length() + 1));
+  ClearPayoffSummaries();
   return m_outcomes[m_outcomes.Last()];
 }
 
@@ -602,6 +696,9 @@ void GameExplicitRep::Write(std::ostream &p_stream,
 	   (p_format == "native" && !IsTree())) {
     WriteNfgFile(p_stream);
   }
+  else if (p_format == "nfb") {
+    WriteNfbFile(p_stream);
+  }
   else {
     throw UndefinedException();
   }
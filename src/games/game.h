@@ -24,7 +24,11 @@
 #ifndef LIBGAMBIT_GAME_H
 #define LIBGAMBIT_GAME_H
 
+#include <map>
 #include <memory>
+#include <mutex>
+#include <typeindex>
+#include "core/shared_ptr.h"
 #include "core/dvector.h"
 #include "core/number.h"
 
@@ -86,6 +90,8 @@ public:
 // member objects of games.  It takes care of all the reference-counting
 // considerations.
 //
+template <class T> class GameObjectRef;
+
 template <class T> class GameObjectPtr {
 private:
   T *rep;
@@ -93,6 +99,8 @@ private:
 public:
   GameObjectPtr(T *r = 0) : rep(r)
     { if (rep) rep->IncRef(); }
+  GameObjectPtr(const GameObjectRef<T> &r) : rep(r)
+    { if (rep) rep->IncRef(); }
   GameObjectPtr(const GameObjectPtr<T> &r) : rep(r.rep)
     { if (rep) rep->IncRef(); }
   ~GameObjectPtr() { if (rep) rep->DecRef(); }
@@ -117,6 +125,34 @@ public:
   bool operator!=(const GameObjectPtr<T> &r) const 
   { return (rep != r.rep); }
   bool operator!=(T *r) const { return (rep != r); }
+  bool operator==(const GameObjectRef<T> &r) const { return (rep == r); }
+  bool operator!=(const GameObjectRef<T> &r) const { return (rep != r); }
+
+  operator T *(void) const { return rep; }
+
+  bool operator!(void) const { return !rep; }
+};
+
+//
+// This is a borrowed handle to a member object of a game.  Unlike
+// GameObjectPtr, it takes no reference to the object, so copying it
+// costs no more than copying a pointer.  It is meant for loops over a
+// game which does not change while they run; it does not keep a deleted
+// object alive.  It converts to and from GameObjectPtr, so functions
+// taking either kind of handle accept both.
+//
+template <class T> class GameObjectRef {
+private:
+  T *rep;
+
+public:
+  GameObjectRef(T *r = 0) : rep(r) { }
+  GameObjectRef(const GameObjectPtr<T> &r) : rep(r) { }
+
+  T *operator->(void) const 
+    { if (!rep) throw NullException();
+      if (!rep->IsValid()) throw InvalidObjectException(); 
+      return rep; }
 
   operator T *(void) const { return rep; }
 
@@ -132,6 +168,7 @@ typedef GameObjectPtr<GameOutcomeRep> GameOutcome;
 
 class GameActionRep;
 typedef GameObjectPtr<GameActionRep> GameAction;
+class GameTreeActionRep;
 
 class GameInfosetRep;
 typedef GameObjectPtr<GameInfosetRep> GameInfoset;
@@ -236,11 +273,9 @@ public:
   template <class T> const T &GetPayoff(int pl) const 
     { return (const T &) m_payoffs[pl]; }
   /// Sets the payoff to player 'pl'
-  void SetPayoff(int pl, const std::string &p_value)
-  {
-    m_payoffs[pl] = p_value;
-    //m_game->ClearComputedValues();
-  }
+  void SetPayoff(int pl, const std::string &p_value);
+  /// Sets the payoff to player 'pl' to a number already parsed
+  void SetPayoff(int pl, const Number &p_value);
 
   /// Map the outcome to the corresponding outcome in the unrestricted game
   GameOutcome Unrestrict(void) const 
@@ -338,13 +373,19 @@ class GameStrategyRep : public GameObject  {
   friend class GameTableRep;
   friend class GameAggRep;
   friend class GameBagentRep;
+  friend class GameDoubleTableRep;
   friend class GamePlayerRep;
   friend class PureStrategyProfileRep;
   friend class TreePureStrategyProfileRep;
   friend class TablePureStrategyProfileRep;
+  friend class DoubleTablePureStrategyProfileRep;
   friend class StrategySupportProfile;
+  friend class TableContingencyIterator;
+  friend class ReducedStrategySpace;
   template <class T> friend class MixedStrategyProfile;
   template <class T> friend class TableMixedStrategyProfileRep;
+  template <class T> friend class DoubleTableMixedStrategyProfileRep;
+  template <class T> friend class TreeMixedStrategyProfileRep;
   template <class T> friend class MixedBehaviorProfile;
 
 private:
@@ -396,10 +437,12 @@ class GamePlayerRep : public GameObject {
   friend class GameAggRep;
   friend class GameBagentRep;
   friend class GameBaggRep;
+  friend class GameDoubleTableRep;
   friend class GameTreeInfosetRep;
   friend class GameStrategyRep;
   friend class GameTreeNodeRep;
   friend class StrategySupportProfile;
+  friend class ReducedStrategySpace;
   template <class T> friend class MixedBehaviorProfile;
   template <class T> friend class MixedStrategyProfile;
 
@@ -407,6 +450,9 @@ class GamePlayerRep : public GameObject {
   //@{
   void MakeStrategy(void);
   void MakeReducedStrats(GameTreeNodeRep *, GameTreeNodeRep *);
+  /// Create a strategy with the given behavior, with its default
+  /// label, without adding it to the player's list of strategies
+  GameStrategyRep *NewReducedStrategy(const Array<int> &p_behav);
   //@}
   
 private:
@@ -646,8 +692,45 @@ public:
 };
 
 
+/// The smallest and largest payoffs of a player, or of all players, over
+/// the outcomes of a game, both exactly and as the nearest doubles.
+/// Solvers use these to scale payoffs.
+class PayoffSummary {
+private:
+  Rational m_min, m_max;
+  double m_minDouble, m_maxDouble;
+
+public:
+  /// Construct the summary of a game with no outcomes
+  PayoffSummary(void)
+    : m_min(0), m_max(0), m_minDouble(0.0), m_maxDouble(0.0) { }
+  PayoffSummary(const Rational &p_min, double p_minDouble,
+		const Rational &p_max, double p_maxDouble)
+    : m_min(p_min), m_max(p_max),
+      m_minDouble(p_minDouble), m_maxDouble(p_maxDouble) { }
+
+  /// Returns the smallest payoff
+  template <class T> T GetMin(void) const;
+  /// Returns the largest payoff
+  template <class T> T GetMax(void) const;
+  /// Returns the difference between the largest and smallest payoffs
+  template <class T> T GetRange(void) const
+  { return GetMax<T>() - GetMin<T>(); }
+};
+
+template<> inline Rational PayoffSummary::GetMin<Rational>(void) const
+{ return m_min; }
+template<> inline double PayoffSummary::GetMin<double>(void) const
+{ return m_minDouble; }
+template<> inline Rational PayoffSummary::GetMax<Rational>(void) const
+{ return m_max; }
+template<> inline double PayoffSummary::GetMax<double>(void) const
+{ return m_maxDouble; }
+
 /// This is the class for representing an arbitrary finite game.
 class GameRep : public GameObject {
+  friend class GameOutcomeRep;
+  friend class GameStrategyRep;
   friend class GameTreeInfosetRep;
   friend class GamePlayerRep;
   friend class GameTreeNodeRep;
@@ -657,10 +740,20 @@ class GameRep : public GameObject {
   template <class T> friend class MixedStrategyProfile;
   template <class T> friend class TableMixedStrategyProfileRep;
 
+private:
+  /// The number of changes made to the game
+  mutable unsigned long m_version;
+  /// Representations of the game derived by solvers, by type and key,
+  /// each with the version of the game it was derived from; the mutex
+  /// guards the map, as solvers on several threads may share the game
+  mutable std::map<std::pair<std::type_index, std::string>,
+		   std::pair<unsigned long, std::shared_ptr<void> > > m_representations;
+  mutable std::mutex m_representationsMutex;
+
 protected:
   std::string m_title, m_comment;
 
-  GameRep(void) { }
+  GameRep(void) : m_version(0) { }
 
   /// @name Managing the representation
   //@{
@@ -672,6 +765,11 @@ protected:
   virtual void BuildComputedValues(void) { }
   /// Have computed values been built?
   virtual bool HasComputedValues(void) const { return false; }
+  /// Clear out any summaries of the payoffs, as these have changed
+  virtual void ClearPayoffSummaries(void) const { }
+  /// Record a change to the game, so that any representations derived
+  /// from it are rebuilt
+  void IncrementVersion(void) const { m_version++; }
   //@}
 
 
@@ -713,6 +811,48 @@ public:
   virtual Rational GetMinPayoff(int pl = 0) const = 0;
   /// Returns the largest payoff in any outcome of the game
   virtual Rational GetMaxPayoff(int pl = 0) const = 0;
+  /// Returns the smallest and largest payoffs to player pl, or to all
+  /// players if pl is zero
+  virtual PayoffSummary GetPayoffSummary(int pl = 0) const;
+
+  /// Returns the number of changes made to the game.  This changes
+  /// whenever payoffs, outcomes, or the structure of the game do.
+  unsigned long GetVersion(void) const { return m_version; }
+  /// Returns the representation of type T of the game stored under
+  /// p_key, building it with p_build, which returns a new T, if there is
+  /// none as yet for the current version of the game.  This lets solvers
+  /// called many times on the same game convert it into their own form
+  /// only once.  It may be called from several threads at once; the
+  /// representation is built outside the lock, so two threads may both
+  /// build it, in which case the one stored first is returned to both.
+  template <class T, class F>
+  std::shared_ptr<T> GetRepresentation(const std::string &p_key, F p_build) const
+  {
+    std::pair<std::type_index, std::string> key(std::type_index(typeid(T)), p_key);
+    unsigned long version;
+    {
+      std::lock_guard<std::mutex> lock(m_representationsMutex);
+      version = m_version;
+      auto entry = m_representations.find(key);
+      if (entry != m_representations.end() && entry->second.first == version) {
+	return std::static_pointer_cast<T>(entry->second.second);
+      }
+    }
+    std::shared_ptr<T> rep(p_build());
+    std::lock_guard<std::mutex> lock(m_representationsMutex);
+    auto &entry = m_representations[key];
+    if (entry.second && entry.first == version) {
+      return std::static_pointer_cast<T>(entry.second);
+    }
+    entry = std::make_pair(version, std::shared_ptr<void>(rep));
+    return rep;
+  }
+  /// Discards the representations of the game derived by solvers
+  void ClearRepresentations(void) const
+  {
+    std::lock_guard<std::mutex> lock(m_representationsMutex);
+    m_representations.clear();
+  }
 
   /// Returns true if the game is perfect recall.  If not, the specified
   /// a pair of violating information sets is returned in the parameters.  
@@ -730,6 +870,8 @@ public:
   { throw UndefinedException(); }
   /// Write the game to a file in .nfg payoff format.
   virtual void WriteNfgFile(std::ostream &p_stream) const;
+  /// Write the game to a file in the binary .nfb format.
+  virtual void WriteNfbFile(std::ostream &p_stream) const;
   //@}
 
   /// @name Dimensions of the game
@@ -820,8 +962,6 @@ inline Game GameOutcomeRep::GetGame(void) const { return m_game; }
 inline GamePlayer GameStrategyRep::GetPlayer(void) const { return m_player; }
 
 inline Game GamePlayerRep::GetGame(void) const { return m_game; }
-inline int GamePlayerRep::NumStrategies(void) const 
-{ m_game->BuildComputedValues(); return m_strategies.Length(); }
 inline GameStrategy GamePlayerRep::GetStrategy(int st) const 
 { m_game->BuildComputedValues(); return m_strategies[st]; }
 inline const GameStrategyArray &GamePlayerRep::Strategies(void) const
@@ -839,8 +979,12 @@ template<> inline std::string PureBehaviorProfile::GetPayoff(int pl) const
 //=======================================================================
 
 
-/// Reads a game in .efg or .nfg format from the input stream
+/// Reads a game in .efg, .nfg or .nfb format from the input stream
 Game ReadGame(std::istream &);
+/// Reads a game in .efg, .nfg or .nfb format from the named file; the
+/// payoffs of an .nfb file are mapped into memory where the platform
+/// supports it
+Game ReadGame(const std::string &p_filename);
 
 } // end namespace gambit
 
@@ -201,6 +201,9 @@ void GameAggRep::Write(std::ostream &p_stream,
   else if (p_format == "nfg") {
     WriteNfgFile(p_stream);
   }
+  else if (p_format == "nfb") {
+    WriteNfbFile(p_stream);
+  }
   else {
     throw UndefinedException();
   }
@@ -0,0 +1,765 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2022, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/games/gamedouble.cc
+// Implementation of strategic game representation with a table of doubles
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif  // !_WIN32
+
+#include "gambit.h"
+#include "gamedouble.h"
+
+namespace Gambit {
+
+//========================================================================
+//                          The .nfb file format
+//========================================================================
+//
+// All integers are unsigned and little-endian.
+//
+//   8 bytes         magic number "\x89NFB\r\n\x1a\n"
+//   4 bytes         format version, currently 1
+//   4 bytes         payoff type: 0 for IEEE doubles, 1 for 64-bit integers
+//   4 bytes         number of players n
+//   4 bytes         reserved, zero
+//   4n bytes        number of strategies of each player
+//   strings         the title and comment of the game, then for each
+//                   player its label followed by the labels of its
+//                   strategies; each string is its length in 4 bytes
+//                   followed by its characters
+//   padding         zero bytes up to a multiple of 8 bytes from the start
+//   payoff block    8-byte payoffs, player by player; within each player,
+//                   the contingencies are in the order of the .nfg
+//                   payoff format, with player 1's strategy varying fastest
+//
+// The magic number starts with a byte that no text savefile starts with,
+// so that the format can be recognized from the first character.
+//
+
+namespace {
+
+const char NfbMagic[8] = { '\x89', 'N', 'F', 'B', '\r', '\n', '\x1a', '\n' };
+const unsigned int NfbVersion = 1;
+const unsigned int NfbDouble = 0, NfbInteger = 1;
+
+bool IsLittleEndian(void)
+{
+  const unsigned int one = 1;
+  return *reinterpret_cast<const unsigned char *>(&one) == 1;
+}
+
+unsigned int DecodeInt(const unsigned char *p_bytes)
+{
+  return ((unsigned int) p_bytes[0] | ((unsigned int) p_bytes[1] << 8) |
+	  ((unsigned int) p_bytes[2] << 16) | ((unsigned int) p_bytes[3] << 24));
+}
+
+unsigned long long DecodeLong(const unsigned char *p_bytes)
+{
+  unsigned long long value = 0;
+  for (int i = 7; i >= 0; i--) {
+    value = (value << 8) | p_bytes[i];
+  }
+  return value;
+}
+
+void EncodeLong(unsigned long long p_value, unsigned char *p_bytes)
+{
+  for (int i = 0; i < 8; i++) {
+    p_bytes[i] = (unsigned char) (p_value >> (8 * i));
+  }
+}
+
+/// Converts a payoff block as stored in the file into doubles.
+/// This is the identity on doubles on little-endian platforms,
+/// in which case the block is not touched.
+void DecodeBlock(const unsigned char *p_bytes, size_t p_length,
+		 unsigned int p_type, double *p_dest)
+{
+  if (p_type == NfbDouble && IsLittleEndian()) {
+    if (p_bytes != reinterpret_cast<const unsigned char *>(p_dest)) {
+      std::memcpy(p_dest, p_bytes, 8 * p_length);
+    }
+    return;
+  }
+  for (size_t i = 0; i < p_length; i++) {
+    unsigned long long bits = DecodeLong(p_bytes + 8 * i);
+    if (p_type == NfbDouble) {
+      std::memcpy(p_dest + i, &bits, 8);
+    }
+    else {
+      p_dest[i] = (double) (long long) bits;
+    }
+  }
+}
+
+/// The part of a .nfb file before the payoff block
+struct NfbHeader {
+  unsigned int m_payoffType;
+  Array<int> m_dim;
+  std::string m_title, m_comment;
+  Array<std::string> m_playerLabels;
+  Array<Array<std::string> > m_strategyLabels;
+  long m_numContingencies;
+  size_t m_length;
+};
+
+/// Reads the header from a stream
+class NfbStreamSource {
+private:
+  std::istream &m_file;
+  size_t m_position;
+
+public:
+  NfbStreamSource(std::istream &p_file) : m_file(p_file), m_position(0) { }
+
+  void Read(void *p_dest, size_t p_length)
+  {
+    m_file.read(static_cast<char *>(p_dest), p_length);
+    if (!m_file.good()) {
+      throw InvalidFileException("Unexpected end of .nfb file");
+    }
+    m_position += p_length;
+  }
+  size_t Position(void) const { return m_position; }
+};
+
+/// Reads the header from a file mapped into memory
+class NfbMemorySource {
+private:
+  const unsigned char *m_begin, *m_current, *m_end;
+
+public:
+  NfbMemorySource(const unsigned char *p_begin, size_t p_length)
+    : m_begin(p_begin), m_current(p_begin), m_end(p_begin + p_length) { }
+
+  void Read(void *p_dest, size_t p_length)
+  {
+    if (p_length > (size_t) (m_end - m_current)) {
+      throw InvalidFileException("Unexpected end of .nfb file");
+    }
+    std::memcpy(p_dest, m_current, p_length);
+    m_current += p_length;
+  }
+  size_t Position(void) const { return m_current - m_begin; }
+  size_t Remaining(void) const { return m_end - m_current; }
+};
+
+template <class Source> unsigned int ReadInt(Source &p_source)
+{
+  unsigned char bytes[4];
+  p_source.Read(bytes, 4);
+  return DecodeInt(bytes);
+}
+
+template <class Source> std::string ReadString(Source &p_source)
+{
+  unsigned int length = ReadInt(p_source);
+  if (length > (1u << 24)) {
+    throw InvalidFileException("Label too long in .nfb file");
+  }
+  std::string text(length, ' ');
+  if (length > 0) {
+    p_source.Read(&text[0], length);
+  }
+  return text;
+}
+
+template <class Source> void ReadNfbHeader(Source &p_source, NfbHeader &p_header)
+{
+  char magic[8];
+  p_source.Read(magic, 8);
+  if (std::memcmp(magic, NfbMagic, 8) != 0) {
+    throw InvalidFileException("Not a .nfb file");
+  }
+  if (ReadInt(p_source) != NfbVersion) {
+    throw InvalidFileException("Unsupported .nfb format version");
+  }
+  p_header.m_payoffType = ReadInt(p_source);
+  if (p_header.m_payoffType != NfbDouble && p_header.m_payoffType != NfbInteger) {
+    throw InvalidFileException("Unknown payoff type in .nfb file");
+  }
+  unsigned int numPlayers = ReadInt(p_source);
+  ReadInt(p_source);
+  if (numPlayers == 0 || numPlayers > (unsigned int) INT_MAX) {
+    throw InvalidFileException("Bad number of players in .nfb file");
+  }
+
+  p_header.m_dim = Array<int>(numPlayers);
+  p_header.m_numContingencies = 1;
+  for (unsigned int pl = 1; pl <= numPlayers; pl++) {
+    unsigned int numStrategies = ReadInt(p_source);
+    if (numStrategies == 0 || numStrategies > (unsigned int) INT_MAX ||
+	numStrategies > (unsigned long) LONG_MAX / p_header.m_numContingencies) {
+      throw InvalidFileException("Bad number of strategies in .nfb file");
+    }
+    p_header.m_dim[pl] = numStrategies;
+    p_header.m_numContingencies *= numStrategies;
+  }
+  if ((unsigned long) p_header.m_numContingencies >
+      (unsigned long) LONG_MAX / 8 / numPlayers) {
+    throw InvalidFileException("Game too large in .nfb file");
+  }
+  p_header.m_length = (size_t) p_header.m_numContingencies * numPlayers;
+
+  p_header.m_title = ReadString(p_source);
+  p_header.m_comment = ReadString(p_source);
+  p_header.m_playerLabels = Array<std::string>(numPlayers);
+  p_header.m_strategyLabels = Array<Array<std::string> >(numPlayers);
+  for (unsigned int pl = 1; pl <= numPlayers; pl++) {
+    p_header.m_playerLabels[pl] = ReadString(p_source);
+    p_header.m_strategyLabels[pl] = Array<std::string>(p_header.m_dim[pl]);
+    for (int st = 1; st <= p_header.m_dim[pl]; st++) {
+      p_header.m_strategyLabels[pl][st] = ReadString(p_source);
+    }
+  }
+
+  char padding[8];
+  p_source.Read(padding, (8 - p_source.Position() % 8) % 8);
+}
+
+void WriteInt(std::ostream &p_file, unsigned int p_value)
+{
+  unsigned char bytes[4];
+  for (int i = 0; i < 4; i++) {
+    bytes[i] = (unsigned char) (p_value >> (8 * i));
+  }
+  p_file.write(reinterpret_cast<char *>(bytes), 4);
+}
+
+void WriteString(std::ostream &p_file, const std::string &p_text)
+{
+  WriteInt(p_file, p_text.length());
+  p_file.write(p_text.data(), p_text.length());
+}
+
+} // end anonymous namespace
+
+void WriteNfbFile(std::ostream &p_file, const GameRep &p_game,
+		  const double *p_payoffs, bool p_integer)
+{
+  p_file.write(NfbMagic, 8);
+  WriteInt(p_file, NfbVersion);
+  WriteInt(p_file, (p_integer) ? NfbInteger : NfbDouble);
+  WriteInt(p_file, p_game.NumPlayers());
+  WriteInt(p_file, 0);
+  size_t position = 24;
+  size_t length = p_game.NumPlayers();
+  for (int pl = 1; pl <= p_game.NumPlayers(); pl++) {
+    WriteInt(p_file, p_game.GetPlayer(pl)->NumStrategies());
+    length *= p_game.GetPlayer(pl)->NumStrategies();
+    position += 4;
+  }
+
+  WriteString(p_file, p_game.GetTitle());
+  WriteString(p_file, p_game.GetComment());
+  position += 8 + p_game.GetTitle().length() + p_game.GetComment().length();
+  for (int pl = 1; pl <= p_game.NumPlayers(); pl++) {
+    GamePlayer player = p_game.GetPlayer(pl);
+    WriteString(p_file, player->GetLabel());
+    position += 4 + player->GetLabel().length();
+    for (int st = 1; st <= player->NumStrategies(); st++) {
+      WriteString(p_file, player->GetStrategy(st)->GetLabel());
+      position += 4 + player->GetStrategy(st)->GetLabel().length();
+    }
+  }
+  const char padding[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  p_file.write(padding, (8 - position % 8) % 8);
+
+  if (!p_integer && IsLittleEndian()) {
+    p_file.write(reinterpret_cast<const char *>(p_payoffs), 8 * length);
+    return;
+  }
+  const size_t chunk = 4096;
+  unsigned char bytes[8 * chunk];
+  for (size_t start = 0; start < length; start += chunk) {
+    size_t end = std::min(length, start + chunk);
+    for (size_t i = start; i < end; i++) {
+      unsigned long long bits;
+      if (p_integer) {
+	bits = (unsigned long long) (long long) p_payoffs[i];
+      }
+      else {
+	std::memcpy(&bits, p_payoffs + i, 8);
+      }
+      EncodeLong(bits, bytes + 8 * (i - start));
+    }
+    p_file.write(reinterpret_cast<char *>(bytes), 8 * (end - start));
+  }
+}
+
+//========================================================================
+//               class DoubleTablePureStrategyProfileRep
+//========================================================================
+
+class DoubleTablePureStrategyProfileRep : public PureStrategyProfileRep {
+protected:
+  long m_index;
+
+  virtual PureStrategyProfileRep *Copy(void) const
+  { return new DoubleTablePureStrategyProfileRep(*this); }
+
+public:
+  DoubleTablePureStrategyProfileRep(const Game &p_game)
+    : PureStrategyProfileRep(p_game), m_index(0L) { }
+  virtual long GetIndex(void) const { return m_index + 1; }
+  virtual void SetStrategy(const GameStrategy &);
+  virtual GameOutcome GetOutcome(void) const { throw UndefinedException(); }
+  virtual void SetOutcome(GameOutcome p_outcome)
+  { throw UndefinedException(); }
+  virtual Rational GetPayoff(int pl) const;
+  virtual Rational GetStrategyValue(const GameStrategy &) const;
+};
+
+//------------------------------------------------------------------------
+//     DoubleTablePureStrategyProfileRep: Data access and manipulation
+//------------------------------------------------------------------------
+
+void DoubleTablePureStrategyProfileRep::SetStrategy(const GameStrategy &s)
+{
+  m_index += s->m_offset - m_profile[s->GetPlayer()->GetNumber()]->m_offset;
+  m_profile[s->GetPlayer()->GetNumber()] = s;
+}
+
+Rational DoubleTablePureStrategyProfileRep::GetPayoff(int pl) const
+{
+  return dynamic_cast<GameDoubleTableRep &>(*m_nfg).GetPayoff(pl, m_index);
+}
+
+Rational
+DoubleTablePureStrategyProfileRep::GetStrategyValue(const GameStrategy &p_strategy) const
+{
+  int player = p_strategy->GetPlayer()->GetNumber();
+  return dynamic_cast<GameDoubleTableRep &>(*m_nfg).GetPayoff(player, m_index - m_profile[player]->m_offset + p_strategy->m_offset);
+}
+
+//========================================================================
+//                        class GameDoubleTableRep
+//========================================================================
+
+//------------------------------------------------------------------------
+//                    GameDoubleTableRep: Lifecycle
+//------------------------------------------------------------------------
+
+GameDoubleTableRep::GameDoubleTableRep(const Array<int> &p_dim)
+  : GameDoubleTableRep(p_dim, true)
+{ }
+
+GameDoubleTableRep::GameDoubleTableRep(const Array<int> &p_dim, bool p_allocate)
+  : m_numContingencies(1L), m_payoffs(0), m_mapping(0), m_mappingLength(0)
+{
+  for (int pl = 1; pl <= p_dim.Length(); pl++) {
+    // The payoff block, of 8 * players * contingencies bytes, must be
+    // addressable with a long
+    if (p_dim[pl] <= 0 ||
+	m_numContingencies > LONG_MAX / 8 / p_dim.Length() / p_dim[pl]) {
+      throw UndefinedException("Too many strategy contingencies for a table of doubles");
+    }
+    m_numContingencies *= p_dim[pl];
+  }
+  for (int pl = 1; pl <= p_dim.Length(); pl++) {
+    m_players.Append(new GamePlayerRep(this, pl, p_dim[pl]));
+    m_players[pl]->m_label = lexical_cast<std::string>(pl);
+    for (int st = 1; st <= m_players[pl]->NumStrategies(); st++) {
+      m_players[pl]->m_strategies[st]->SetLabel(lexical_cast<std::string>(st));
+    }
+  }
+  IndexStrategies();
+  if (p_allocate) {
+    m_storage.assign(m_numContingencies * m_players.Length(), 0.0);
+    m_payoffs = &m_storage[0];
+    ComputePayoffRange();
+  }
+}
+
+GameDoubleTableRep::~GameDoubleTableRep()
+{
+  for (int pl = 1; pl <= m_players.Length(); m_players[pl++]->Invalidate());
+#if !defined(_WIN32)
+  if (m_mapping) {
+    munmap(m_mapping, m_mappingLength);
+  }
+#endif  // !_WIN32
+}
+
+Game NewDoubleTable(const Array<int> &p_dim)
+{
+  return new GameDoubleTableRep(p_dim);
+}
+
+Game GameDoubleTableRep::Copy(void) const
+{
+  GameDoubleTableRep *game = new GameDoubleTableRep(NumStrategies());
+  game->m_title = m_title;
+  game->m_comment = m_comment;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    game->m_players[pl]->m_label = m_players[pl]->m_label;
+    for (int st = 1; st <= m_players[pl]->m_strategies.Length(); st++) {
+      game->m_players[pl]->m_strategies[st]->SetLabel(m_players[pl]->m_strategies[st]->GetLabel());
+    }
+  }
+  std::copy(m_payoffs, m_payoffs + game->m_storage.size(), game->m_payoffs);
+  game->m_minPayoffs = m_minPayoffs;
+  game->m_maxPayoffs = m_maxPayoffs;
+  game->m_numMinPayoffs = m_numMinPayoffs;
+  game->m_numMaxPayoffs = m_numMaxPayoffs;
+  return game;
+}
+
+namespace {
+
+/// Sets the title, comment and labels of a game read from a file
+void SetLabels(GameDoubleTableRep *game, const NfbHeader &p_header)
+{
+  game->SetTitle(p_header.m_title);
+  game->SetComment(p_header.m_comment);
+  for (int pl = 1; pl <= p_header.m_dim.Length(); pl++) {
+    GamePlayer player = game->GetPlayer(pl);
+    player->SetLabel(p_header.m_playerLabels[pl]);
+    for (int st = 1; st <= p_header.m_dim[pl]; st++) {
+      player->GetStrategy(st)->SetLabel(p_header.m_strategyLabels[pl][st]);
+    }
+  }
+}
+
+}  // end anonymous namespace
+
+Game GameDoubleTableRep::ReadNfbFile(std::istream &p_file)
+{
+  NfbStreamSource source(p_file);
+  NfbHeader header;
+  ReadNfbHeader(source, header);
+  GameDoubleTableRep *game = new GameDoubleTableRep(header.m_dim, true);
+  Game handle(game);
+  SetLabels(game, header);
+  p_file.read(reinterpret_cast<char *>(game->m_payoffs), 8 * header.m_length);
+  if ((size_t) p_file.gcount() != 8 * header.m_length) {
+    throw InvalidFileException("Unexpected end of .nfb file");
+  }
+  DecodeBlock(reinterpret_cast<unsigned char *>(game->m_payoffs),
+	      header.m_length, header.m_payoffType, game->m_payoffs);
+  game->ComputePayoffRange();
+  return handle;
+}
+
+#if defined(_WIN32)
+
+Game GameDoubleTableRep::ReadNfbFile(const std::string &p_filename)
+{
+  std::ifstream file(p_filename.c_str(), std::ios::in | std::ios::binary);
+  if (!file.good()) {
+    throw InvalidFileException("Unable to open " + p_filename);
+  }
+  return ReadNfbFile(file);
+}
+
+#else
+
+Game GameDoubleTableRep::ReadNfbFile(const std::string &p_filename)
+{
+  int fd = open(p_filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw InvalidFileException("Unable to open " + p_filename);
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size == 0) {
+    close(fd);
+    throw InvalidFileException("Unable to read " + p_filename);
+  }
+  size_t length = info.st_size;
+  // The mapping is private, so that setting payoffs does not write
+  // through to the file
+  void *mapping = mmap(0, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    std::ifstream file(p_filename.c_str(), std::ios::in | std::ios::binary);
+    return ReadNfbFile(file);
+  }
+
+  try {
+    const unsigned char *bytes = static_cast<const unsigned char *>(mapping);
+    NfbMemorySource source(bytes, length);
+    NfbHeader header;
+    ReadNfbHeader(source, header);
+    if (source.Remaining() < 8 * header.m_length) {
+      throw InvalidFileException("Unexpected end of .nfb file");
+    }
+    // The payoffs are used in place if they are stored as native doubles
+    bool inPlace = (header.m_payoffType == NfbDouble && IsLittleEndian());
+    GameDoubleTableRep *game = new GameDoubleTableRep(header.m_dim, !inPlace);
+    Game handle(game);
+    SetLabels(game, header);
+    double *block = reinterpret_cast<double *>(const_cast<unsigned char *>(bytes) + source.Position());
+    if (inPlace) {
+      game->m_payoffs = block;
+      game->m_mapping = mapping;
+      game->m_mappingLength = length;
+    }
+    else {
+      DecodeBlock(reinterpret_cast<unsigned char *>(block), header.m_length,
+		  header.m_payoffType, game->m_payoffs);
+      munmap(mapping, length);
+    }
+    game->ComputePayoffRange();
+    return handle;
+  }
+  catch (...) {
+    munmap(mapping, length);
+    throw;
+  }
+}
+
+#endif  // _WIN32
+
+//------------------------------------------------------------------------
+//                GameDoubleTableRep: Dimensions of the game
+//------------------------------------------------------------------------
+
+Array<int> GameDoubleTableRep::NumStrategies(void) const
+{
+  Array<int> ns;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    ns.Append(m_players[pl]->m_strategies.Length());
+  }
+  return ns;
+}
+
+GameStrategy GameDoubleTableRep::GetStrategy(int p_index) const
+{
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    if (m_players[pl]->m_strategies.Length() >= p_index) {
+      return m_players[pl]->m_strategies[p_index];
+    }
+    else {
+      p_index -= m_players[pl]->m_strategies.Length();
+    }
+  }
+  throw IndexException();
+}
+
+int GameDoubleTableRep::NumStrategyContingencies(void) const
+{
+  if (m_numContingencies > INT_MAX) {
+    throw UndefinedException("Too many strategy contingencies to count with an int");
+  }
+  return m_numContingencies;
+}
+
+int GameDoubleTableRep::MixedProfileLength(void) const
+{
+  int length = 0;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    length += m_players[pl]->m_strategies.Length();
+  }
+  return length;
+}
+
+//------------------------------------------------------------------------
+//                 GameDoubleTableRep: Factory functions
+//------------------------------------------------------------------------
+
+PureStrategyProfile GameDoubleTableRep::NewPureStrategyProfile(void) const
+{
+  return PureStrategyProfile(new DoubleTablePureStrategyProfileRep(const_cast<GameDoubleTableRep *>(this)));
+}
+
+MixedStrategyProfile<double> GameDoubleTableRep::NewMixedStrategyProfile(double) const
+{
+  return new DoubleTableMixedStrategyProfileRep<double>(StrategySupportProfile(const_cast<GameDoubleTableRep *>(this)));
+}
+
+MixedStrategyProfile<Rational> GameDoubleTableRep::NewMixedStrategyProfile(const Rational &) const
+{
+  return new DoubleTableMixedStrategyProfileRep<Rational>(StrategySupportProfile(const_cast<GameDoubleTableRep *>(this)));
+}
+
+MixedStrategyProfile<double> GameDoubleTableRep::NewMixedStrategyProfile(double, const StrategySupportProfile &spt) const
+{
+  return new DoubleTableMixedStrategyProfileRep<double>(spt);
+}
+
+MixedStrategyProfile<Rational> GameDoubleTableRep::NewMixedStrategyProfile(const Rational &, const StrategySupportProfile &spt) const
+{
+  return new DoubleTableMixedStrategyProfileRep<Rational>(spt);
+}
+
+//------------------------------------------------------------------------
+//                GameDoubleTableRep: General data access
+//------------------------------------------------------------------------
+
+bool GameDoubleTableRep::IsConstSum(void) const
+{
+  double sum = 0.0;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    sum += GetPayoff(pl, 0);
+  }
+  for (long index = 1; index < m_numContingencies; index++) {
+    double newsum = 0.0;
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      newsum += GetPayoff(pl, index);
+    }
+    if (newsum != sum) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void GameDoubleTableRep::ComputePayoffRange(void)
+{
+  m_minPayoffs = Array<double>(m_players.Length());
+  m_maxPayoffs = Array<double>(m_players.Length());
+  m_numMinPayoffs = Array<long>(m_players.Length());
+  m_numMaxPayoffs = Array<long>(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    ComputePayoffRange(pl);
+  }
+}
+
+void GameDoubleTableRep::ComputePayoffRange(int pl)
+{
+  const double *payoffs = m_payoffs + (pl - 1) * m_numContingencies;
+  m_minPayoffs[pl] = m_maxPayoffs[pl] = payoffs[0];
+  m_numMinPayoffs[pl] = m_numMaxPayoffs[pl] = 1;
+  for (long index = 1; index < m_numContingencies; index++) {
+    if (payoffs[index] < m_minPayoffs[pl]) {
+      m_minPayoffs[pl] = payoffs[index];
+      m_numMinPayoffs[pl] = 1;
+    }
+    else if (payoffs[index] == m_minPayoffs[pl]) {
+      m_numMinPayoffs[pl]++;
+    }
+    if (payoffs[index] > m_maxPayoffs[pl]) {
+      m_maxPayoffs[pl] = payoffs[index];
+      m_numMaxPayoffs[pl] = 1;
+    }
+    else if (payoffs[index] == m_maxPayoffs[pl]) {
+      m_numMaxPayoffs[pl]++;
+    }
+  }
+}
+
+void GameDoubleTableRep::SetPayoff(int pl, long p_index, double p_value)
+{
+  double &payoff = m_payoffs[(pl - 1) * m_numContingencies + p_index];
+  double old = payoff;
+  payoff = p_value;
+  // The range is only scanned again when the last payoff attaining the
+  // minimum or the maximum is overwritten
+  if ((old == m_minPayoffs[pl] && --m_numMinPayoffs[pl] == 0) ||
+      (old == m_maxPayoffs[pl] && --m_numMaxPayoffs[pl] == 0)) {
+    ComputePayoffRange(pl);
+  }
+  else {
+    if (p_value < m_minPayoffs[pl]) {
+      m_minPayoffs[pl] = p_value;
+      m_numMinPayoffs[pl] = 1;
+    }
+    else if (p_value == m_minPayoffs[pl]) {
+      m_numMinPayoffs[pl]++;
+    }
+    if (p_value > m_maxPayoffs[pl]) {
+      m_maxPayoffs[pl] = p_value;
+      m_numMaxPayoffs[pl] = 1;
+    }
+    else if (p_value == m_maxPayoffs[pl]) {
+      m_numMaxPayoffs[pl]++;
+    }
+  }
+  IncrementVersion();
+}
+
+PayoffSummary GameDoubleTableRep::GetPayoffSummary(int pl) const
+{
+  double minimum = m_minPayoffs[(pl) ? pl : 1];
+  double maximum = m_maxPayoffs[(pl) ? pl : 1];
+  if (!pl) {
+    for (int p = 2; p <= m_players.Length(); p++) {
+      minimum = std::min(minimum, m_minPayoffs[p]);
+      maximum = std::max(maximum, m_maxPayoffs[p]);
+    }
+  }
+  return PayoffSummary(minimum, minimum, maximum, maximum);
+}
+
+Rational GameDoubleTableRep::GetMinPayoff(int pl) const
+{
+  return GetPayoffSummary(pl).GetMin<Rational>();
+}
+
+Rational GameDoubleTableRep::GetMaxPayoff(int pl) const
+{
+  return GetPayoffSummary(pl).GetMax<Rational>();
+}
+
+//------------------------------------------------------------------------
+//                GameDoubleTableRep: Writing data files
+//------------------------------------------------------------------------
+
+void GameDoubleTableRep::Write(std::ostream &p_stream,
+			       const std::string &p_format /*="native"*/) const
+{
+  if (p_format == "native" || p_format == "nfb") {
+    WriteNfbFile(p_stream);
+  }
+  else if (p_format == "nfg") {
+    WriteNfgFile(p_stream);
+  }
+  else {
+    throw UndefinedException();
+  }
+}
+
+void GameDoubleTableRep::WriteNfbFile(std::ostream &p_file) const
+{
+  Gambit::WriteNfbFile(p_file, *this, m_payoffs, false);
+}
+
+//------------------------------------------------------------------------
+//            GameDoubleTableRep: Private auxiliary functions
+//------------------------------------------------------------------------
+
+void GameDoubleTableRep::IndexStrategies(void)
+{
+  long offset = 1L;
+  int id = 1;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    for (int st = 1; st <= m_players[pl]->m_strategies.Length(); st++) {
+      GameStrategyRep *strategy = m_players[pl]->m_strategies[st];
+      strategy->m_number = st;
+      strategy->m_offset = (st - 1) * offset;
+      strategy->m_id = id++;
+    }
+    offset *= m_players[pl]->m_strategies.Length();
+  }
+}
+
+}  // end namespace Gambit
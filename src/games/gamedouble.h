@@ -0,0 +1,217 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2022, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/games/gamedouble.h
+// Declaration of strategic game representation with a table of doubles
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef GAMEDOUBLE_H
+#define GAMEDOUBLE_H
+
+#include <vector>
+
+namespace Gambit {
+
+///
+/// A strategic game whose payoffs are held directly in one block of
+/// doubles, without outcomes.  This is the representation into which
+/// games in the binary .nfb format are read; the block is then either
+/// mapped from the file or read into memory in a single pass, with no
+/// parsing of the payoffs.
+///
+/// The block holds the payoffs player by player.  Within each player,
+/// the contingencies are in the order of the .nfg payoff format, with
+/// the strategy of player 1 varying fastest.
+///
+class GameDoubleTableRep : public GameRep {
+  template <class T> friend class MixedStrategyProfile;
+  template <class T> friend class DoubleTableMixedStrategyProfileRep;
+  friend class DoubleTablePureStrategyProfileRep;
+
+private:
+  Array<GamePlayerRep *> m_players;
+  long m_numContingencies;
+  /// The payoff block; either points into m_storage or into m_mapping
+  double *m_payoffs;
+  std::vector<double> m_storage;
+  /// The region of the file mapped into memory, if any
+  void *m_mapping;
+  size_t m_mappingLength;
+  /// Smallest and largest payoff of each player, computed when the
+  /// payoffs are loaded and kept up to date by SetPayoff(), together
+  /// with the number of contingencies at which each is attained
+  Array<double> m_minPayoffs, m_maxPayoffs;
+  Array<long> m_numMinPayoffs, m_numMaxPayoffs;
+
+  /// Construct the players of a game with the given dimension; the
+  /// payoffs are allocated, all zero, only if p_allocate is true
+  GameDoubleTableRep(const Array<int> &p_dim, bool p_allocate);
+
+  /// @name Private auxiliary functions
+  //@{
+  void IndexStrategies(void);
+  void ComputePayoffRange(void);
+  void ComputePayoffRange(int pl);
+  //@}
+
+public:
+  /// @name Lifecycle
+  //@{
+  /// Construct a new game with the given dimension and all payoffs zero
+  GameDoubleTableRep(const Array<int> &p_dim);
+  /// Create a game from a file in .nfb format on an input stream
+  static Game ReadNfbFile(std::istream &);
+  /// Create a game from the named file in .nfb format.  Where the
+  /// platform supports it, the payoff block is mapped into memory
+  /// directly from the file, copy-on-write.
+  static Game ReadNfbFile(const std::string &p_filename);
+  /// Destructor
+  virtual ~GameDoubleTableRep();
+  /// Create a copy of the game, as a new game
+  virtual Game Copy(void) const;
+  //@}
+
+  /// @name Payoffs
+  //@{
+  /// Returns the payoff to player pl at the contingency with the
+  /// given (zero-based) index
+  double GetPayoff(int pl, long p_index) const
+  { return m_payoffs[(pl - 1) * m_numContingencies + p_index]; }
+  /// Returns the payoffs to player pl at all contingencies, in the
+  /// order of the .nfg payoff format
+  const double *GetPayoffs(int pl) const
+  { return m_payoffs + (pl - 1) * m_numContingencies; }
+  /// Sets the payoff to player pl at the contingency with the
+  /// given (zero-based) index
+  void SetPayoff(int pl, long p_index, double p_value);
+  //@}
+
+  /// @name Dimensions of the game
+  //@{
+  /// The number of actions in each information set
+  virtual PVector<int> NumActions(void) const { throw UndefinedException(); }
+  /// The number of members in each information set
+  virtual PVector<int> NumMembers(void) const { throw UndefinedException(); }
+  /// The number of strategies for each player
+  virtual Array<int> NumStrategies(void) const;
+  /// Gets the i'th strategy in the game, numbered globally
+  virtual GameStrategy GetStrategy(int p_index) const;
+  /// Returns the total number of actions in the game
+  virtual int BehavProfileLength(void) const  { throw UndefinedException(); }
+  /// Returns the total number of strategies in the game
+  virtual int MixedProfileLength(void) const;
+  /// Returns the number of strategy contingencies in the game; throws
+  /// if there are more than an int can hold
+  virtual int NumStrategyContingencies(void) const;
+  /// Returns the number of strategy contingencies in the game, which
+  /// may be more than NumStrategyContingencies() can return
+  long NumContingencies(void) const { return m_numContingencies; }
+  //@}
+
+  virtual PureStrategyProfile NewPureStrategyProfile(void) const;
+  virtual MixedStrategyProfile<double> NewMixedStrategyProfile(double) const;
+  virtual MixedStrategyProfile<Rational> NewMixedStrategyProfile(const Rational &) const;
+  virtual MixedStrategyProfile<double> NewMixedStrategyProfile(double, const StrategySupportProfile &) const;
+  virtual MixedStrategyProfile<Rational> NewMixedStrategyProfile(const Rational &, const StrategySupportProfile &) const;
+
+  /// @name Players
+  //@{
+  /// Returns the number of players in the game
+  virtual int NumPlayers(void) const { return m_players.Length(); }
+  /// Returns the pl'th player in the game
+  virtual GamePlayer GetPlayer(int pl) const { return m_players[pl]; }
+  /// Returns the set of players in the game
+  virtual const GamePlayers &Players(void) const { return m_players; }
+  /// Returns the chance (nature) player
+  virtual GamePlayer GetChance(void) const  { throw UndefinedException(); }
+  /// Creates a new player in the game, with no moves
+  virtual GamePlayer NewPlayer(void)    { throw UndefinedException(); }
+  //@}
+
+  /// @name Information sets
+  //@{
+  /// Returns the iset'th information set in the game (numbered globally)
+  virtual GameInfoset GetInfoset(int iset) const
+  { throw UndefinedException(); }
+  /// Returns an array with the number of information sets per personal player
+  virtual Array<int> NumInfosets(void) const
+  { throw UndefinedException(); }
+  /// Returns the act'th action in the game (numbered globally)
+  virtual GameAction GetAction(int act) const
+  { throw UndefinedException(); }
+  //@}
+
+  /// @name Outcomes
+  //@{
+  /// Returns the number of outcomes defined in the game
+  virtual int NumOutcomes(void) const  { throw UndefinedException(); }
+  /// Returns the index'th outcome defined in the game
+  virtual GameOutcome GetOutcome(int index) const
+  { throw UndefinedException(); }
+  /// Creates a new outcome in the game
+  virtual GameOutcome NewOutcome(void)  { throw UndefinedException(); }
+  /// Deletes the specified outcome from the game
+  virtual void DeleteOutcome(const GameOutcome &)
+  { throw UndefinedException(); }
+  //@}
+
+  /// @name Nodes
+  //@{
+  /// Returns the root node of the game
+  virtual GameNode GetRoot(void) const   { throw UndefinedException(); }
+  /// Returns the number of nodes in the game
+  virtual int NumNodes(void) const   { throw UndefinedException(); }
+  //@}
+
+  /// @name General data access
+  //@{
+  virtual bool IsTree(void) const { return false; }
+  virtual bool IsPerfectRecall(GameInfoset &, GameInfoset &) const
+  { return true; }
+  virtual bool IsConstSum(void) const;
+  /// Returns the smallest payoff in any outcome of the game
+  virtual Rational GetMinPayoff(int pl = 0) const;
+  /// Returns the largest payoff in any outcome of the game
+  virtual Rational GetMaxPayoff(int pl = 0) const;
+  /// Returns the smallest and largest payoffs to player pl, or to all
+  /// players if pl is zero
+  virtual PayoffSummary GetPayoffSummary(int pl = 0) const;
+  //@}
+
+  /// @name Writing data files
+  //@{
+  /// Write the game to a savefile in the specified format.
+  virtual void Write(std::ostream &p_stream,
+		     const std::string &p_format="native") const;
+  /// Write the game to a file in .nfb format
+  virtual void WriteNfbFile(std::ostream &) const;
+  //@}
+};
+
+/// Factory function to create a new game table with payoffs held as doubles
+Game NewDoubleTable(const Array<int> &p_dim);
+
+/// Write a game to a file in .nfb format, given its payoffs in the order
+/// of the payoff block.  If p_integer is true, the payoffs must all be
+/// integers, and are written as 64-bit integers.
+void WriteNfbFile(std::ostream &, const GameRep &, const double *p_payoffs,
+		  bool p_integer);
+
+}  // end namespace Gambit
+
+#endif  // GAMEDOUBLE_H
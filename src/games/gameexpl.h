@@ -32,6 +32,16 @@ class GameExplicitRep : public GameRep {
 protected:
   Array<GamePlayerRep *> m_players;
   Array<GameOutcomeRep *> m_outcomes;
+  /// Summaries of the payoffs of all players (at index 0) and of each
+  /// player, computed on first use
+  mutable Array<PayoffSummary> m_payoffSummaries;
+
+  /// @name Managing the representation
+  //@{
+  virtual void ClearPayoffSummaries(void) const
+  { m_payoffSummaries = Array<PayoffSummary>();  IncrementVersion(); }
+  const PayoffSummary &GetCachedPayoffSummary(int pl) const;
+  //@}
 
   /// @name Writing data files
   //@{
@@ -56,6 +66,10 @@ public:
   virtual Rational GetMinPayoff(int pl = 0) const;
   /// Returns the largest payoff in any outcome of the game
   virtual Rational GetMaxPayoff(int pl = 0) const;
+  /// Returns the smallest and largest payoffs to player pl, or to all
+  /// players if pl is zero
+  virtual PayoffSummary GetPayoffSummary(int pl = 0) const
+  { return GetCachedPayoffSummary(pl); }
   //@}
 
   /// @name Dimensions of the game
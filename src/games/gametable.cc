@@ -22,9 +22,14 @@
 
 #include <iostream>
 #include <sstream>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cmath>
 
 #include "gambit.h"
 #include "gametable.h"
+#include "gamedouble.h"
 
 namespace Gambit {
 
@@ -87,7 +92,9 @@ GameOutcome TablePureStrategyProfileRep::GetOutcome(void) const
 
 void TablePureStrategyProfileRep::SetOutcome(GameOutcome p_outcome)
 {
-  dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index] = p_outcome; 
+  GameTableRep &table = dynamic_cast<GameTableRep &>(*m_nfg);
+  table.m_results[m_index] = p_outcome;
+  table.IncrementVersion();
 }
 
 Rational TablePureStrategyProfileRep::GetPayoff(int pl) const
@@ -185,11 +192,11 @@ bool GameTableRep::IsConstSum(void) const
     sum += profile.GetPayoff(pl);
   }
 
-  for (StrategyProfileIterator iter(StrategySupportProfile(const_cast<GameTableRep *>(this)));
+  for (TableContingencyIterator iter(StrategySupportProfile(const_cast<GameTableRep *>(this)));
        !iter.AtEnd(); iter++) {
     Rational newsum(0);
     for (int pl = 1; pl <= m_players.Length(); pl++) {
-      newsum += (*iter)->GetPayoff(pl);
+      newsum += iter.GetPayoff<Rational>(pl);
     }
     
     if (newsum != sum) {
@@ -284,6 +291,35 @@ void GameTableRep::WriteNfgFile(std::ostream &p_file) const
   p_file << '\n';
 }
 
+///
+/// This overrides the .nfb writing in the base GameRep class, reading
+/// the payoffs off the table of outcomes rather than through pure
+/// strategy profiles.
+///
+void GameTableRep::WriteNfbFile(std::ostream &p_file) const
+{
+  long ncont = m_results.Length();
+  std::vector<double> payoffs(ncont * m_players.Length(), 0.0);
+  const Rational largest(9007199254740992.0);   // 2^53
+  bool integer = true;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
+      const Rational &payoff = m_outcomes[outc]->GetPayoff<Rational>(pl);
+      if (payoff.denominator() != 1 || abs(payoff) > largest) {
+	integer = false;
+	break;
+      }
+    }
+    double *block = &payoffs[(pl - 1) * ncont];
+    for (long cont = 1; cont <= ncont; cont++) {
+      if (m_results[cont]) {
+	block[cont - 1] = m_results[cont]->GetPayoff<double>(pl);
+      }
+    }
+  }
+  Gambit::WriteNfbFile(p_file, *this, &payoffs[0], integer);
+}
+
 //------------------------------------------------------------------------
 //                       GameTableRep: Players
 //------------------------------------------------------------------------
@@ -296,6 +332,7 @@ GamePlayer GameTableRep::NewPlayer(void)
   for (int outc = 1; outc <= m_outcomes.Last(); outc++) {
     m_outcomes[outc]->m_payoffs.Append(Number());
   }
+  ClearPayoffSummaries();
   ClearComputedValues();
   return player;
 }
@@ -315,9 +352,109 @@ void GameTableRep::DeleteOutcome(const GameOutcome &p_outcome)
   for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
     m_outcomes[outc]->m_number = outc;
   }
+  ClearPayoffSummaries();
   ClearComputedValues();
 }
 
+//------------------------------------------------------------------------
+//                   GameTableRep: Setting payoffs in bulk
+//------------------------------------------------------------------------
+
+namespace {
+
+/// The number of contingencies below which filling outcomes on
+/// another thread does not pay for starting it
+const long MinContingenciesPerThread = 16384;
+
+/// Payoffs which cannot be represented as a Number
+inline bool IsValidPayoff(double x) { return std::isfinite(x); }
+inline bool IsValidPayoff(long long) { return true; }
+
+} // end anonymous namespace
+
+///
+/// Sets the payoffs of players p_firstPlayer to p_lastPlayer, listed
+/// contingency by contingency.  The contingencies are divided into
+/// consecutive chunks, each filled on its own thread; this is safe as
+/// every contingency has its own outcome.
+///
+template <class T>
+void GameTableRep::FillPayoffs(int p_firstPlayer, int p_lastPlayer,
+			       const T *p_payoffs, long p_length)
+{
+  long numContingencies = m_results.Length();
+  int stride = p_lastPlayer - p_firstPlayer + 1;
+  if (p_length != numContingencies * stride) {
+    throw DimensionException();
+  }
+  // Check before starting, as exceptions cannot leave the threads
+  for (long i = 0; i < p_length; i++) {
+    if (!IsValidPayoff(p_payoffs[i])) {
+      throw ValueException();
+    }
+  }
+  SeparateOutcomes();
+
+  GameOutcomeRep **results = &m_results[1];
+  auto fill = [=](long p_begin, long p_end) {
+    const T *payoff = p_payoffs + p_begin * stride;
+    for (long cont = p_begin; cont < p_end; cont++) {
+      Array<Number> &payoffs = results[cont]->m_payoffs;
+      for (int pl = p_firstPlayer; pl <= p_lastPlayer; pl++) {
+	payoffs[pl] = Number(*payoff++);
+      }
+    }
+  };
+
+  long numThreads = GetNumThreads();
+  numThreads = std::min(numThreads,
+			numContingencies / MinContingenciesPerThread);
+  if (numThreads <= 1) {
+    fill(0, numContingencies);
+  }
+  else {
+    std::vector<std::thread> threads;
+    long chunk = (numContingencies + numThreads - 1) / numThreads;
+    for (long begin = chunk; begin < numContingencies; begin += chunk) {
+      threads.push_back(std::thread(fill, begin,
+				    std::min(begin + chunk, numContingencies)));
+    }
+    fill(0, chunk);
+    for (size_t i = 0; i < threads.size(); i++) {
+      threads[i].join();
+    }
+  }
+  ClearPayoffSummaries();
+  ClearComputedValues();
+}
+
+void GameTableRep::SetPayoffs(const double *p_payoffs, long p_length)
+{
+  FillPayoffs(1, m_players.Length(), p_payoffs, p_length);
+}
+
+void GameTableRep::SetPayoffs(const long long *p_payoffs, long p_length)
+{
+  FillPayoffs(1, m_players.Length(), p_payoffs, p_length);
+}
+
+void GameTableRep::SetPayoffs(int pl, const double *p_payoffs, long p_length)
+{
+  if (pl < 1 || pl > m_players.Length()) {
+    throw IndexException();
+  }
+  FillPayoffs(pl, pl, p_payoffs, p_length);
+}
+
+void GameTableRep::SetPayoffs(int pl, const long long *p_payoffs,
+			      long p_length)
+{
+  if (pl < 1 || pl > m_players.Length()) {
+    throw IndexException();
+  }
+  FillPayoffs(pl, pl, p_payoffs, p_length);
+}
+
 //------------------------------------------------------------------------
 //                   GameTableRep: Factory functions
 //------------------------------------------------------------------------
@@ -382,6 +519,31 @@ void GameTableRep::RebuildTable(void)
   m_results = newResults;
 
   IndexStrategies();
+  IncrementVersion();
+}
+
+/// This gives each contingency an outcome of its own.  A contingency
+/// with no outcome gets a new outcome with zero payoffs; where several
+/// contingencies share an outcome, all but the first get a new copy of it.
+void GameTableRep::SeparateOutcomes(void)
+{
+  Array<bool> used(m_outcomes.Length());
+  for (int outc = 1; outc <= used.Length(); used[outc++] = false);
+
+  for (int cont = 1; cont <= m_results.Length(); cont++) {
+    GameOutcomeRep *outcome = m_results[cont];
+    if (outcome && !used[outcome->m_number]) {
+      used[outcome->m_number] = true;
+      continue;
+    }
+    GameOutcomeRep *separate = new GameOutcomeRep(this,
+						  m_outcomes.Length() + 1);
+    if (outcome) {
+      separate->m_payoffs = outcome->m_payoffs;
+    }
+    m_outcomes.Append(separate);
+    m_results[cont] = separate;
+  }
 }
 
 void GameTableRep::IndexStrategies(void)
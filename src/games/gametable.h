@@ -32,6 +32,7 @@ class GameTableRep : public GameExplicitRep {
   friend class GamePlayerRep;
   friend class TablePureStrategyProfileRep;
   friend class PureStrategyProfileRep;
+  friend class TableContingencyIterator;
   template <class T> friend class MixedStrategyProfile;
   template <class T> friend class TableMixedStrategyProfileRep;
 private:
@@ -42,6 +43,10 @@ private:
   //@{
   void IndexStrategies(void);
   void RebuildTable(void);
+  void SeparateOutcomes(void);
+  template <class T>
+  void FillPayoffs(int p_firstPlayer, int p_lastPlayer,
+		   const T *p_payoffs, long p_length);
   //@}
 
 public:
@@ -116,10 +121,27 @@ public:
   virtual void DeleteOutcome(const GameOutcome &);
   //@}
 
+  /// @name Setting payoffs in bulk
+  //@{
+  /// Sets the payoffs of all players at all contingencies.  The payoffs
+  /// are listed contingency by contingency, in the order of the .nfg
+  /// payoff format, and within each contingency player by player.
+  /// Each contingency is given an outcome of its own, if it does not
+  /// have one already, and the outcomes are filled in parallel.
+  void SetPayoffs(const double *p_payoffs, long p_length);
+  void SetPayoffs(const long long *p_payoffs, long p_length);
+  /// Sets the payoffs of player pl at all contingencies, listed in
+  /// the order of the .nfg payoff format
+  void SetPayoffs(int pl, const double *p_payoffs, long p_length);
+  void SetPayoffs(int pl, const long long *p_payoffs, long p_length);
+  //@}
+
   /// @name Writing data files
   //@{
   /// Write the game to a file in .nfg outcome format
   virtual void WriteNfgFile(std::ostream &) const;
+  /// Write the game to a file in .nfb format
+  virtual void WriteNfbFile(std::ostream &) const;
   //@}
 
   virtual PureStrategyProfile NewPureStrategyProfile(void) const;
@@ -22,6 +22,8 @@
 
 #include <iostream>
 #include <sstream>
+#include <algorithm>
+#include <unordered_map>
 
 #include "gambit.h"
 #include "gametree.h"
@@ -83,8 +85,6 @@ GameTreeInfosetRep::GameTreeInfosetRep(GameTreeRep *p_efg, int p_number,
     p_actions--; 
   }
 
-  m_player->m_infosets.Append(this);
-
   if (p_player->IsChance()) {
     m_probs = Array<Number>(m_actions.Length());
     std::string prob = lexical_cast<std::string>(Rational(1, m_actions.Length()));
@@ -270,8 +270,8 @@ GameAction GameTreeNodeRep::GetPriorAction(void) const
   
   GameTreeInfosetRep *infoset = m_parent->infoset;
   for (int i = 1; i <= infoset->NumActions(); i++) {
-    if (GameNode(const_cast<GameTreeNodeRep *>(this)) == GetParent()->GetChild(i)) {
-      return infoset->GetAction(i);
+    if (m_parent->children[i] == this) {
+      return infoset->m_actions[i];
     }
   }
 
@@ -467,6 +467,7 @@ GameInfoset GameTreeNodeRep::LeaveInfoset(void)
   oldInfoset->RemoveMember(this);
   infoset = new GameTreeInfosetRep(m_efg, player->m_infosets.Length() + 1, player,
 			       children.Length());
+  player->m_infosets.Append(infoset);
   infoset->AddMember(this);
   for (int i = 1; i <= oldInfoset->m_actions.Length(); i++) {
     infoset->m_actions[i]->SetLabel(oldInfoset->m_actions[i]->GetLabel());
@@ -482,9 +483,11 @@ GameInfoset GameTreeNodeRep::AppendMove(GamePlayer p_player, int p_actions)
   if (p_actions <= 0 || children.Length() > 0) throw UndefinedException();
   if (p_player->GetGame() != m_efg) throw MismatchException();
 
-  return AppendMove(new GameTreeInfosetRep(m_efg, 
+  GameTreeInfosetRep *infoset = new GameTreeInfosetRep(m_efg, 
 				       p_player->m_infosets.Length() + 1, 
-				       p_player, p_actions));
+				       p_player, p_actions);
+  p_player->m_infosets.Append(infoset);
+  return AppendMove(infoset);
 }  
 
 GameInfoset GameTreeNodeRep::AppendMove(GameInfoset p_infoset)
@@ -508,9 +511,11 @@ GameInfoset GameTreeNodeRep::InsertMove(GamePlayer p_player, int p_actions)
   if (p_actions <= 0) throw UndefinedException();
   if (p_player->GetGame() != m_efg) throw MismatchException();
 
-  return InsertMove(new GameTreeInfosetRep(m_efg, 
+  GameTreeInfosetRep *infoset = new GameTreeInfosetRep(m_efg, 
 				       p_player->m_infosets.Length() + 1, 
-				       p_player, p_actions));
+				       p_player, p_actions);
+  p_player->m_infosets.Append(infoset);
+  return InsertMove(infoset);
 }
 
 GameInfoset GameTreeNodeRep::InsertMove(GameInfoset p_infoset)
@@ -550,7 +555,8 @@ GameInfoset GameTreeNodeRep::InsertMove(GameInfoset p_infoset)
 //------------------------------------------------------------------------
 
 GameTreeRep::GameTreeRep(void)
-  : m_computedValues(false), m_doCanon(true)
+  : m_computedValues(false), m_doCanon(true), m_updateDepth(0),
+    m_recallComputed(false)
 {
   m_chance = new GamePlayerRep(this, 0);
   m_root = new GameTreeNodeRep(this, 0);
@@ -558,6 +564,8 @@ GameTreeRep::GameTreeRep(void)
 
 GameTreeRep::~GameTreeRep()
 {
+  for (int pl = 1; pl <= m_reducedStrategies.Length(); 
+       delete m_reducedStrategies[pl++]);
   m_root->Invalidate();
   m_chance->Invalidate();
 }
@@ -619,56 +627,73 @@ bool GameTreeRep::IsConstSum(void) const
   }
 }
 
+//
+// A game has perfect recall if, at all the members of each information
+// set, its player has made the same sequence of moves.  By induction
+// down the tree, it suffices to check that the last action taken by the
+// player is the same at all members.  This also excludes information sets
+// which precede themselves, as at the later member the last action is
+// one which comes after the earlier member.
+//
+// So the check takes a single walk of the tree, carrying the last action
+// of each player on the path; its result is kept until the tree changes.
+//
 bool GameTreeRep::IsPerfectRecall(GameInfoset &s1, GameInfoset &s2) const
 {
-  for (int pl = 1; pl <= m_players.Length(); pl++)   {
-    GamePlayerRep *player = m_players[pl];
-    
-    for (int i = 1; i <= player->NumInfosets(); i++)  {
-      GameTreeInfosetRep *iset1 = player->m_infosets[i];
-      for (int j = 1; j <= player->NumInfosets(); j++)   {
-	GameTreeInfosetRep *iset2 = player->m_infosets[j];
-
-	bool precedes = false;
-	int action = 0;
-	
-	for (int m = 1; m <= iset2->NumMembers(); m++)  {
-	  int n;
-	  for (n = 1; n <= iset1->NumMembers(); n++)  {
-	    if (iset2->GetMember(m)->IsSuccessorOf(iset1->GetMember(n)) &&
-	        iset1->GetMember(n) != iset2->GetMember(m))  {
-	      precedes = true;
-	      for (int act = 1; act <= iset1->NumActions(); act++)  {
-		if (iset2->GetMember(m)->IsSuccessorOf(iset1->GetMember(n)->GetChild(act))) {
-		  if (action != 0 && action != act)  {
-		    s1 = iset1;
-		    s2 = iset2;
-		    return false;
-		  }
-		  action = act;
-		}
-	      }
-	      break;
-	    }
-	  }
-	  
-	  if (i == j && precedes)  {
-	    s1 = iset1;
-	    s2 = iset2;
-	    return false;
-	  }
+  if (!m_recallComputed) {
+    Array<GameTreeActionRep *> lastActions(m_players.Length());
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      lastActions[pl] = 0;
+    }
+    std::unordered_map<GameTreeInfosetRep *, GameTreeActionRep *> infosetActions;
+
+    m_perfectRecall = true;
+    m_recallInfoset1 = m_recallInfoset2 = 0;
+    // The nodes on the path from the root, each with the number of
+    // the child last descended into
+    std::vector<std::pair<GameTreeNodeRep *, int> > path;
+    path.push_back(std::make_pair(m_root, 0));
+    while (!path.empty() && m_perfectRecall) {
+      GameTreeNodeRep *node = path.back().first;
+      GameTreeInfosetRep *infoset = node->infoset;
+      int pl = (infoset) ? infoset->m_player->GetNumber() : 0;
+      int act = path.back().second;
+
+      if (act == 0 && pl > 0) {
+	GameTreeActionRep *first = 
+	  infosetActions.insert(std::make_pair(infoset, 
+					       lastActions[pl])).first->second;
+	if (first != lastActions[pl]) {
+	  m_perfectRecall = false;
+	  m_recallInfoset1 = (lastActions[pl]) ? 
+	    lastActions[pl]->m_infoset : first->m_infoset;
+	  m_recallInfoset2 = infoset;
+	  break;
+	}
+      }
 
-	  if (n > iset1->NumMembers() && precedes)  {
-	    s1 = iset1;
-	    s2 = iset2;
-	    return false;
-	  }
+      if (act == node->children.Length()) {
+	if (pl > 0) {
+	  lastActions[pl] = infosetActions[infoset];
+	}
+	path.pop_back();
+      }
+      else {
+	path.back().second = ++act;
+	if (pl > 0) {
+	  lastActions[pl] = infoset->m_actions[act];
 	}
+	path.push_back(std::make_pair(node->children[act], 0));
       }
     }
+    m_recallComputed = true;
   }
 
-  return true;
+  if (!m_perfectRecall) {
+    s1 = m_recallInfoset1;
+    s2 = m_recallInfoset2;
+  }
+  return m_perfectRecall;
 }
 
 
@@ -678,14 +703,22 @@ bool GameTreeRep::IsPerfectRecall(GameInfoset &s1, GameInfoset &s2) const
 
 void GameTreeRep::NumberNodes(GameTreeNodeRep *n, int &index)
 {
-  n->number = index++;
-  for (int child = 1; child <= n->children.Length();
-       NumberNodes(n->children[child++], index));
+  // Number in preorder, keeping the nodes still to be visited on a stack
+  // rather than recursing, as trees may be deep
+  std::vector<GameTreeNodeRep *> stack(1, n);
+  while (!stack.empty()) {
+    n = stack.back();
+    stack.pop_back();
+    n->number = index++;
+    for (int child = n->children.Length(); child >= 1; child--) {
+      stack.push_back(n->children[child]);
+    }
+  }
 } 
 
 void GameTreeRep::Canonicalize(void)
 {
-  if (!m_doCanon)  return;
+  if (!m_doCanon || m_updateDepth > 0)  return;
   int nodeindex = 1;
   NumberNodes(m_root, nodeindex);
 
@@ -693,37 +726,24 @@ void GameTreeRep::Canonicalize(void)
     GamePlayerRep *player = (pl) ? m_players[pl] : m_chance;
     
     // Sort nodes within information sets according to ID.
-    // Coded using a bubble sort for simplicity; large games might
-    // find a quicksort worthwhile.
     for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
-      GameTreeInfosetRep *infoset = player->m_infosets[iset];
-      for (int i = 1; i < infoset->m_members.Length(); i++) {
-	for (int j = 1; j < infoset->m_members.Length() - i; j++) {
-	  if (infoset->m_members[j+1]->number < infoset->m_members[j]->number) {
-	    GameTreeNodeRep *tmp = infoset->m_members[j];
-	    infoset->m_members[j] = infoset->m_members[j+1];
-	    infoset->m_members[j+1] = tmp;
-	  }
-	}
+      Array<GameTreeNodeRep *> &members = player->m_infosets[iset]->m_members;
+      if (members.Length() > 1) {
+	std::sort(&members[1], &members[1] + members.Length(),
+		  [](GameTreeNodeRep *a, GameTreeNodeRep *b)
+		  { return a->number < b->number; });
       }
     }
 
-    // Sort information sets by the smallest ID among their members
-    // Coded using a bubble sort for simplicity; large games might
-    // find a quicksort worthwhile.
-    for (int i = 1; i < player->m_infosets.Length(); i++) {
-      for (int j = 1; j < player->m_infosets.Length() - i; j++) {
-	int a = ((player->m_infosets[j+1]->m_members.Length()) ?
-		 player->m_infosets[j+1]->m_members[1]->number : 0);
-	int b = ((player->m_infosets[j]->m_members.Length()) ?
-		 player->m_infosets[j]->m_members[1]->number : 0);
-
-	if (a < b || b == 0) {
-	  GameTreeInfosetRep *tmp = player->m_infosets[j];
-	  player->m_infosets[j] = player->m_infosets[j+1];
-	  player->m_infosets[j+1] = tmp;
-	}
-      }
+    // Sort information sets by the smallest ID among their members,
+    // which is now the first; those with no members go last
+    if (player->m_infosets.Length() > 1) {
+      std::stable_sort(&player->m_infosets[1], 
+		       &player->m_infosets[1] + player->m_infosets.Length(),
+		       [](GameTreeInfosetRep *a, GameTreeInfosetRep *b)
+		       { return (a->m_members.Length() > 0 &&
+				 (b->m_members.Length() == 0 ||
+				  a->m_members[1]->number < b->m_members[1]->number)); });
     }
 
     // Reassign information set IDs
@@ -735,13 +755,19 @@ void GameTreeRep::Canonicalize(void)
 
 void GameTreeRep::ClearComputedValues(void) const
 {
+  IncrementVersion();
   for (int pl = 1; pl <= m_players.Length(); pl++) {
     while (m_players[pl]->m_strategies.Length() > 0) {
       m_players[pl]->m_strategies.Remove(1)->Invalidate();
     }
   }
 
+  for (int pl = 1; pl <= m_reducedStrategies.Length(); 
+       delete m_reducedStrategies[pl++]);
+  m_reducedStrategies = Array<ReducedStrategySpace *>();
+
   m_computedValues = false;
+  m_recallComputed = false;
 }
 
 void GameTreeRep::BuildComputedValues(void)
@@ -750,8 +776,17 @@ void GameTreeRep::BuildComputedValues(void)
 
   Canonicalize();
 
+  // With perfect recall, the strategies are those of the indexed spaces,
+  // so that each strategy's number is its index there, and strategies
+  // the spaces have created already are kept rather than built again
+  bool perfectRecall = IsPerfectRecall();
   for (int pl = 1; pl <= m_players.Length(); pl++) {
-    m_players[pl]->MakeReducedStrats(m_root, 0);
+    if (perfectRecall) {
+      GetReducedStrategies(m_players[pl]).BuildStrategies();
+    }
+    else {
+      m_players[pl]->MakeReducedStrats(m_root, 0);
+    }
   }
 
   for (int pl = 1, id = 1; pl <= m_players.Length(); pl++) {
@@ -762,6 +797,163 @@ void GameTreeRep::BuildComputedValues(void)
   m_computedValues = true;
 }
 
+const ReducedStrategySpace &
+GameTreeRep::GetReducedStrategies(const GamePlayer &p_player) const
+{
+  if (p_player->GetGame() != const_cast<GameTreeRep *>(this)) {
+    throw MismatchException();
+  }
+  if (p_player->IsChance()) throw UndefinedException();
+
+  const_cast<GameTreeRep *>(this)->Canonicalize();
+  int pl = p_player->GetNumber();
+  while (m_reducedStrategies.Length() < pl) {
+    m_reducedStrategies.Append(0);
+  }
+  if (!m_reducedStrategies[pl]) {
+    m_reducedStrategies[pl] = new ReducedStrategySpace(p_player);
+  }
+  return *m_reducedStrategies[pl];
+}
+
+//------------------------------------------------------------------------
+//                    GameTreeRep: Building the tree
+//------------------------------------------------------------------------
+
+void GameTreeRep::CommitUpdate(void)
+{
+  if (m_updateDepth == 0) throw UndefinedException();
+  if (--m_updateDepth == 0) {
+    Canonicalize();
+  }
+}
+
+void GameTreeRep::BuildTree(const Array<int> &p_parents,
+			    const Array<int> &p_infosets,
+			    const Array<int> &p_infosetPlayers,
+			    const Array<int> &p_outcomes)
+{
+  int numNodes = p_parents.Length(), numInfosets = p_infosetPlayers.Length();
+  if (p_infosets.Length() != numNodes || p_outcomes.Length() != numNodes) {
+    throw DimensionException();
+  }
+  if (numNodes == 0 || m_root->children.Length() > 0 || p_parents[1] != 0) {
+    throw UndefinedException();
+  }
+
+  // Check the description through before changing anything, so that
+  // an invalid description leaves the game as it was.
+  Array<int> numChildren(numNodes);
+  for (int n = 1; n <= numNodes; numChildren[n++] = 0);
+  for (int n = 2; n <= numNodes; n++) {
+    if (p_parents[n] < 1 || p_parents[n] >= n) {
+      throw UndefinedException("The parent of a node must precede it");
+    }
+    numChildren[p_parents[n]]++;
+  }
+
+  Array<int> numActions(numInfosets), numMembers(numInfosets);
+  for (int iset = 1; iset <= numInfosets; iset++) {
+    if (p_infosetPlayers[iset] < 0 || 
+	p_infosetPlayers[iset] > m_players.Length()) {
+      throw IndexException();
+    }
+    numActions[iset] = numMembers[iset] = 0;
+  }
+  int numOutcomes = m_outcomes.Length();
+  for (int n = 1; n <= numNodes; n++) {
+    int iset = p_infosets[n];
+    if (iset < 0 || iset > numInfosets) {
+      throw IndexException();
+    }
+    if ((iset == 0) != (numChildren[n] == 0)) {
+      throw UndefinedException("Exactly the nodes with children must have information sets");
+    }
+    if (iset > 0) {
+      if (numMembers[iset]++ == 0) {
+	numActions[iset] = numChildren[n];
+      }
+      else if (numActions[iset] != numChildren[n]) {
+	throw UndefinedException("Members of an information set must have the same number of children");
+      }
+    }
+    if (p_outcomes[n] < 0) {
+      throw IndexException();
+    }
+    numOutcomes = std::max(numOutcomes, p_outcomes[n]);
+  }
+  for (int iset = 1; iset <= numInfosets; iset++) {
+    if (numMembers[iset] == 0) {
+      throw UndefinedException("Information sets must have members");
+    }
+  }
+
+  // The arrays below are all allocated at their final sizes, rather than
+  // appended to element by element.
+  if (numOutcomes > m_outcomes.Length()) {
+    Array<GameOutcomeRep *> outcomes(numOutcomes);
+    for (int outc = 1; outc <= numOutcomes; outc++) {
+      outcomes[outc] = (outc <= m_outcomes.Length()) ? 
+	m_outcomes[outc] : new GameOutcomeRep(this, outc);
+    }
+    m_outcomes = outcomes;
+    ClearPayoffSummaries();
+  }
+
+  Array<GameTreeInfosetRep *> infosets(numInfosets);
+  Array<int> playerInfosets(0, m_players.Length());
+  for (int pl = 0; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = (pl) ? m_players[pl] : m_chance;
+    playerInfosets[pl] = player->m_infosets.Length();
+  }
+  for (int iset = 1; iset <= numInfosets; iset++) {
+    int pl = p_infosetPlayers[iset];
+    GamePlayerRep *player = (pl) ? m_players[pl] : m_chance;
+    infosets[iset] = new GameTreeInfosetRep(this, ++playerInfosets[pl], player,
+					    numActions[iset]);
+    infosets[iset]->m_members = Array<GameTreeNodeRep *>(numMembers[iset]);
+    numMembers[iset] = 0;
+  }
+  for (int pl = 0; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = (pl) ? m_players[pl] : m_chance;
+    Array<GameTreeInfosetRep *> playerSets(playerInfosets[pl]);
+    for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
+      playerSets[iset] = player->m_infosets[iset];
+    }
+    player->m_infosets = playerSets;
+  }
+  for (int iset = 1; iset <= numInfosets; iset++) {
+    infosets[iset]->m_player->m_infosets[infosets[iset]->m_number] = infosets[iset];
+  }
+
+  Array<GameTreeNodeRep *> nodes(numNodes);
+  nodes[1] = m_root;
+  for (int n = 2; n <= numNodes; n++) {
+    nodes[n] = new GameTreeNodeRep(this, nodes[p_parents[n]]);
+  }
+  for (int n = 1; n <= numNodes; n++) {
+    nodes[n]->children = Array<GameTreeNodeRep *>(numChildren[n]);
+    numChildren[n] = 0;
+  }
+  for (int n = 1; n <= numNodes; n++) {
+    GameTreeNodeRep *node = nodes[n];
+    if (n > 1) {
+      node->m_parent->children[++numChildren[p_parents[n]]] = node;
+    }
+    if (p_infosets[n] > 0) {
+      GameTreeInfosetRep *infoset = infosets[p_infosets[n]];
+      node->infoset = infoset;
+      infoset->m_members[++numMembers[p_infosets[n]]] = node;
+    }
+    if (p_outcomes[n] > 0) {
+      node->outcome = m_outcomes[p_outcomes[n]];
+    }
+  }
+
+  ClearComputedValues();
+  Canonicalize();
+}
+
 //------------------------------------------------------------------------
 //                  GameTreeRep: Writing data files
 //------------------------------------------------------------------------
@@ -946,6 +1138,7 @@ GamePlayer GameTreeRep::NewPlayer(void)
   for (int outc = 1; outc <= m_outcomes.Last(); outc++) {
     m_outcomes[outc]->m_payoffs.Append(Number());
   }
+  ClearPayoffSummaries();
   ClearComputedValues();
   return player;
 }
@@ -1006,6 +1199,7 @@ void GameTreeRep::DeleteOutcome(const GameOutcome &p_outcome)
   for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
     m_outcomes[outc]->m_number = outc;
   }
+  ClearPayoffSummaries();
   ClearComputedValues();
 }
 
@@ -28,6 +28,7 @@
 namespace Gambit {
 
 class GameTreeRep;
+class ReducedStrategySpace;
 
 class GameTreeActionRep : public GameActionRep {
   friend class GameTreeRep;
@@ -112,6 +113,16 @@ public:
   virtual int NumMembers(void) const { return m_members.Length(); }
   virtual GameNode GetMember(int p_index) const;
 
+  /// @name Borrowed access
+  //@{
+  /// Returns the actions at the information set, without taking
+  /// references to them
+  const Array<GameTreeActionRep *> &Actions(void) const { return m_actions; }
+  /// Returns the members of the information set, without taking
+  /// references to them
+  const Array<GameTreeNodeRep *> &Members(void) const { return m_members; }
+  //@}
+
   virtual bool Precedes(GameNode) const;
 
   virtual void SetActionProb(int i, const std::string &p_value);
@@ -171,6 +182,11 @@ public:
     { return (infoset) ? infoset->GetPlayer() : 0; }
   virtual GameAction GetPriorAction(void) const; // returns null if root node
   virtual GameNode GetChild(int i) const    { return children[i]; }
+  /// Returns the children of the node, without taking references to them
+  const Array<GameTreeNodeRep *> &Children(void) const { return children; }
+  /// Returns the information set of the node, without taking a
+  /// reference to it
+  const GameTreeInfosetRep *Infoset(void) const { return infoset; }
   virtual GameNode GetParent(void) const    { return m_parent; }
   virtual GameNode GetNextSibling(void) const;
   virtual GameNode GetPriorSibling(void) const;
@@ -202,6 +218,14 @@ class GameTreeRep : public GameExplicitRep {
   friend class GameTreeActionRep;
 protected:
   mutable bool m_computedValues, m_doCanon;
+  /// The number of batches of edits under way; see BeginUpdate()
+  int m_updateDepth;
+  /// Whether the game has perfect recall, and if not, a pair of
+  /// information sets showing it does not; computed on first use
+  mutable bool m_recallComputed, m_perfectRecall;
+  mutable GameTreeInfosetRep *m_recallInfoset1, *m_recallInfoset2;
+  /// The space of reduced strategies of each player, built on first use
+  mutable Array<ReducedStrategySpace *> m_reducedStrategies;
   GameTreeNodeRep *m_root;
   GamePlayerRep *m_chance;
 
@@ -239,6 +263,31 @@ public:
     if (m_doCanon) const_cast<GameTreeRep *>(this)->Canonicalize(); }
   //@}
 
+  /// @name Building the tree
+  //@{
+  /// Begin a batch of edits to the tree.  Until the batch is committed,
+  /// the tree is not renumbered and sorted after each edit.  Batches
+  /// may be nested.  A GameTreeUpdate pairs this with CommitUpdate()
+  /// even when an edit throws.
+  void BeginUpdate(void) { m_updateDepth++; }
+  /// Commit a batch of edits; committing the outermost batch puts the
+  /// tree into canonical form, once.
+  void CommitUpdate(void);
+  /// Build the whole tree in one step, below a root with no move.
+  /// Nodes are numbered from 1, with node 1 the root; every other node
+  /// is given the number of its parent, which must be smaller than its
+  /// own, and the children of a node are in order of their numbers.
+  /// Each node with children has an information set, given by its
+  /// (nonzero) index into p_infosetPlayers, which gives the number of
+  /// the player at each information set, 0 for chance; terminal nodes
+  /// have index 0.  Each node has an outcome, given by its index among
+  /// the outcomes of the game, or 0 for none; outcomes with indices
+  /// beyond the current number of outcomes are created.
+  void BuildTree(const Array<int> &p_parents, const Array<int> &p_infosets,
+		 const Array<int> &p_infosetPlayers,
+		 const Array<int> &p_outcomes);
+  //@}
+
   /// @name Players
   //@{
   /// Returns the chance (nature) player
@@ -247,6 +296,15 @@ public:
   virtual GamePlayer NewPlayer(void);
   //@}
 
+  /// @name Strategies
+  //@{
+  /// Returns the reduced strategies of the player as an indexed space,
+  /// whose strategies are created only on demand, rather than all at
+  /// once as by NumStrategies() and GetStrategy().  The game must have
+  /// perfect recall.  The space is valid until the tree is next changed.
+  const ReducedStrategySpace &GetReducedStrategies(const GamePlayer &) const;
+  //@}
+
   /// @name Nodes
   //@{
   /// Returns the root node of the game
@@ -292,6 +350,34 @@ public:
 
 };
 
+/// Holds a batch of edits to a tree open for as long as it lives.
+/// Commit() commits the batch; if the guard goes out of scope first,
+/// as when an exception is thrown while editing, the batch is closed
+/// all the same, so that the tree is not left in the middle of one.
+class GameTreeUpdate {
+private:
+  GameTreeRep &m_tree;
+  bool m_committed;
+
+  GameTreeUpdate(const GameTreeUpdate &);
+  GameTreeUpdate &operator=(const GameTreeUpdate &);
+
+public:
+  explicit GameTreeUpdate(GameTreeRep &p_tree)
+    : m_tree(p_tree), m_committed(false)
+  { m_tree.BeginUpdate(); }
+  ~GameTreeUpdate()
+  {
+    if (!m_committed) {
+      try { m_tree.CommitUpdate(); }
+      catch (...) { }
+    }
+  }
+
+  /// Commit the batch; see GameTreeRep::CommitUpdate()
+  void Commit(void) { m_committed = true; m_tree.CommitUpdate(); }
+};
+
 }
 
 
@@ -23,6 +23,10 @@
 #ifndef LIBGAMBIT_MIXED_H
 #define LIBGAMBIT_MIXED_H
 
+#include <map>
+#include <memory>
+#include <vector>
+
 #include "core/vector.h"
 #include "games/gameagg.h"
 #include "games/gamebagg.h"
@@ -54,11 +58,64 @@ public:
   virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const = 0;
 };
 
+///
+/// Payoffs of a mixed strategy profile on a tree are computed from the
+/// realization plan the profile induces: the probability with which each
+/// player's strategies are consistent with each of their sequences of moves.
+/// The expected payoffs, and the payoff to each sequence against the
+/// other players, are computed together in one pass over the nodes with
+/// outcomes, and kept until the probabilities change.
+///
 template <class T> class TreeMixedStrategyProfileRep 
   : public MixedStrategyProfileRep<T> {
+private:
+  /// The part of the tree payoffs depend on: for each node with an
+  /// outcome, the probability chance plays to it, its payoffs, and the
+  /// sequence of moves of each player leading to it.  Sequences are
+  /// numbered from 1 for each player, with 0 the empty sequence.  This
+  /// depends only on the game, so it is shared by copies of the profile;
+  /// it is rebuilt when the version of the game changes.
+  struct Tree {
+    /// The version of the game from which this was built
+    unsigned long m_version;
+    /// The number of the first sequence ending at each information set,
+    /// less one, and the number of sequences, for each player
+    Array<Array<int> > m_offsets;
+    Array<int> m_numSequences;
+    std::vector<T> m_chanceProbs, m_payoffs;
+    std::vector<int> m_sequences;
+  };
+  mutable shared_ptr<Tree> m_tree;
+
+  /// @name Values at the probabilities in m_cacheProbs
+  //@{
+  mutable bool m_cacheValid;
+  mutable Vector<T> m_cacheProbs;
+  /// The realization probability of each sequence of each player
+  mutable Array<Array<T> > m_realizProbs;
+  /// The expected payoff to each player
+  mutable Array<T> m_payoffs;
+  /// The payoff to each player from each sequence of each player, that
+  /// player's realization probability aside, indexed [pl][player][seq]
+  mutable Array<Array<Array<T> > > m_sequenceValues;
+  /// The same, for pairs of sequences of two players, computed on demand
+  /// for each player and (ordered) pair of players
+  mutable std::map<long, std::vector<T> > m_pairValues;
+  //@}
+
+  /// @name Private auxiliary functions
+  //@{
+  void BuildTree(void) const;
+  void ComputeValues(void) const;
+  /// The sequence following the move of the strategy at an information set
+  int GetSequence(int pl, const Array<int> &p_behav, int iset) const
+  { return m_tree->m_offsets[pl][iset] + p_behav[iset]; }
+  //@}
+
 public:
   TreeMixedStrategyProfileRep(const StrategySupportProfile &p_support)
-    : MixedStrategyProfileRep<T>(p_support)
+    : MixedStrategyProfileRep<T>(p_support), m_cacheValid(false),
+      m_cacheProbs(this->m_probs.Length())
   { }
   TreeMixedStrategyProfileRep(const MixedBehaviorProfile<T> &);
   virtual ~TreeMixedStrategyProfileRep() { }
@@ -98,11 +155,20 @@ public:
 
 template <class T> class AggMixedStrategyProfileRep
   : public MixedStrategyProfileRep<T> {
+private:
+  /// Scratch space for evaluating the payoffs of the game, made on first
+  /// use and not shared with copies of the profile
+  mutable std::unique_ptr<agg::AGG::EvalContext> m_context;
+
+  agg::AGG::EvalContext &GetContext(const agg::AGG &p_agg) const;
 
 public:
   AggMixedStrategyProfileRep(const StrategySupportProfile &p_support)
    : MixedStrategyProfileRep<T>(p_support)
     { }
+  AggMixedStrategyProfileRep(const AggMixedStrategyProfileRep &p_profile)
+    : MixedStrategyProfileRep<T>(p_profile)
+    { }
   virtual ~AggMixedStrategyProfileRep() { }
 
   virtual MixedStrategyProfileRep<T> *Copy(void) const {
@@ -113,13 +179,47 @@ public:
   virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const;
 };
 
+template <class T> class DoubleTableMixedStrategyProfileRep
+  : public MixedStrategyProfileRep<T> {
+private:
+  /// @name Private recursive payoff functions
+  //@{
+  /// Recursive computation of the expected value of a block of payoffs,
+  /// holding the strategies of players const_pl1 and const_pl2 fixed
+  void GetPayoff(const double *p_payoffs, int const_pl1, int const_pl2,
+		 int cur_pl, long index, const T &prob, T &value) const;
+  //@}
+
+public:
+  DoubleTableMixedStrategyProfileRep(const StrategySupportProfile &p_support)
+    : MixedStrategyProfileRep<T>(p_support)
+  { }
+  virtual ~DoubleTableMixedStrategyProfileRep() { }
+
+  virtual MixedStrategyProfileRep<T> *Copy(void) const {
+    return new DoubleTableMixedStrategyProfileRep(*this);
+  }
+  virtual T GetPayoff(int pl) const;
+  virtual T GetPayoffDeriv(int pl, const GameStrategy &) const;
+  virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const;
+};
+
 template <class T> class BagentMixedStrategyProfileRep
   : public MixedStrategyProfileRep<T> {
+private:
+  /// Scratch space for evaluating the payoffs of the game, made on first
+  /// use and not shared with copies of the profile
+  mutable std::unique_ptr<agg::AGG::EvalContext> m_context;
+
+  agg::AGG::EvalContext &GetContext(const agg::AGG &p_agg) const;
 
 public:
   BagentMixedStrategyProfileRep(const StrategySupportProfile &p_support)
     : MixedStrategyProfileRep<T>(p_support)
     { }
+  BagentMixedStrategyProfileRep(const BagentMixedStrategyProfileRep &p_profile)
+    : MixedStrategyProfileRep<T>(p_profile)
+    { }
   virtual ~BagentMixedStrategyProfileRep() { }
 
   virtual MixedStrategyProfileRep<T> *Copy(void) const {
@@ -141,8 +241,10 @@ template <class T> class MixedStrategyProfile {
   friend class AggMixedStrategyProfileRep<T>;
   friend class BagentMixedStrategyProfileRep<T>;
   friend class TableMixedStrategyProfileRep<T>;
+  friend class DoubleTableMixedStrategyProfileRep<T>;
   friend class GameAggRep;
   friend class GameBagentRep;
+  friend class GameDoubleTableRep;
   friend class GameTableRep;
   friend class GameTreeRep;
   friend class MixedBehaviorProfile<T>;
@@ -457,6 +457,59 @@ SubgameBehavSolver<T>::Solve(const BehaviorSupportProfile &p_support) const
   return solutions;
 }
 
+//------------------------------------------------------------------------
+//                     class NormalizedBimatrix<T>
+//------------------------------------------------------------------------
+
+template <class T>
+NormalizedBimatrix<T>::NormalizedBimatrix(const Game &p_game)
+  : A1(1, p_game->Players()[1]->Strategies().size(),
+       1, p_game->Players()[2]->Strategies().size()),
+    A2(1, p_game->Players()[2]->Strategies().size(),
+       1, p_game->Players()[1]->Strategies().size())
+{
+  PayoffSummary summary = p_game->GetPayoffSummary();
+  Rational min = summary.GetMin<Rational>();
+  if (min > Rational(0)) {
+    min = Rational(0);
+  }
+  min -= Rational(1);
+
+  Rational max = summary.GetMax<Rational>();
+  if (max < Rational(0)) {
+    max = Rational(0);
+  }
+
+  Rational fac(1, max - min);
+
+  PureStrategyProfile profile = p_game->NewPureStrategyProfile();
+  for (size_t i = 1; i <= p_game->Players()[1]->Strategies().size(); i++) {
+    profile->SetStrategy(p_game->Players()[1]->Strategies()[i]);
+    for (size_t j = 1; j <= p_game->Players()[2]->Strategies().size(); j++) {
+      profile->SetStrategy(p_game->Players()[2]->Strategies()[j]);
+      A1(i, j) = fac * (profile->GetPayoff(1) - min);
+      A2(j, i) = fac * (profile->GetPayoff(2) - min);
+    }
+  }
+}
+
+template<> std::shared_ptr<NormalizedBimatrix<double> >
+NormalizedBimatrix<double>::Get(const Game &p_game)
+{
+  return p_game->GetRepresentation<NormalizedBimatrix<double> >("bimatrix-double",
+    [&p_game]() { return new NormalizedBimatrix<double>(p_game); });
+}
+
+template<> std::shared_ptr<NormalizedBimatrix<Rational> >
+NormalizedBimatrix<Rational>::Get(const Game &p_game)
+{
+  return p_game->GetRepresentation<NormalizedBimatrix<Rational> >("bimatrix-rational",
+    [&p_game]() { return new NormalizedBimatrix<Rational>(p_game); });
+}
+
+template class NormalizedBimatrix<double>;
+template class NormalizedBimatrix<Rational>;
+
 template class StrategySolver<double>;
 template class StrategySolver<Rational>;
 
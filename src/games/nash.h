@@ -205,6 +205,28 @@ private:
 		     List<GameOutcome> &values) const;
 };
 
+//------------------------------------------------------------------------
+//                 Representations shared by solvers
+//------------------------------------------------------------------------
+
+//
+// The payoffs of a two-player strategic game as a pair of matrices,
+// shifted and scaled so that all are positive and at most one.  A1(i,j)
+// is the payoff to player 1, and A2(j,i) that to player 2, when player 1
+// plays strategy i and player 2 strategy j.  This is the form taken by the
+// solvers which work on the best response polytopes of the game.
+//
+template <class T> class NormalizedBimatrix {
+public:
+  Matrix<T> A1, A2;
+
+  NormalizedBimatrix(const Game &p_game);
+
+  // Returns the matrices of the game, which are built once and kept
+  // with the game until it changes
+  static std::shared_ptr<NormalizedBimatrix<T> > Get(const Game &p_game);
+};
+
 //
 // Exception raised when maximum number of equilibria to compute
 // has been reached.  A convenience for unraveling a potentially
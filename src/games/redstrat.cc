@@ -0,0 +1,288 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2022, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/games/redstrat.cc
+// Indexed spaces of reduced strategies of players in game trees
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <climits>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "gambit.h"
+#include "gametree.h"
+#include "redstrat.h"
+
+namespace Gambit {
+
+namespace {
+
+long MultiplyCounts(long a, long b)
+{
+  if (b != 0 && a > LONG_MAX / b) {
+    throw UndefinedException("Too many strategies to index");
+  }
+  return a * b;
+}
+
+long AddCounts(long a, long b)
+{
+  if (a > LONG_MAX - b) {
+    throw UndefinedException("Too many strategies to index");
+  }
+  return a + b;
+}
+
+/// The information sets reached and not yet decided on, the first
+/// reached on top
+typedef std::priority_queue<std::pair<int, int>,
+			    std::vector<std::pair<int, int> >,
+			    std::greater<std::pair<int, int> > > ReachedInfosets;
+
+}  // end anonymous namespace
+
+//===========================================================================
+//                        class ReducedStrategySpace
+//===========================================================================
+
+ReducedStrategySpace::ReducedStrategySpace(const GamePlayer &p_player)
+  : m_player(p_player.operator->()), m_numStrategies(1)
+{
+  Game game = p_player->GetGame();
+  if (!game->IsTree() || p_player->IsChance() || !game->IsPerfectRecall()) {
+    throw UndefinedException();
+  }
+
+  int numInfosets = m_player->NumInfosets();
+  m_first = Array<int>(numInfosets);
+  m_counts = Array<long>(numInfosets);
+  m_children = Array<Array<std::vector<int> > >(numInfosets);
+  m_actionCounts = Array<Array<long> >(numInfosets);
+  for (int iset = 1; iset <= numInfosets; iset++) {
+    int numActions = m_player->m_infosets[iset]->NumActions();
+    m_first[iset] = 0;
+    m_children[iset] = Array<std::vector<int> >(numActions);
+    m_actionCounts[iset] = Array<long>(numActions);
+  }
+
+  // Walk the tree in preorder, carrying the last action of the player
+  // on the path to each node.  With perfect recall, this is the same
+  // for all members of an information set.
+  struct Entry {
+    GameNode m_node;
+    int m_infoset, m_action;
+  };
+  std::vector<Entry> stack;
+  Entry root = { game->GetRoot(), 0, 0 };
+  stack.push_back(root);
+  for (int preorder = 1; !stack.empty(); preorder++) {
+    Entry entry = stack.back();
+    stack.pop_back();
+    GameNode node = entry.m_node;
+    if (node->NumChildren() == 0) continue;
+
+    bool isOwn = (node->GetPlayer() == p_player);
+    if (isOwn) {
+      int iset = node->GetInfoset()->GetNumber();
+      if (m_first[iset] == 0) {
+	m_first[iset] = preorder;
+	if (entry.m_infoset == 0) {
+	  m_roots.push_back(iset);
+	}
+	else {
+	  m_children[entry.m_infoset][entry.m_action].push_back(iset);
+	}
+      }
+    }
+    for (int act = node->NumChildren(); act >= 1; act--) {
+      Entry child = { node->GetChild(act), entry.m_infoset, entry.m_action };
+      if (isOwn) {
+	child.m_infoset = node->GetInfoset()->GetNumber();
+	child.m_action = act;
+      }
+      stack.push_back(child);
+    }
+  }
+
+  // Count the ways of playing from each information set on, from the
+  // last reached back; those following an action are reached after it
+  std::vector<int> order;
+  for (int iset = 1; iset <= numInfosets; order.push_back(iset++));
+  std::sort(order.begin(), order.end(),
+	    [this](int a, int b) { return m_first[a] > m_first[b]; });
+  for (size_t i = 0; i < order.size(); i++) {
+    int iset = order[i];
+    long count = 0;
+    for (int act = 1; act <= m_children[iset].Length(); act++) {
+      long actionCount = 1;
+      for (size_t j = 0; j < m_children[iset][act].size(); j++) {
+	actionCount = MultiplyCounts(actionCount,
+				     m_counts[m_children[iset][act][j]]);
+      }
+      m_actionCounts[iset][act] = actionCount;
+      count = AddCounts(count, actionCount);
+    }
+    m_counts[iset] = count;
+  }
+  for (size_t i = 0; i < m_roots.size(); i++) {
+    m_numStrategies = MultiplyCounts(m_numStrategies, m_counts[m_roots[i]]);
+  }
+}
+
+ReducedStrategySpace::~ReducedStrategySpace()
+{
+  for (std::map<long, GameStrategyRep *>::iterator strategy = m_strategies.begin();
+       strategy != m_strategies.end(); ++strategy) {
+    strategy->second->Invalidate();
+  }
+}
+
+//
+// The strategies are in lexicographic order of the actions taken at the
+// information sets, in the order these are reached.  Each information
+// set reached accounts for a factor of the number of ways of playing
+// at the information sets reached and not yet decided; choosing an
+// action replaces that factor with the number of ways of playing after
+// the action.
+//
+// The game builds the strategies of players in trees with perfect recall
+// from this space, by BuildStrategies(), so the number of a strategy is
+// its index by construction.  The order is also that of
+// GamePlayerRep::MakeReducedStrats(), which the game still uses without
+// perfect recall: it walks the tree depth first, trying the actions of
+// each information set of the player in turn at its first member, and so
+// decides the information sets in the preorder of their first members,
+// varying the choice at the one decided last fastest.
+//
+Array<int> ReducedStrategySpace::GetBehavior(long p_index) const
+{
+  if (p_index < 1 || p_index > m_numStrategies) throw IndexException();
+
+  Array<int> behav(m_first.Length());
+  for (int iset = 1; iset <= behav.Length(); behav[iset++] = 0);
+
+  ReachedInfosets reached;
+  for (size_t i = 0; i < m_roots.size(); i++) {
+    reached.push(std::make_pair(m_first[m_roots[i]], m_roots[i]));
+  }
+  long index = p_index - 1, count = m_numStrategies;
+  while (!reached.empty()) {
+    int iset = reached.top().second;
+    reached.pop();
+    long rest = count / m_counts[iset];
+    int act = 1;
+    while (index >= rest * m_actionCounts[iset][act]) {
+      index -= rest * m_actionCounts[iset][act++];
+    }
+    count = rest * m_actionCounts[iset][act];
+    behav[iset] = act;
+    const std::vector<int> &children = m_children[iset][act];
+    for (size_t i = 0; i < children.size(); i++) {
+      reached.push(std::make_pair(m_first[children[i]], children[i]));
+    }
+  }
+  return behav;
+}
+
+long ReducedStrategySpace::GetIndex(const Array<int> &p_behav) const
+{
+  if (p_behav.Length() != m_first.Length()) throw DimensionException();
+
+  ReachedInfosets reached;
+  for (size_t i = 0; i < m_roots.size(); i++) {
+    reached.push(std::make_pair(m_first[m_roots[i]], m_roots[i]));
+  }
+  long index = 0, count = m_numStrategies;
+  int numDecided = 0;
+  while (!reached.empty()) {
+    int iset = reached.top().second;
+    reached.pop();
+    int act = p_behav[iset];
+    if (act < 1 || act > m_actionCounts[iset].Length()) throw ValueException();
+    long rest = count / m_counts[iset];
+    for (int prior = 1; prior < act; prior++) {
+      index += rest * m_actionCounts[iset][prior];
+    }
+    count = rest * m_actionCounts[iset][act];
+    numDecided++;
+    const std::vector<int> &children = m_children[iset][act];
+    for (size_t i = 0; i < children.size(); i++) {
+      reached.push(std::make_pair(m_first[children[i]], children[i]));
+    }
+  }
+
+  // Actions at information sets not reached do not describe a
+  // reduced strategy
+  for (int iset = 1; iset <= p_behav.Length(); iset++) {
+    if (p_behav[iset] != 0) numDecided--;
+  }
+  if (numDecided != 0) throw ValueException();
+  return index + 1;
+}
+
+void ReducedStrategySpace::BuildStrategies(void) const
+{
+  if (m_numStrategies > INT_MAX) {
+    throw UndefinedException("Too many strategies to build");
+  }
+  for (ReducedStrategyIterator iter(*this); !iter.AtEnd(); iter++) {
+    GameStrategyRep *strategy;
+    std::map<long, GameStrategyRep *>::const_iterator created = m_strategies.find(iter.GetIndex());
+    if (created != m_strategies.end()) {
+      strategy = created->second;
+    }
+    else {
+      strategy = m_player->NewReducedStrategy(*iter);
+    }
+    m_player->m_strategies.Append(strategy);
+    strategy->m_number = (int) iter.GetIndex();
+  }
+  // The strategies created on demand now belong to the player
+  m_strategies.clear();
+}
+
+GameStrategy ReducedStrategySpace::GetStrategy(long p_index) const
+{
+  if (p_index < 1 || p_index > m_numStrategies) throw IndexException();
+
+  if (m_player->m_strategies.Length() > 0) {
+    return m_player->m_strategies[p_index];
+  }
+
+  std::map<long, GameStrategyRep *>::const_iterator created = m_strategies.find(p_index);
+  if (created != m_strategies.end()) {
+    return created->second;
+  }
+
+  GameStrategyRep *strategy = m_player->NewReducedStrategy(GetBehavior(p_index));
+  // The number and the global number of the strategy are those it has
+  // among the strategies of the game, where these fit
+  GameTreeRep *game = dynamic_cast<GameTreeRep *>(m_player->m_game);
+  long id = p_index;
+  for (int pl = 1; pl < m_player->GetNumber() && id <= INT_MAX; pl++) {
+    id += game->GetReducedStrategies(game->GetPlayer(pl)).NumStrategies();
+  }
+  strategy->m_number = (p_index <= INT_MAX) ? (int) p_index : 0;
+  strategy->m_id = (id <= INT_MAX) ? (int) id : 0;
+  m_strategies[p_index] = strategy;
+  return strategy;
+}
+
+}  // end namespace Gambit
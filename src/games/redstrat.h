@@ -0,0 +1,138 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2022, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/games/redstrat.h
+// Indexed spaces of reduced strategies of players in game trees
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LIBGAMBIT_REDSTRAT_H
+#define LIBGAMBIT_REDSTRAT_H
+
+#include <map>
+#include <vector>
+#include "game.h"
+
+namespace Gambit {
+
+/// The reduced strategies of a player in a game tree with perfect
+/// recall, indexed without being created.  A reduced strategy chooses
+/// an action at each information set not ruled out by the player's own
+/// earlier actions, and is described by its behavior: the action at each
+/// information set of the player, or zero where there is none.
+///
+/// Strategies are numbered from 1, in lexicographic order of the
+/// actions taken at the information sets, taken in the preorder of
+/// their first members.  The game builds the player's strategies from
+/// this space, so that the strategy with a given index here is the
+/// strategy with that number for the player.  The
+/// number of strategies is computed from the number of ways of playing
+/// after each action, and conversion between an index and a behavior
+/// takes time proportional to the number of actions of the player.
+class ReducedStrategySpace {
+private:
+  GamePlayerRep *m_player;
+  long m_numStrategies;
+  /// The information sets reached before any action of the player
+  std::vector<int> m_roots;
+  /// The preorder number of the first member of each information set;
+  /// this is the order in which the game decides on them
+  Array<int> m_first;
+  /// The number of ways of playing from each information set on
+  Array<long> m_counts;
+  /// The information sets next reached after each action, and the
+  /// number of ways of playing from there on
+  Array<Array<std::vector<int> > > m_children;
+  Array<Array<long> > m_actionCounts;
+  /// The strategies created so far, by index
+  mutable std::map<long, GameStrategyRep *> m_strategies;
+
+  ReducedStrategySpace(const ReducedStrategySpace &);
+  ReducedStrategySpace &operator=(const ReducedStrategySpace &);
+
+public:
+  /// @name Lifecycle
+  //@{
+  /// Construct the space of reduced strategies of a player in a game
+  /// tree.  Throws UndefinedException if the game does not have perfect
+  /// recall, or the player has more strategies than can be indexed.
+  explicit ReducedStrategySpace(const GamePlayer &);
+  /// Destructor; invalidates the strategies created by the space
+  ~ReducedStrategySpace();
+  //@}
+
+  /// @name Data access
+  //@{
+  /// Returns the player whose strategies these are
+  GamePlayer GetPlayer(void) const { return m_player; }
+  /// Returns the number of reduced strategies of the player
+  long NumStrategies(void) const { return m_numStrategies; }
+  /// Returns the behavior of the strategy with the given index
+  Array<int> GetBehavior(long p_index) const;
+  /// Returns the index of the strategy with the given behavior
+  long GetIndex(const Array<int> &p_behav) const;
+  /// Returns the strategy with the given index.  If the player's
+  /// strategies have been built, this is the strategy with that number;
+  /// otherwise a strategy is created on first request, and remains
+  /// valid until the game tree is next changed.
+  GameStrategy GetStrategy(long p_index) const;
+  /// Builds the player's list of strategies in the order of their
+  /// indices, keeping the strategies created already.  This is used by
+  /// the game when it builds its strategies.
+  void BuildStrategies(void) const;
+  //@}
+};
+
+/// This class iterates through the reduced strategies of a player,
+/// computing the behavior of each in turn, without creating the
+/// strategies.
+class ReducedStrategyIterator {
+private:
+  const ReducedStrategySpace &m_space;
+  long m_index;
+  Array<int> m_behav;
+
+public:
+  /// @name Lifecycle
+  //@{
+  /// Construct a new iterator at the first strategy of the space
+  ReducedStrategyIterator(const ReducedStrategySpace &p_space)
+    : m_space(p_space), m_index(1)
+  { if (!AtEnd()) m_behav = m_space.GetBehavior(m_index); }
+  //@}
+
+  /// @name Iteration and data access
+  //@{
+  /// Advance to the next strategy
+  void operator++(void)
+  { if (++m_index <= m_space.NumStrategies()) m_behav = m_space.GetBehavior(m_index); }
+  /// Advance to the next strategy (postfix version)
+  void operator++(int) { ++(*this); }
+  /// Has the iterator gone past the last strategy?
+  bool AtEnd(void) const { return m_index > m_space.NumStrategies(); }
+  /// Returns the index of the current strategy
+  long GetIndex(void) const { return m_index; }
+  /// Returns the behavior of the current strategy
+  const Array<int> &operator*(void) const { return m_behav; }
+  /// Returns the current strategy, creating it if need be
+  GameStrategy GetStrategy(void) const { return m_space.GetStrategy(m_index); }
+  //@}
+};
+
+}  // end namespace Gambit
+
+#endif  // LIBGAMBIT_REDSTRAT_H
@@ -21,6 +21,8 @@
 //
 
 #include "gambit.h"
+#include "gametable.h"
+#include "gamedouble.h"
 
 namespace Gambit {
 
@@ -123,4 +125,56 @@ void StrategyProfileIterator::operator++(void)
   }
 }
 
+//===========================================================================
+//                        class TableContingencyIterator
+//===========================================================================
+
+TableContingencyIterator::TableContingencyIterator(const StrategySupportProfile &p_support,
+						   int p_part, int p_numParts)
+  : m_payoffs(0), m_numContingencies(0), m_results(0),
+    m_offsets(p_support.GetGame()->NumPlayers()),
+    m_digits(p_support.GetGame()->NumPlayers()),
+    m_index(1L), m_count(0L), m_end(1L)
+{
+  Game game = p_support.GetGame();
+  if (const GameDoubleTableRep *table =
+      dynamic_cast<const GameDoubleTableRep *>(&*game)) {
+    m_numContingencies = table->NumContingencies();
+    m_payoffs = table->GetPayoffs(1);
+  }
+  else if (const GameTableRep *table =
+	   dynamic_cast<const GameTableRep *>(&*game)) {
+    m_numContingencies = table->m_results.Length();
+    m_results = &table->m_results[1];
+  }
+  else {
+    throw UndefinedException();
+  }
+
+  for (int pl = 1; pl <= game->NumPlayers(); pl++) {
+    m_offsets[pl] = Array<long>(p_support.NumStrategies(pl));
+    for (int st = 1; st <= p_support.NumStrategies(pl); st++) {
+      m_offsets[pl][st] = p_support.GetStrategy(pl, st)->m_offset;
+    }
+    m_end *= p_support.NumStrategies(pl);
+  }
+
+  // Start at the first contingency of the part, whose count among the
+  // contingencies of the support gives the digits in mixed radix
+  m_count = m_end * (p_part - 1) / p_numParts;
+  m_end = m_end * p_part / p_numParts;
+  long rest = m_count;
+  for (int pl = 1; pl <= game->NumPlayers(); pl++) {
+    m_digits[pl] = rest % m_offsets[pl].Length() + 1;
+    rest /= m_offsets[pl].Length();
+    m_index += m_offsets[pl][m_digits[pl]];
+  }
+}
+
+bool TableContingencyIterator::IsTable(const Game &p_game)
+{
+  return (dynamic_cast<const GameDoubleTableRep *>(&*p_game) ||
+	  dynamic_cast<const GameTableRep *>(&*p_game));
+}
+
 } // end namespace Gambit
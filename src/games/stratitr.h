@@ -75,6 +75,96 @@ public:
   //@}
 };
 
+/// This class walks the contingencies of a game held in a table, such
+/// as one read from an .nfg or .nfb file, reading the payoffs straight
+/// from the table.  It keeps the index of the current contingency in the
+/// table and the position of each player's strategy in the support, and
+/// advances like an odometer, the strategy of player 1 turning fastest;
+/// no strategy profile is created or updated on the way.
+///
+/// The contingencies of the support may be split into a number of parts
+/// of nearly equal size, each walked by an iterator of its own, so that
+/// the parts may be walked on separate threads.  The iterator only reads
+/// the table, which must not be changed while it is in use.
+class TableContingencyIterator {
+private:
+  /// The payoffs of the table, if these are held as doubles, and the
+  /// number of contingencies in the table
+  const double *m_payoffs;
+  long m_numContingencies;
+  /// The outcomes of the table otherwise, from the first contingency on
+  GameOutcomeRep *const *m_results;
+  /// The offset in the table of each strategy in the support
+  Array<Array<long> > m_offsets;
+  Array<int> m_digits;
+  long m_index, m_count, m_end;
+
+  /// Returns the payoff to player pl at the contingency with the given
+  /// (one-based) index in the table
+  template <class T> T GetPayoff(int pl, long p_index) const
+  {
+    if (m_payoffs) {
+      return (T) m_payoffs[(pl - 1) * m_numContingencies + p_index - 1];
+    }
+    GameOutcomeRep *outcome = m_results[p_index - 1];
+    return (outcome) ? outcome->GetPayoff<T>(pl) : T(0);
+  }
+
+public:
+  /// @name Lifecycle
+  //@{
+  /// Construct a new iterator over the contingencies of the support,
+  /// or over the p_part'th of p_numParts parts of them.  Throws
+  /// UndefinedException if the game is not held in a table.
+  TableContingencyIterator(const StrategySupportProfile &,
+			   int p_part = 1, int p_numParts = 1);
+  /// Returns true if the game is held in a table which the iterator
+  /// can read
+  static bool IsTable(const Game &);
+  //@}
+
+  /// @name Iteration and data access
+  //@{
+  /// Advance to the next contingency (prefix version)
+  void operator++(void)
+  {
+    if (++m_count >= m_end) return;
+    for (int pl = 1; ; pl++) {
+      const Array<long> &offsets = m_offsets[pl];
+      int &digit = m_digits[pl];
+      m_index -= offsets[digit];
+      if (digit < offsets.Length()) {
+	m_index += offsets[++digit];
+	return;
+      }
+      digit = 1;
+      m_index += offsets[1];
+    }
+  }
+  /// Advance to the next contingency (postfix version)
+  void operator++(int) { ++(*this); }
+  /// Has iterator gone past the end?
+  bool AtEnd(void) const { return m_count >= m_end; }
+
+  /// Returns the (one-based) index of the current contingency in the
+  /// table, as PureStrategyProfileRep::GetIndex() does
+  long GetIndex(void) const { return m_index; }
+  /// Returns the position of player pl's current strategy in the support
+  int GetDigit(int pl) const { return m_digits[pl]; }
+  /// Returns the payoff to player pl at the current contingency
+  template <class T> T GetPayoff(int pl) const
+  { return GetPayoff<T>(pl, m_index); }
+  /// Returns the payoff to the player of the strategy, were the player
+  /// to play it instead at the current contingency
+  template <class T> T GetStrategyValue(const GameStrategy &p_strategy) const
+  {
+    int pl = p_strategy->GetPlayer()->GetNumber();
+    return GetPayoff<T>(pl, m_index - m_offsets[pl][m_digits[pl]] +
+			p_strategy->m_offset);
+  }
+  //@}
+};
+
 } // end namespace Gambit
 
 #endif // LIBGAMBIT_STRATITR_H
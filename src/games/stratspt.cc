@@ -226,10 +226,9 @@ bool StrategySupportProfile::Dominates(const GameStrategy &s,
 				bool p_strict) const
 {
   bool equal = true;
-  
-  for (StrategyProfileIterator iter(*this); !iter.AtEnd(); iter++) {
-    Rational ap = (*iter)->GetStrategyValue(s);
-    Rational bp = (*iter)->GetStrategyValue(t);
+  // Returns false if the values of s and t at a contingency show
+  // that s does not dominate t
+  auto compare = [&](const Rational &ap, const Rational &bp) {
     if (p_strict && ap <= bp) {
       return false;
     }
@@ -237,6 +236,24 @@ bool StrategySupportProfile::Dominates(const GameStrategy &s,
       if (ap < bp) return false;
       else if (ap > bp) equal = false;
     }
+    return true;
+  };
+
+  if (TableContingencyIterator::IsTable(m_nfg)) {
+    for (TableContingencyIterator iter(*this); !iter.AtEnd(); iter++) {
+      if (!compare(iter.GetStrategyValue<Rational>(s),
+		   iter.GetStrategyValue<Rational>(t))) {
+	return false;
+      }
+    }
+  }
+  else {
+    for (StrategyProfileIterator iter(*this); !iter.AtEnd(); iter++) {
+      if (!compare((*iter)->GetStrategyValue(s),
+		   (*iter)->GetStrategyValue(t))) {
+	return false;
+      }
+    }
   }
 
   return (p_strict || !equal);
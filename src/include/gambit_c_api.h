@@ -9,6 +9,11 @@ extern "C"
 {
 #endif
 
+// Sets the number of threads the solvers may use; 1, the default, keeps
+// them on the calling thread, and 0 uses one per hardware thread.
+// Returns 0 on success and -1 if the number is negative.
+int gambit_set_num_threads(const int num_threads);
+
 double* nfggnm_c(const int num_players, const double *pay_off_data, const int data_length, const int *num_strats, const int number_of_perturbations, int *equilibriums_buffer_size, int *number_of_equilibriums);
 
 
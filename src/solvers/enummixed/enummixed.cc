@@ -81,35 +81,9 @@ EnumMixedStrategySolver<T>::SolveDetailed(const Game &p_game) const
   }
   shared_ptr<EnumMixedStrategySolution<T> > solution = new EnumMixedStrategySolution<T>(p_game);
 
-  PureStrategyProfile profile = p_game->NewPureStrategyProfile();
-
-  Rational min = p_game->GetMinPayoff();
-  if (min > Rational(0)) {
-    min = Rational(0);
-  }
-  min -= Rational(1);
-
-  Rational max = p_game->GetMaxPayoff();
-  if (max < Rational(0)) {
-    max = Rational(0);
-  }
-
-  Rational fac(1, max - min);
-
   // Construct matrices A1, A2
-  Matrix<T> A1(1, p_game->Players()[1]->Strategies().size(),
-	       1, p_game->Players()[2]->Strategies().size());
-  Matrix<T> A2(1, p_game->Players()[2]->Strategies().size(),
-	       1, p_game->Players()[1]->Strategies().size());
-
-  for (size_t i = 1; i <= p_game->Players()[1]->Strategies().size(); i++) {
-    profile->SetStrategy(p_game->Players()[1]->Strategies()[i]);
-    for (size_t j = 1; j <= p_game->Players()[2]->Strategies().size(); j++) {
-      profile->SetStrategy(p_game->Players()[2]->Strategies()[j]);
-      A1(i, j) = fac * (profile->GetPayoff(1) - min);
-      A2(j, i) = fac * (profile->GetPayoff(2) - min);
-    }
-  }
+  std::shared_ptr<NormalizedBimatrix<T> > bimatrix = NormalizedBimatrix<T>::Get(p_game);
+  const Matrix<T> &A1 = bimatrix->A1, &A2 = bimatrix->A2;
 
   // Construct vectors b1, b2
   Vector<T> b1(1, p_game->Players()[1]->Strategies().size());
@@ -0,0 +1,234 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2022, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/solvers/enumpure/enumpure.cc
+// Enumerate pure-strategy equilibrium profiles of games
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "gambit.h"
+#include "games/gametable.h"
+#include "games/gamedouble.h"
+#include "solvers/enumpure/enumpure.h"
+
+namespace Gambit {
+namespace Nash {
+
+namespace {
+
+/// The smallest number of sets of contingencies worth giving a thread
+/// of its own
+const long MIN_SLICES_PER_THREAD = 4096;
+
+//
+// Clears p_isNash at each contingency where the player is not playing a
+// best response.  p_values holds the payoff (or the rank of the payoff)
+// of the player at each contingency, in the order of the .nfg payoff
+// format.  The contingencies differing only in the player's strategy are
+// p_stride apart, so they fall into blocks of p_stride * p_numStrategies
+// contingencies; within each block, the best payoffs are found for a run
+// of consecutive sets at once, in one sweep over the block.
+//
+template <class T>
+void MarkBestResponses(const T *p_values, long p_stride, int p_numStrategies,
+		       long p_numContingencies, std::vector<char> &p_isNash)
+{
+  long numSlices = p_numContingencies / p_numStrategies;
+
+  auto work = [&](long p_begin, long p_end) {
+    std::vector<T> best;
+    for (long slice = p_begin; slice < p_end; ) {
+      long inner = slice % p_stride;
+      long length = std::min(p_stride - inner, p_end - slice);
+      const T *block = p_values + (slice / p_stride) * p_stride * p_numStrategies + inner;
+      char *isNash = &p_isNash[0] + (block - p_values);
+
+      best.assign(block, block + length);
+      for (int st = 1; st < p_numStrategies; st++) {
+	const T *values = block + st * p_stride;
+	for (long i = 0; i < length; i++) {
+	  if (values[i] > best[i])  best[i] = values[i];
+	}
+      }
+      for (int st = 0; st < p_numStrategies; st++) {
+	const T *values = block + st * p_stride;
+	char *flags = isNash + st * p_stride;
+	for (long i = 0; i < length; i++) {
+	  if (values[i] != best[i])  flags[i] = 0;
+	}
+      }
+      slice += length;
+    }
+  };
+
+  long numThreads = GetNumThreads();
+  numThreads = std::max(1L, std::min(numThreads,
+				     numSlices / MIN_SLICES_PER_THREAD));
+  std::vector<std::thread> threads;
+  for (long i = 1; i < numThreads; i++) {
+    threads.push_back(std::thread(work, numSlices * i / numThreads,
+				  numSlices * (i + 1) / numThreads));
+  }
+  work(0, numSlices / numThreads);
+  for (size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+}
+
+//
+// Replaces each payoff by its rank among the distinct payoffs, so that
+// the ranks compare as the payoffs do, but at the cost of an integer
+// comparison rather than a rational one.  As p_approx holds the double
+// nearest each payoff, the payoffs are sorted on these, and the exact
+// values, given by p_exact, are compared only where these are equal,
+// and not all of the payoffs have exact values given by their doubles,
+// as p_fromDouble tells.
+//
+template <class F, class G>
+std::vector<int> RankPayoffs(const std::vector<double> &p_approx,
+			     const F &p_exact, const G &p_fromDouble)
+{
+  std::vector<int> order(p_approx.size());
+  for (size_t i = 0; i < order.size(); i++)  order[i] = i;
+  std::sort(order.begin(), order.end(),
+	    [&p_approx](int a, int b) { return p_approx[a] < p_approx[b]; });
+
+  std::vector<int> ranks(p_approx.size());
+  int rank = -1;
+  for (size_t begin = 0, end; begin < order.size(); begin = end) {
+    for (end = begin + 1;
+	 end < order.size() && p_approx[order[end]] == p_approx[order[begin]];
+	 end++);
+    size_t i;
+    for (i = begin; i < end && p_fromDouble(order[i]); i++);
+    if (i < end) {
+      const Rational &first = p_exact(order[begin]);
+      for (i = begin + 1; i < end && p_exact(order[i]) == first; i++);
+    }
+    if (i == end) {
+      rank++;
+      for (i = begin; i < end; ranks[order[i++]] = rank);
+      continue;
+    }
+    std::sort(order.begin() + begin, order.begin() + end,
+	      [&p_exact](int a, int b) { return p_exact(a) < p_exact(b); });
+    for (i = begin; i < end; i++) {
+      if (i == begin || p_exact(order[i-1]) < p_exact(order[i]))  rank++;
+      ranks[order[i]] = rank;
+    }
+  }
+  return ranks;
+}
+
+}  // end anonymous namespace
+
+List<MixedStrategyProfile<Rational> >
+EnumPureStrategySolver::Solve(const Game &p_game) const
+{
+  if (!p_game->IsPerfectRecall()) {
+    throw UndefinedException("Computing equilibria of games with imperfect recall is not supported.");
+  }
+
+  const GameDoubleTableRep *table =
+    dynamic_cast<const GameDoubleTableRep *>(&*p_game);
+  if (!table && !dynamic_cast<const GameTableRep *>(&*p_game)) {
+    // Other representations compute each payoff on request, so rather
+    // than gather them all, each contingency is checked as it is reached
+    List<MixedStrategyProfile<Rational> > solutions;
+    for (StrategyProfileIterator citer(p_game); !citer.AtEnd(); citer++) {
+      if ((*citer)->IsNash()) {
+	MixedStrategyProfile<Rational> profile = (*citer)->ToMixedStrategyProfile();
+	m_onEquilibrium->Render(profile);
+	solutions.Append(profile);
+      }
+    }
+    return solutions;
+  }
+
+  Array<int> dim = p_game->NumStrategies();
+  long numContingencies = (table) ? table->NumContingencies() :
+    p_game->NumStrategyContingencies();
+  std::vector<char> isNash(numContingencies, 1);
+
+  if (table) {
+    long stride = 1;
+    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+      MarkBestResponses(table->GetPayoffs(pl), stride, dim[pl],
+			numContingencies, isNash);
+      stride *= dim[pl];
+    }
+  }
+  else {
+    // Payoffs are ranked over the outcomes, rather than the contingencies;
+    // the null outcome, number 0, pays zero to all players
+    std::vector<int> outcomes(numContingencies);
+    long index = 0;
+    for (StrategyProfileIterator citer(p_game); !citer.AtEnd(); citer++) {
+      GameOutcome outcome = (*citer)->GetOutcome();
+      outcomes[index++] = (outcome) ? outcome->GetNumber() : 0;
+    }
+
+    std::vector<GameOutcomeRep *> outcomeList(p_game->NumOutcomes() + 1, 0);
+    for (int outc = 1; outc <= p_game->NumOutcomes(); outc++) {
+      outcomeList[outc] = p_game->GetOutcome(outc);
+    }
+    Rational zero(0);
+    std::vector<int> values(numContingencies);
+    long stride = 1;
+    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+      std::vector<double> approx(outcomeList.size(), 0.0);
+      for (size_t outc = 1; outc < outcomeList.size(); outc++) {
+	approx[outc] = outcomeList[outc]->GetPayoff<double>(pl);
+      }
+      std::vector<int> ranks =
+	RankPayoffs(approx,
+		    [&](int outc) -> const Rational & {
+		      return (outc) ? outcomeList[outc]->GetPayoff<Rational>(pl) : zero;
+		    },
+		    [&](int outc) {
+		      return !outc || outcomeList[outc]->GetPayoff<Number>(pl).IsFromDouble();
+		    });
+      for (long cont = 0; cont < numContingencies; cont++) {
+	values[cont] = ranks[outcomes[cont]];
+      }
+      MarkBestResponses(&values[0], stride, dim[pl], numContingencies, isNash);
+      stride *= dim[pl];
+    }
+  }
+
+  List<MixedStrategyProfile<Rational> > solutions;
+  PureStrategyProfile profile = p_game->NewPureStrategyProfile();
+  for (long cont = 0; cont < numContingencies; cont++) {
+    if (!isNash[cont])  continue;
+    long rest = cont;
+    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+      profile->SetStrategy(p_game->GetPlayer(pl)->GetStrategy(rest % dim[pl] + 1));
+      rest /= dim[pl];
+    }
+    MixedStrategyProfile<Rational> mixed = profile->ToMixedStrategyProfile();
+    m_onEquilibrium->Render(mixed);
+    solutions.Append(mixed);
+  }
+  return solutions;
+}
+
+}  // end namespace Gambit::Nash
+}  // end namespace Gambit
@@ -31,7 +31,14 @@ namespace Nash {
 ///
 /// Enumerate pure-strategy Nash equilibria of a game.  By definition,
 /// pure-strategy equilibrium uses the strategic representation of a game.
-/// 
+///
+/// The payoffs of each player are gathered once into a table over the
+/// contingencies.  For each player, one pass over the table finds the
+/// best payoff in each set of contingencies differing only in that
+/// player's strategy; a contingency is an equilibrium if every player's
+/// payoff there is the best in its set.  The sets of each player are
+/// divided among the available hardware threads.
+///
 class EnumPureStrategySolver : public StrategySolver<Rational> {
 public:
    EnumPureStrategySolver(shared_ptr<StrategyProfileRenderer<Rational> > p_onEquilibrium = 0) 
@@ -41,23 +48,6 @@ public:
   List<MixedStrategyProfile<Rational> > Solve(const Game &p_game) const;
 };
 
-inline List<MixedStrategyProfile<Rational> >
-EnumPureStrategySolver::Solve(const Game &p_game) const
-{
-  if (!p_game->IsPerfectRecall()) {
-    throw UndefinedException("Computing equilibria of games with imperfect recall is not supported.");
-  }
-  List<MixedStrategyProfile<Rational> > solutions;
-  for (StrategyProfileIterator citer(p_game); !citer.AtEnd(); citer++) {
-    if ((*citer)->IsNash()) {
-      MixedStrategyProfile<Rational> profile = (*citer)->ToMixedStrategyProfile();
-      m_onEquilibrium->Render(profile);
-      solutions.Append(profile);
-    }
-  }
-  return solutions;
-}
-
 ///
 /// Enumerate pure-strategy agent Nash equilibria of a game.  This uses
 /// the extensive representation.  Agent Nash equilibria are not necessarily
@@ -42,7 +42,7 @@ NashGNMStrategySolver::ToProfile(const Game &p_game,
 
 List<MixedStrategyProfile<double> >
 NashGNMStrategySolver::Solve(const Game &p_game,
-			     shared_ptr<gnmgame> p_rep,
+			     std::shared_ptr<gnmgame> p_rep,
 			     const cvector &p_pert) const
 {
   const int STEPS = 100;
@@ -66,47 +66,26 @@ NashGNMStrategySolver::Solve(const Game &p_game,
   for (int i = 0; i < numEq; i++) {
     eqa.push_back(ToProfile(p_game, *answers[i]));
     m_onEquilibrium->Render(eqa.back());
-    free(answers[i]);
+    delete answers[i];
   }
   free(answers);
   return eqa;
 }
 
-shared_ptr<gnmgame>
+std::shared_ptr<gnmgame>
 NashGNMStrategySolver::BuildRepresentation(const Game &p_game) const
 {
   if (p_game->IsAgg()) {
-    return new aggame(dynamic_cast<GameAggRep &>(*p_game));
-  }
-  else {
-    Rational maxPay = p_game->GetMaxPayoff();
-    Rational minPay = p_game->GetMinPayoff();
-    double scale = 1.0 / (maxPay - minPay);
-
-    std::vector<int> actions(p_game->NumPlayers());
-    int veclength = p_game->NumPlayers();
-    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-      actions[pl-1] = p_game->GetPlayer(pl)->NumStrategies();
-      veclength *= p_game->GetPlayer(pl)->NumStrategies();
-    }
-    cvector payoffs(veclength);
-  
-    shared_ptr<gnmgame> A = new nfgame(p_game->NumPlayers(), actions, payoffs);
-  
-    std::vector<int> profile(p_game->NumPlayers());
-    for (StrategyProfileIterator iter(p_game); !iter.AtEnd(); iter++) {
-      for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-        profile[pl-1] = (*iter)->GetStrategy(pl)->GetNumber() - 1;
-      }
-
-      for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-        A->setPurePayoff(pl-1, profile,
-		       (double) ((*iter)->GetPayoff(pl) - minPay) *
-		       scale);
-      }
-    }
-    return A;
+    return std::shared_ptr<gnmgame>(new aggame(dynamic_cast<GameAggRep &>(*p_game)));
   }
+  // A table or sequence form is only read while solving, so one is kept
+  // with the game, to be shared by all calls until the game changes.
+  // Its payoffs are scaled to lie between zero and one.
+  return p_game->GetRepresentation<gnmgame>("gnm", [&p_game]() {
+      PayoffSummary summary = p_game->GetPayoffSummary();
+      return NewGnmGame(p_game, -summary.GetMin<Rational>(),
+			1.0 / summary.GetRange<Rational>());
+    });
 }
  
 List<MixedStrategyProfile<double> >
@@ -116,7 +95,7 @@ NashGNMStrategySolver::Solve(const Game &p_game) const
     throw UndefinedException("Computing equilibria of games with imperfect recall is not supported.");
   }
 
-  Gambit::shared_ptr<gnmgame> A = BuildRepresentation(p_game);
+  std::shared_ptr<gnmgame> A = BuildRepresentation(p_game);
   cvector g(A->getNumActions()); 
   g[0] = 1.0;
   for (int i = 1; i < A->getNumActions(); i++) {
@@ -134,7 +113,7 @@ NashGNMStrategySolver::Solve(const Game &p_game,
   }
 
   List<MixedStrategyProfile<double> > solutions;
-  Gambit::shared_ptr<gnmgame> A = BuildRepresentation(p_game);
+  std::shared_ptr<gnmgame> A = BuildRepresentation(p_game);
   cvector g(A->getNumActions());
   for (int i = 0; i < A->getNumActions(); i++) {
     g[i] = p_pert[i+1];
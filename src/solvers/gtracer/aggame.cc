@@ -34,21 +34,21 @@ void aggame::computePartialP_PureNode(int player1,int act1, std::vector<int>& ta
     std::vector<agg::AggNumber> strat (numNei);
     agg::AGG::config    a(numNei,0);
     //compute the full distrib
-    aggPtr->computeP (player1,act1);
+    aggPtr->computeP (context, player1,act1);
 
     //store the full distrib in Pr[player1]
-    aggPtr->Pr[player1].swap(aggPtr->Pr[numPlayers-1]);
+    context.Pr[player1].swap(context.Pr[numPlayers-1]);
     for(i=0;i<(int)tasks.size();i++){
       //assert(tasks[i]!=player1);
-      agg::aggdistrib& P = aggPtr->Pr[tasks[i]];
+      agg::aggdistrib& P = context.Pr[tasks[i]];
       //P.clear();  // to get ready for division, we need clear()
-      P=aggPtr->Pr[player1];
+      P=context.Pr[player1];
 
       bool NullOnly =true;
       for(j=0;j<numNei;++j){
 	a[j]++;
-	agg::aggdistrib::iterator pp = aggPtr->projectedStrat[Node][tasks[i]].find(a);
-	if (pp== aggPtr->projectedStrat[Node][tasks[i]].end()) {
+	agg::aggdistrib::iterator pp = context.projectedStrat[Node][tasks[i]].find(a);
+	if (pp== context.projectedStrat[Node][tasks[i]].end()) {
 	    strat[j]=0;
 	}
 	else {
@@ -90,7 +90,7 @@ void aggame::computePartialP_bisect(int player1,int act1,
     <<", act1="<<act1<<" *start="<<*start<<" *(endp-1)="<<*(endp-1)
     <<", (endp-start)="<< endp-start <<endl;
 #endif
-  if(endp-start==1){aggPtr->Pr[*start].reset();return;}
+  if(endp-start==1){context.Pr[*start].reset();return;}
   int Node = aggPtr->actionSets[player1][act1];
   int numNei=aggPtr->neighbors[Node].size();
 
@@ -105,27 +105,27 @@ void aggame::computePartialP_bisect(int player1,int act1,
 
 
   temp.reset();
-  temp = aggPtr->projectedStrat[Node][*start];
-  if (mid-start>1) temp.multiply(aggPtr->Pr[*start],numNei,aggPtr->projFunctions[Node]);
+  temp = context.projectedStrat[Node][*start];
+  if (mid-start>1) temp.multiply(context.Pr[*start],numNei,aggPtr->projFunctions[Node]);
 
   if (mid-start==1) {
-    //assert(aggPtr->Pr[*start].empty());
-    aggPtr->Pr[*start]= aggPtr->projectedStrat[Node][*mid];
-    if(endp-mid>1) aggPtr->Pr[*start].multiply(aggPtr->Pr[*mid],numNei,aggPtr->projFunctions[Node]);
+    //assert(context.Pr[*start].empty());
+    context.Pr[*start]= context.projectedStrat[Node][*mid];
+    if(endp-mid>1) context.Pr[*start].multiply(context.Pr[*mid],numNei,aggPtr->projFunctions[Node]);
   }
   else for (ptr=start; ptr!=mid; ++ptr){
     player2= *ptr;
-    aggPtr->Pr[player2].multiply(aggPtr->projectedStrat[Node][*mid],numNei,aggPtr->projFunctions[Node] );
-    if(endp-mid>1) aggPtr->Pr[player2].multiply(aggPtr->Pr[*mid],numNei,aggPtr->projFunctions[Node]);
+    context.Pr[player2].multiply(context.projectedStrat[Node][*mid],numNei,aggPtr->projFunctions[Node] );
+    if(endp-mid>1) context.Pr[player2].multiply(context.Pr[*mid],numNei,aggPtr->projFunctions[Node]);
   }
 
   if(endp-mid==1){
-    //assert(aggPtr->Pr[*mid].empty());
-    aggPtr->Pr[*mid]=temp;
+    //assert(context.Pr[*mid].empty());
+    context.Pr[*mid]=temp;
   }
   else for (ptr=mid;ptr!=endp;++ptr){
     player2=*ptr;
-    aggPtr->Pr[player2].multiply(temp,numNei, aggPtr->projFunctions[Node]);
+    context.Pr[player2].multiply(temp,numNei, aggPtr->projFunctions[Node]);
 
   }
 
@@ -144,16 +144,16 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 #endif
   agg::AggNumber fuzzcount;
   int rown, coln, rowi, coli,act1,act2,currNode,numNei;
-  static std::vector<int>::iterator p;
-  static std::vector<int> tasks,spares,nontasks;
+  std::vector<int>::iterator p;
+  std::vector<int> tasks,spares,nontasks;
   tasks.reserve(aggPtr->numPlayers);
   spares.reserve(aggPtr->numPlayers);
   nontasks.reserve(aggPtr->numPlayers);
-  aggPtr->cache.reset();
+  context.cache.reset();
 
   //do projection
   for(int Node=0; Node< aggPtr->numActionNodes; Node++)
-	aggPtr->doProjection(Node,s.values());
+	aggPtr->doProjection(context, Node,s.values());
 
   //deal with the diagonal
   for (rown=0; rown<aggPtr->numPlayers; ++rown){
@@ -165,15 +165,29 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 	    }
 	  }
   }
+  //rows at action nodes whose evaluation plan is kept densely are
+  //computed from the plan, one node at a time
+  bool densePlans = aggPtr->numPlayers>1;
+  if (densePlans) {
+    std::vector<agg::AggNumber> sp(s.values(), s.values()+s.getm());
+    for(int Node=0; Node< aggPtr->numActionNodes; Node++)if(aggPtr->isDensePlan(Node)){
+      aggPtr->computePlan(context, Node, sp);
+      for (rown=0; rown<aggPtr->numPlayers; ++rown)if(aggPtr->node2Action[Node][rown]!=-1){
+	act1=aggPtr->node2Action[Node][rown];
+	aggPtr->getPlanJ(context, dest[act1+firstAction(rown)], Node, rown, act1);
+      }
+    }
+  }
   for(rown=0;rown<aggPtr->numPlayers; ++rown){   //rown: the row player
 	for(act1=0;act1<aggPtr->actions[rown];act1++){  //act1: player rown's action
 
 	    currNode =aggPtr->actionSets[rown][act1];
+	    if (densePlans && aggPtr->isDensePlan(currNode)) continue;
 	    numNei= aggPtr->neighbors[currNode].size();
 #ifdef AGGDEBUG
             cout<<"for player "<<rown<<", action "<<act1
                 <<", action node "<<currNode<<endl;
-	    cout<< "cache is: "<<endl<<aggPtr->cache<<endl;
+	    cout<< "cache is: "<<endl<<context.cache<<endl;
 #endif
 	    tasks.clear();  //for these col players, we need to compute the distribution induced by their complements. input of the bisection alg
 	    spares.clear(); //these col players have only one projected action
@@ -197,8 +211,8 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
                 copy(key.begin(),key.end(),ostream_iterator<int>(cout," ") );
                 cout<<"]\n";
 #endif
-	        agg::aggdistrib::iterator r= aggPtr->cache.findExact(key);
-	        if (r!=aggPtr->cache.end()){
+	        agg::aggdistrib::iterator r= context.cache.findExact(key);
+	        if (r!=context.cache.end()){
 	          dest[act1+firstAction(rown)][act2+firstAction(coln)]=r->second;
 	        }
 	        else{
@@ -232,33 +246,33 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 	    if(aggPtr->isPure[currNode]||tasks.size()==0){
 	      computePartialP_PureNode(rown, act1,tasks);
 	    }else{//do bisection
-	      computePartialP_bisect(rown,act1,tasks.begin(),tasks.end(),aggPtr->Pr[rown]);
+	      computePartialP_bisect(rown,act1,tasks.begin(),tasks.end(),context.Pr[rown]);
 #ifdef AGGDEBUG
               cout<<"after calling computePartialP_bisect:"<<endl;
               for (int tt=0;tt<tasks.size();tt++){
                 cout<<"for player "<<tasks[tt]<<endl;
-                cout<<aggPtr->Pr[tasks[tt]]<<endl;
+                cout<<context.Pr[tasks[tt]]<<endl;
               }
 #endif
 	      //now apply rown's action (act1), and the strategies of
 	      //players in nontasks
-          aggPtr->Pr[rown].reset();
-          aggPtr->Pr[rown].insert(
+          context.Pr[rown].reset();
+          context.Pr[rown].insert(
 		    make_pair(aggPtr->projection[currNode][rown][act1],1.0));
 	      for(p=nontasks.begin();p!=nontasks.end();++p)
-	    	  aggPtr->Pr[rown].multiply(aggPtr->projectedStrat[currNode][*p],numNei, aggPtr->projFunctions[currNode]);
+	    	  context.Pr[rown].multiply(context.projectedStrat[currNode][*p],numNei, aggPtr->projFunctions[currNode]);
 #ifdef AGGDEBUG
               cout<<"the polynomial product of strats of player "
                   <<rown<< " and players in the vector nontasks is:"
                   <<endl;
-              cout<<aggPtr->Pr[rown]<<endl;
+              cout<<context.Pr[rown]<<endl;
 #endif
 	      if (tasks.size()==1){
-	    	  aggPtr->Pr[tasks[0]]=aggPtr->Pr[rown];
+	    	  context.Pr[tasks[0]]=context.Pr[rown];
 	      }
 	      else {
                 for(p=tasks.begin();p!=tasks.end();++p){
-		  if(aggPtr->Pr[*p].size()==0){
+		  if(context.Pr[*p].size()==0){
 		    std::cerr<<"AGG::payoffMatrix() ERROR for rown="
 		        <<rown<<" act1="<<act1<<" *p=" <<*p
 			     <<": the distribution should not be empty!"<<std::endl;
@@ -267,8 +281,8 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 #endif
 
 		  }
-		  aggPtr->Pr[*p].multiply(
-				  aggPtr->Pr[rown],numNei,aggPtr->projFunctions[currNode]);
+		  context.Pr[*p].multiply(
+				  context.Pr[rown],numNei,aggPtr->projFunctions[currNode]);
 	        }//end for(p=tasks.begin...
 	      }
 
@@ -277,10 +291,10 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 	      //we store this distrib in Pr[rown][act1][rown]
 	      if (spares.size()>0){
 		//assert(tasks.size()>0);
-	    	  aggPtr->Pr[rown].reset();
-	    	  aggPtr->Pr[rown].multiply(
-	    			  aggPtr->Pr[tasks[0]],
-	    			  aggPtr->projectedStrat[currNode][tasks[0]],numNei,aggPtr->projFunctions[currNode]);
+	    	  context.Pr[rown].reset();
+	    	  context.Pr[rown].multiply(
+	    			  context.Pr[tasks[0]],
+	    			  context.projectedStrat[currNode][tasks[0]],numNei,aggPtr->projFunctions[currNode]);
 	      }
 	    } //end else
 #ifdef AGGDEBUG
@@ -288,7 +302,7 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
                 <<endl;
             for (int tt = 0;tt<numPlayers;tt++){
               cout<<"for player "<<tt<<endl;
-              cout<<aggPtr->Pr[tt];
+              cout<<context.Pr[tt];
               cout<<endl;
             }
 #endif
@@ -300,19 +314,19 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 	      computeUndisturbedPayoff(undisturbedPayoff,hasUndisturbed,rown,act1, rown);
 	      for(p=spares.begin();p!=spares.end();++p)
 		for(act2=0;act2<aggPtr->actions[*p];act2++)
-		  savePayoff(dest,rown,act1,*p,act2, undisturbedPayoff,aggPtr->cache);
+		  savePayoff(dest,rown,act1,*p,act2, undisturbedPayoff,context.cache);
 
 	    }
 	    for(p=tasks.begin();p!=tasks.end();++p){
 	      for(act2=0;act2<aggPtr->actions[*p];act2++){//act2: col action
 
-		if (aggPtr->projectedStrat[currNode][*p].size()==1  &&
-				aggPtr->projectedStrat[currNode][*p].begin()->first==aggPtr->projection[currNode][*p][act2])
+		if (context.projectedStrat[currNode][*p].size()==1  &&
+				context.projectedStrat[currNode][*p].begin()->first==aggPtr->projection[currNode][*p][act2])
 		{
 		  computeUndisturbedPayoff(undisturbedPayoff,hasUndisturbed,rown,act1,*p);
-		  savePayoff(dest,rown,act1,*p,act2,undisturbedPayoff,aggPtr->cache);
+		  savePayoff(dest,rown,act1,*p,act2,undisturbedPayoff,context.cache);
 		}
-		computePayoff(dest,rown,act1,*p,act2,aggPtr->cache);
+		computePayoff(dest,rown,act1,*p,act2,context.cache);
 	      }//end for(act2
 	    }//end for(p
 	}//end for(act1
@@ -326,11 +340,11 @@ void aggame::computeUndisturbedPayoff(agg::AggNumber& undisturbedPayoff,bool& ha
   int    Node =aggPtr->actionSets[player1][act1];
   int    numNei= aggPtr->neighbors[Node].size();
   if (player2==player1){
-    undisturbedPayoff=aggPtr->Pr[player2].inner_prod(aggPtr->payoffs[Node]);
+    undisturbedPayoff=context.Pr[player2].inner_prod(aggPtr->payoffs[Node]);
   }else{
-    //assert(aggPtr->projectedStrat[Node][player2].size()==1);
-    undisturbedPayoff=aggPtr->Pr[player2].inner_prod(
-    		aggPtr->projectedStrat[Node][player2].begin()->first,numNei,aggPtr->projFunctions[Node],aggPtr->payoffs[Node]);
+    //assert(context.projectedStrat[Node][player2].size()==1);
+    undisturbedPayoff=context.Pr[player2].inner_prod(
+    		context.projectedStrat[Node][player2].begin()->first,numNei,aggPtr->projFunctions[Node],aggPtr->payoffs[Node]);
   }
   has=true;
 }
@@ -375,7 +389,7 @@ void aggame::computePayoff(cmatrix& dest,int player1,int act1,int player2,int ac
   if (! r.second) {
     dest[act1+firstAction(player1)][act2+firstAction(player2)]=r.first->second;
   }else{
-    r.first->second=aggPtr->Pr[player2].inner_prod(
+    r.first->second=context.Pr[player2].inner_prod(
     		aggPtr->projection[Node][player2][act2],numNei,aggPtr->projFunctions[Node],aggPtr->payoffs[Node]);
     savePayoff(dest,player1,act1,player2,act2,r.first->second,cache,r.second);
   }
@@ -385,12 +399,11 @@ void aggame::computePayoff(cmatrix& dest,int player1,int act1,int player2,int ac
 
 void aggame::SymPayoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
   if (getNumPlayerClasses()>1){
-    std::cerr<<"SymPayoffMatrix() Error: game is not symmetric"<<std::endl;
-    exit(1);
+    throw Gambit::UndefinedException("SymPayoffMatrix() Error: game is not symmetric");
   }
   //assert(getNumPlayers()>1);
 
-  aggPtr->cache.clear();
+  context.cache.clear();
 
   agg::AggNumber fuzzcount;
 
@@ -400,10 +413,10 @@ void aggame::SymPayoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
     numNei= aggPtr->neighbors[currNode].size();
     //std::vector<int> key (numNei+1);
     //key[numNei]=currNode;
-    aggPtr->doProjection(currNode,0,&(s[firstAction(0)]));
-    agg::aggdistrib &Pdest = aggPtr->Pr[numPlayers-1];
-    aggPtr->projectedStrat[currNode][0].power(numPlayers-2, Pdest, aggPtr->Pr[numPlayers-2],numNei,aggPtr->projFunctions[currNode]);
-    agg::aggdistrib &temp=aggPtr->Pr[numPlayers-2];
+    aggPtr->doProjection(context, currNode,0,&(s[firstAction(0)]));
+    agg::aggdistrib &Pdest = context.Pr[numPlayers-1];
+    context.projectedStrat[currNode][0].power(numPlayers-2, Pdest, context.Pr[numPlayers-2],numNei,aggPtr->projFunctions[currNode]);
+    agg::aggdistrib &temp=context.Pr[numPlayers-2];
     temp.reset();
     temp.insert(make_pair(aggPtr->projection[currNode][0][rowa],1));
     Pdest.multiply(temp,numNei,aggPtr->projFunctions[currNode]);
@@ -412,7 +425,7 @@ void aggame::SymPayoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 
       //insPair.first.reserve(numNei+3);
       insPair.first.push_back(currNode);
-      std::pair<agg::trie_map<agg::AggNumber>::iterator,bool> r =aggPtr->cache.insert(insPair);
+      std::pair<agg::trie_map<agg::AggNumber>::iterator,bool> r =context.cache.insert(insPair);
 
       if (! r.second) {
           dest[rowa][cola]=r.first->second;
@@ -450,7 +463,7 @@ void aggame::KSymPayoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 
           dest[rowa+firstKSymAction(rowcls)][cola+firstKSymAction(colcls)]=
               (agg::AggNumber)multiplier *
-              aggPtr->getKSymMixedPayoff(sp,rowcls,rowa,colcls,cola);
+              aggPtr->getKSymMixedPayoff(context, sp,rowcls,rowa,colcls,cola);
         }
       }
     }
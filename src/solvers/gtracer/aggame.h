@@ -47,13 +47,13 @@ class aggame : public gnmgame {
 
     aggame ( Gambit::agg::AGG *_aggPtr)
       :gnmgame(_aggPtr->getNumPlayers(), _aggPtr->actions),
-      aggPtr (_aggPtr)
+      aggPtr (_aggPtr), context(*_aggPtr)
     {
     }
 
     aggame(Gambit::GameAggRep& g)
       :gnmgame(g.aggPtr->getNumPlayers(), g.aggPtr->actions),
-      aggPtr (g.aggPtr)
+      aggPtr (g.aggPtr), context(*g.aggPtr)
     {
     }
 
@@ -66,12 +66,12 @@ class aggame : public gnmgame {
 
     double getMixedPayoff(int player, cvector &s){
       std::vector<double> sp (s.values(), s.values()+s.getm());
-      return (double)aggPtr->getMixedPayoff(player,sp);
+      return (double)aggPtr->getMixedPayoff(context,player,sp);
     }
 
     double getKSymMixedPayoff(int cls, cvector &s){
       std::vector<double> sp (s.values(), s.values()+s.getm());
-      return (double) aggPtr->getKSymMixedPayoff(cls,sp);
+      return (double) aggPtr->getKSymMixedPayoff(context,cls,sp);
     }
 
     void payoffMatrix(cmatrix &dest, cvector &s, double fuzz);
@@ -92,19 +92,28 @@ class aggame : public gnmgame {
       cvector & ss = const_cast<cvector &>(s);
       std::vector<double> sp (ss.values(), ss.values()+ss.getm());
       std::vector<double> d(aggPtr->getNumActions(player));
-      aggPtr->getPayoffVector(d,player,sp);
+      aggPtr->getPayoffVector(context,d,player,sp);
+      std::copy(d.begin(),d.end(), dest.values());
+    }
+    //all the players at once, so that the evaluation plan of each action
+    //node is shared among them
+    void getPayoffVectors(cvector &dest, const cvector &s){
+      cvector & ss = const_cast<cvector &>(s);
+      std::vector<double> sp (ss.values(), ss.values()+ss.getm());
+      std::vector<double> d(aggPtr->getNumActions());
+      aggPtr->getPayoffVectors(context,d,sp);
       std::copy(d.begin(),d.end(), dest.values());
     }
     void getSymPayoffVector(cvector& dest, cvector &s){
       std::vector<double> sp (s.values(), s.values()+s.getm());
       std::vector<double> d(aggPtr->getNumActionNodes());
-      aggPtr->getSymPayoffVector(d,sp);
+      aggPtr->getSymPayoffVector(context,d,sp);
       std::copy(d.begin(),d.end(), dest.values());
     }
     void getKSymPayoffVector(cvector &dest, int playerClass, cvector &s){
       std::vector<double> sp (s.values(), s.values()+s.getm());
       std::vector<double> d (aggPtr->getNumKSymActions(playerClass));
-      aggPtr->getKSymPayoffVector(d,playerClass,sp);
+      aggPtr->getKSymPayoffVector(context,d,playerClass,sp);
       std::copy(d.begin(),d.end(), dest.values());
     }
     double getPurePayoff(int player, std::vector<int> &s){
@@ -139,6 +148,9 @@ class aggame : public gnmgame {
     Gambit::agg::AGG *aggPtr;
 
   private:
+    //scratch space for evaluating aggPtr; each aggame has its own, so
+    //several of them can share one AGG across threads
+    Gambit::agg::AGG::EvalContext context;
 
   //helper functions for computing jacobian
     void computePartialP_PureNode(int player,int act,std::vector<int>& tasks);
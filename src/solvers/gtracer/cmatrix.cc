@@ -37,8 +37,7 @@ cmatrix::~cmatrix()
 
 cmatrix cmatrix::inv(bool &worked) const {
 	if (m!=n) {
-		std::cerr << "invalid cmatrix inverse" << std::endl;
-		exit(1);
+		throw Gambit::DimensionException("invalid cmatrix inverse");
 	}
 	cmatrix temp(n,n);
 	int *ix = new int[n];
@@ -66,8 +65,7 @@ cmatrix cmatrix::inv(bool &worked) const {
 
 int cmatrix::LUdecomp(cmatrix &LU, int *ix) const {
 	if (m!=n||LU.m!=LU.n||LU.n!=n) {
-		std::cerr << "invalid cmatrix in LUdecomp" << std::endl;
-		exit(1);
+		throw Gambit::DimensionException("invalid cmatrix in LUdecomp");
 	}
 	int d=1,i,j,k;
 	LU = *this;
@@ -126,8 +124,7 @@ int cmatrix::LUdecomp(cmatrix &LU, int *ix) const {
 
 void cmatrix::LUbacksub(int *ix, double *b) const {
 	if (n!=m) {
-		std::cerr << "invalid cmatrix in LUbacksub" << std::endl;
-		exit(1);
+		throw Gambit::DimensionException("invalid cmatrix in LUbacksub");
 	}
 	int ip,ii=-1,i;
 	double sum;
@@ -150,8 +147,7 @@ void cmatrix::LUbacksub(int *ix, double *b) const {
 
 bool cmatrix::solve(cvector &b, cvector &ret) {
 	if (m!=n) {
-		std::cerr << "invalid cmatrix in solve" << std::endl;
-		exit(1);
+		throw Gambit::DimensionException("invalid cmatrix in solve");
 	}
 	for(int i=0;i<n;i++) ret[i] = b[i];
 	int *ix = new int[n];
@@ -167,8 +163,7 @@ bool cmatrix::solve(cvector &b, cvector &ret) {
 }
 double *cmatrix::solve(const double *b, bool &worked) const {
 	if (m!=n) {
-		std::cerr << "invalid cmatrix in solve" << std::endl;
-		exit(1);
+		throw Gambit::DimensionException("invalid cmatrix in solve");
 	}
 	double *ret = new double[n];
 	for(int i=0;i<n;i++) ret[i] = b[i];
@@ -342,9 +337,8 @@ void cmatrix::svd(cmatrix &u, cmatrix &v, double *w) {
 			if (its==30) {
 				// some other method (like an error return
 				// value should be put here)
-				std::cerr << "no convergence after 30 svdcmp "
-				  "iterations" << std::endl;
-				exit(1);
+				throw Gambit::Exception("no convergence after 30 svdcmp "
+							"iterations");
 			}
 			x = w[l];
 			nm = k-1;
@@ -433,8 +427,8 @@ double cmatrix::adjoint() {
 	continue;
     }
     if(maxi == -1) {
-      std::cout << "oops";
-      return DBL_MAX;
+      // no pivot is found only if the column has non-finite entries
+      throw Gambit::ValueException("cmatrix::adjoint(): non-finite entry in column");
     }
 
     i = maxi;
@@ -37,6 +37,8 @@
 #include <iomanip>
 #include <vector>
 
+#include "gambit.h"
+
 namespace Gambit {
 namespace gametracer {
 
@@ -107,8 +109,7 @@ public:
 	}
 	inline double operator*(const cvector &v) const {
 		if (m!=v.m) {
-		  std::cerr << "invalid cvector dot product" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid cvector dot product");
 		}
 		double ret = 0.0;
 		for(int i=0;i<m;i++) ret += x[i]*v.x[i];
@@ -134,16 +135,14 @@ public:
 	}
 	inline cvector &operator+=(const cvector &v) {
 		if (v.m!=m) {
-		  std::cerr << "invalid cvector addition" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid cvector addition");
 		}
 		for(int i=0;i<m;i++) x[i] += v.x[i];
 		return *this;
 	}
 	inline cvector &operator-=(const cvector &v) {
 		if (v.m!=m) {
-		  std::cerr << "invalid cvector subtraction" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid cvector subtraction");
 		}
 		for(int i=0;i<m;i++) x[i] -= v.x[i];
 		return *this;
@@ -451,8 +450,7 @@ public:
 
 	inline cmatrix operator*(const cmatrix &ma) const {
 		if (n!=ma.m) {
-		  std::cerr << "invalid cmatrix multiply" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid cmatrix multiply");
 		}
 		cmatrix ret(m,ma.n);
 		int c=0;
@@ -465,8 +463,7 @@ public:
 	}
 	inline cvector operator*(const cvector &v) const {
 		if (n!=v.m) {
-		  std::cerr << "invalid cvector-cmatrix multiply" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid cvector-cmatrix multiply");
 		}
 		cvector ret(m);
 		int c = 0;
@@ -480,8 +477,7 @@ public:
 
 	inline double dot(const cmatrix &ma) const {
 		if (n!=ma.n || m!=ma.m) {
-		  std::cerr << "invalid cmatrix dot-product" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid cmatrix dot-product");
 		}
 		int c = 0;
 		double ret = 0.0;
@@ -493,8 +489,7 @@ public:
 		
 	inline void outer(const cmatrix &ma, cmatrix &ret) const {
 		if (n!=ma.n || ret.m!=m || ret.n!=ma.m) {
-		  std::cerr << "invalid cmatrix outer multiply" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid cmatrix outer multiply");
 		}
 		int c=0;
 		for(int i=0;i<m;i++) for(int j=0;j<ma.m;j++,c++) {
@@ -505,8 +500,7 @@ public:
 	}
 	inline void inner(const cmatrix &ma, cmatrix &ret) const {
 		if (m!=ma.m || ret.m!=n || ret.n!=ma.n) {
-		  std::cerr << "invalid cmatrix inner multiply" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid cmatrix inner multiply");
 		}
 		int c=0;
 		for(int i=0;i<n;i++) for(int j=0;j<ma.n;j++,c++) {
@@ -518,8 +512,7 @@ public:
 
 	inline double rowmult(int r, const cvector &v, int exclude) const {
 		if (n!=v.m) {
-		  std::cerr << "invalid matrix-vector multiply" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid matrix-vector multiply");
 		}
 		double ret = 0.0;
 		int c=n*r;
@@ -529,8 +522,7 @@ public:
 	}
 	inline double rowmult(int r, const cvector &v) const {
 		if (n!=v.m) {
-		  std::cerr << "invalid matrix-vector multiply" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid matrix-vector multiply");
 		}
 		double ret = 0.0;
 		int c=n*r;
@@ -555,8 +547,7 @@ public:
 	}
 	inline cmatrix &multbyrow(const cvector &v) {
 		if (n!=v.m) {
-		  std::cerr << "invalid multbycol" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid multbycol");
 		}
 		int c = 0;
 		for(int i=0;i<m;i++)
@@ -566,8 +557,7 @@ public:
 	}
 	inline cmatrix &multbycol(const cvector &v) {
 		if (m!=v.m) {
-		  std::cerr << "invalid multbycol" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid multbycol");
 		}
 		int c = 0;
 		for(int i=0;i<m;i++)
@@ -591,8 +581,7 @@ public:
 	}
 	inline cmatrix &dividebyrow(const cvector &v) {
 		if (n!=v.m) {
-		  std::cerr << "invalid dividebycol" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid dividebycol");
 		}
 		int c = 0;
 		for(int i=0;i<m;i++)
@@ -602,8 +591,7 @@ public:
 	}
 	inline cmatrix &dividebycol(const cvector &v) {
 		if (m!=v.m) {
-		  std::cerr << "invalid dividebycol" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid dividebycol");
 		}
 		int c = 0;
 		for(int i=0;i<m;i++)
@@ -628,8 +616,7 @@ public:
 
 	inline cmatrix &operator+=(const cmatrix &ma) {
 		if (m!=ma.m||n!=ma.n) {
-		  std::cerr << "invalid cmatrix addition" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid cmatrix addition");
 		}
 		for(int i=0;i<s;i++) x[i] += ma.x[i];
 		return *this;
@@ -637,8 +624,7 @@ public:
 
 	inline cmatrix &operator-=(const cmatrix &ma) {
 		if (m!=ma.m||n!=ma.n) {
-		  std::cerr << "invalid cmatrix addition" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid cmatrix addition");
 		}
 		for(int i=0;i<s;i++) x[i] -= ma.x[i];
 		return *this;
@@ -646,8 +632,7 @@ public:
 
 	inline cmatrix &operator*=(const cmatrix &ma) {
 		if (n!=ma.m || n != ma.n) {
-		  std::cerr << "invalid cmatrix multiply" << std::endl;
-		  //assert(0);
+		  throw Gambit::DimensionException("invalid cmatrix multiply");
 		}
 		int i,j,k,c=0;
 		std::vector<double> newrow(n);
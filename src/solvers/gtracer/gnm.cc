@@ -67,7 +67,9 @@ void PrintProfile(std::ostream &p_stream,
 //            wobbles are disabled, GNM will terminate if the error
 //            reaches this threshold.
 
-int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFreq, int LNMMax, double LambdaMin, bool wobble, double threshold, bool verbose)
+// The equilibria are appended to Eq, and counted by numEq, as they are
+// found, so that GNM() can release them if an exception is thrown.
+static int FollowPath(gnmgame &A, cvector &g, cvector **&Eq, int &numEq, int steps, double fuzz, int LNMFreq, int LNMMax, double LambdaMin, bool wobble, double threshold, bool verbose)
 {
   int i, // utility variables
     bestAction,  
@@ -78,7 +80,6 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
     s_hat_old=-1, // the last pure strategy to enter or leave the support
     s_hat, // the next pure strategy to enter or leave the support
     Index = 1, // index of the equilibrium we're moving towards
-    numEq = 0, // number of equilibria found so far
     stepsLeft; // number of linear steps remaining until we hit the boundary
 
   int N = A.getNumPlayers(), 
@@ -123,8 +124,6 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
   cvector G(N), yn1(N), ym1(M), ym2(M), ym3(M);
 
   // INITIALIZATION
-  Eq = (cvector **)malloc(sizeof(cvector *));
-
   // Find the lone equilibrium of the perturbed game
   for(n = 0; n < N; n++) {
     bestPayoff = g[A.firstAction(n)];
@@ -443,5 +442,23 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
   }
 }
 
+int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFreq, int LNMMax, double LambdaMin, bool wobble, double threshold, bool verbose)
+{
+  int numEq = 0; // number of equilibria found so far
+  Eq = (cvector **)malloc(sizeof(cvector *));
+  try {
+    return FollowPath(A, g, Eq, numEq, steps, fuzz, LNMFreq, LNMMax,
+		      LambdaMin, wobble, threshold, verbose);
+  }
+  catch (...) {
+    for (int i = 0; i < numEq; i++) {
+      delete Eq[i];
+    }
+    free(Eq);
+    Eq = 0;
+    throw;
+  }
+}
+
 }  // end namespace Gambit::gametracer
 }  // end namespace Gambit
@@ -25,6 +25,8 @@
 #ifndef GAMBIT_GTRACER_GNMGAME_H
 #define GAMBIT_GTRACER_GNMGAME_H
 
+#include <algorithm>
+
 #include "cmatrix.h"
 
 namespace Gambit {
@@ -85,8 +87,7 @@ class gnmgame {
 
   virtual void payoffMatrix(cmatrix &dest, cvector &s, double fuzz, bool ksym){
     if(ksym && s.getm()!=getNumKSymActions()){
-      std::cerr<<"payoffMatrix() error: k-symmetric version of Jacobian not implemented for this class"<<std::endl;
-      exit(1);
+      throw Gambit::UndefinedException("payoffMatrix() error: k-symmetric version of Jacobian not implemented for this class");
     }
     payoffMatrix(dest, s, fuzz);
   }
@@ -95,6 +96,16 @@ class gnmgame {
   // the owner of action i if he deviates from s by choosing i instead.
   virtual void getPayoffVector(cvector &dest, int player,const cvector &s) = 0; 
 
+  // store in dest the payoff vectors of all the players, each at the
+  // offset of the player's first action
+  virtual void getPayoffVectors(cvector &dest, const cvector &s){
+    for (int n=0;n<numPlayers;n++){
+      cvector payoffs(actions[n]);
+      getPayoffVector(payoffs, n, s);
+      std::copy(payoffs.values(), payoffs.values()+actions[n], dest.values()+firstAction(n));
+    }
+  }
+
   //get payoff vector for a symmetric game under a symmetric strategy. only one player's strategy is given in s
   virtual void getSymPayoffVector(cvector &dest, cvector &s){
     cvector fulls(getNumActions());
@@ -127,7 +138,16 @@ class gnmgame {
   double getRegret(cvector &s)
   {
     cvector regrets(numPlayers);
-    for (int i=0;i<numPlayers;i++) regrets[i]= getRegret(i,s);
+    cvector payoffs(numActions);
+    getPayoffVectors(payoffs, s);
+    for (int i=0;i<numPlayers;i++){
+      double p=0, best=payoffs[firstAction(i)];
+      for (int j=firstAction(i);j<lastAction(i);j++){
+        p+=payoffs[j] * s[j];
+        if (payoffs[j]>best) best=payoffs[j];
+      }
+      regrets[i]=best-p;
+    }
     return regrets.max();
   }
 
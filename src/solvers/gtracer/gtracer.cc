@@ -0,0 +1,77 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2022, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/solvers/gtracer/gtracer.cc
+// Representations of Gambit games for Gametracer
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <memory>
+#include <vector>
+
+#include "gambit.h"
+#include "gtracer.h"
+
+namespace Gambit {
+namespace gametracer {
+
+gnmgame *NewGnmGame(const Game &p_game, const Rational &p_offset, double p_scale)
+{
+  double offset = (double) p_offset;
+  if (p_game->IsTree() && sfgame::isTooLargeForTable(p_game)) {
+    return new sfgame(p_game, offset, p_scale);
+  }
+
+  std::vector<int> actions(p_game->NumPlayers());
+  int veclength = p_game->NumPlayers();
+  for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+    actions[pl-1] = p_game->GetPlayer(pl)->NumStrategies();
+    veclength *= p_game->GetPlayer(pl)->NumStrategies();
+  }
+  cvector payoffs(veclength);
+
+  if (TableContingencyIterator::IsTable(p_game)) {
+    // The payoffs of an nfgame are laid out as those of the table,
+    // player by player, so each goes straight to its place
+    int numContingencies = veclength / p_game->NumPlayers();
+    for (TableContingencyIterator iter(p_game); !iter.AtEnd(); iter++) {
+      for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+	payoffs[(pl-1) * numContingencies + iter.GetIndex() - 1] =
+	  (iter.GetPayoff<double>(pl) + offset) * p_scale;
+      }
+    }
+    return new nfgame(p_game->NumPlayers(), actions, payoffs);
+  }
+
+  std::unique_ptr<gnmgame> A(new nfgame(p_game->NumPlayers(), actions, payoffs));
+
+  std::vector<int> profile(p_game->NumPlayers());
+  for (StrategyProfileIterator iter(p_game); !iter.AtEnd(); iter++) {
+    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+      profile[pl-1] = (*iter)->GetStrategy(pl)->GetNumber() - 1;
+    }
+
+    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+      A->setPurePayoff(pl-1, profile,
+		       (double) ((*iter)->GetPayoff(pl) + p_offset) * p_scale);
+    }
+  }
+  return A.release();
+}
+
+}  // end namespace Gambit::gametracer
+}  // end namespace Gambit
@@ -29,6 +29,7 @@
 #include "nfgame.h"
 #include "gnmgame.h"
 #include "aggame.h"
+#include "sfgame.h"
 
 namespace Gambit {
 namespace gametracer {
@@ -37,6 +38,14 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
 
 int IPA(gnmgame &A, cvector &g, cvector &zh, double alpha, double fuzz, cvector &ans,int maxiter=-1);
 
+// Builds the representation of a game which is not an AGG: the sequence
+// form if the game is a tree too large for a table (see sfgame), and the
+// table of strategy profiles otherwise.  Payoffs are taken as
+// scale * (u + offset), where u is the payoff in the game; where the
+// payoffs are computed exactly, so is the offset sum.
+gnmgame *NewGnmGame(const Game &p_game, const Rational &p_offset = Rational(0),
+		    double p_scale = 1.0);
+
 }  // end namespace Gambit::gametracer
 }  // end namespace Gambit
 
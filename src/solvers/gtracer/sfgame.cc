@@ -0,0 +1,276 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2022, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/solvers/gtracer/sfgame.cc
+// Reduced strategies of game trees, with payoffs from the sequence form
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <climits>
+#include <vector>
+#include "cmatrix.h"
+#include "sfgame.h"
+#include "games/gametree.h"
+
+namespace Gambit {
+namespace gametracer {
+
+std::vector<int> sfgame::countStrategies(const Gambit::Game &game) {
+  if (!game->IsTree() || !game->IsPerfectRecall()) {
+    throw Gambit::UndefinedException();
+  }
+  GameTreeRep &tree = dynamic_cast<GameTreeRep &>(*game);
+  std::vector<int> actions(game->NumPlayers());
+  double total = 0.0;
+  for (int i = 0; i < game->NumPlayers(); i++) {
+    long count = tree.GetReducedStrategies(game->GetPlayer(i+1)).NumStrategies();
+    if (count > INT_MAX) {
+      throw Gambit::UndefinedException("Too many strategies to index");
+    }
+    actions[i] = (int) count;
+    total += count;
+  }
+  // The solvers keep square matrices in the total number of strategies
+  if (total * total > MAX_JACOBIAN) {
+    throw Gambit::UndefinedException("Too many reduced strategies for the Jacobian of the payoffs");
+  }
+  return actions;
+}
+
+bool sfgame::isTooLargeForTable(const Gambit::Game &game) {
+  GameTreeRep &tree = dynamic_cast<GameTreeRep &>(*game);
+  double size = game->NumPlayers();
+  for (int pl = 1; pl <= game->NumPlayers(); pl++) {
+    size *= tree.GetReducedStrategies(game->GetPlayer(pl)).NumStrategies();
+  }
+  return size > MAX_TABLE;
+}
+
+sfgame::sfgame(const Gambit::Game &game, double offset, double scale)
+  : sfgame(game, countStrategies(game), offset, scale)
+{ }
+
+sfgame::sfgame(const Gambit::Game &game, std::vector<int> actions,
+	       double offset, double scale)
+  : gnmgame(game->NumPlayers(), actions), numSequences(numPlayers),
+    strategyStart(numPlayers), strategySequences(numPlayers), numNodes(0),
+    nodesBySequence(numPlayers)
+{
+  GameTreeRep &tree = dynamic_cast<GameTreeRep &>(*game);
+
+  // Sequences of player i are numbered from 1 by information set, then
+  // by action; seqOffset[i][iset] is one less than the first at iset
+  std::vector<std::vector<int> > seqOffset(numPlayers);
+  for (int i = 0; i < numPlayers; i++) {
+    GamePlayer player = game->GetPlayer(i+1);
+    seqOffset[i].resize(player->NumInfosets() + 1);
+    numSequences[i] = 1;
+    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
+      seqOffset[i][iset] = numSequences[i] - 1;
+      numSequences[i] += player->GetInfoset(iset)->NumActions();
+    }
+
+    const ReducedStrategySpace &space = tree.GetReducedStrategies(player);
+    for (ReducedStrategyIterator iter(space); !iter.AtEnd(); iter++) {
+      strategyStart[i].push_back(strategySequences[i].size());
+      const Array<int> &behav = *iter;
+      for (int iset = 1; iset <= behav.Length(); iset++) {
+	if (behav[iset] > 0) {
+	  strategySequences[i].push_back(seqOffset[i][iset] + behav[iset]);
+	}
+      }
+    }
+    strategyStart[i].push_back(strategySequences[i].size());
+  }
+
+  // Walk the tree depth-first, carrying the chance probability of
+  // reaching each node and the last sequence of each player leading to it
+  struct Entry {
+    GameNode node;
+    double prob;
+    std::vector<int> sequences;
+  };
+  std::vector<Entry> stack(1);
+  stack[0].node = game->GetRoot();
+  stack[0].prob = 1.0;
+  stack[0].sequences.assign(numPlayers, 0);
+  while (!stack.empty()) {
+    Entry entry = stack.back();
+    stack.pop_back();
+    GameNode node = entry.node;
+    GameOutcome outcome = node->GetOutcome();
+    if (outcome || node->NumChildren() == 0) {
+      double terminal = (node->NumChildren() == 0) ? offset : 0.0;
+      nodeProbs.push_back(entry.prob);
+      for (int i = 0; i < numPlayers; i++) {
+	double payoff = (outcome) ? outcome->GetPayoff<double>(i+1) : 0.0;
+	nodePayoffs.push_back(scale * (payoff + terminal));
+	nodeSequences.push_back(entry.sequences[i]);
+      }
+      numNodes++;
+    }
+
+    GamePlayer player = node->GetPlayer();
+    for (int act = node->NumChildren(); act >= 1; act--) {
+      Entry child = { node->GetChild(act), entry.prob, entry.sequences };
+      if (player->IsChance()) {
+	child.prob *= node->GetInfoset()->GetActionProb(act, (double) 0);
+      }
+      else {
+	int i = player->GetNumber() - 1;
+	child.sequences[i] = seqOffset[i][node->GetInfoset()->GetNumber()] + act;
+      }
+      stack.push_back(child);
+    }
+  }
+
+  for (int i = 0; i < numPlayers; i++) {
+    nodesBySequence[i].resize(numSequences[i]);
+    for (int z = 0; z < numNodes; z++) {
+      nodesBySequence[i][nodeSequences[z*numPlayers+i]].push_back(z);
+    }
+  }
+}
+
+void sfgame::realizationPlan(std::vector<std::vector<double> > &dest,
+			     const cvector &s) const {
+  dest.resize(numPlayers);
+  for (int i = 0; i < numPlayers; i++) {
+    dest[i].assign(numSequences[i], 0.0);
+    for (int k = 0; k < actions[i]; k++) {
+      double prob = s[strategyOffset[i] + k];
+      dest[i][0] += prob;
+      for (int j = strategyStart[i][k]; j < strategyStart[i][k+1]; j++) {
+	dest[i][strategySequences[i][j]] += prob;
+      }
+    }
+  }
+}
+
+double sfgame::nodeProb(const std::vector<std::vector<double> > &plan,
+			int z, int skip1, int skip2) const {
+  double prob = nodeProbs[z];
+  for (int i = 0; i < numPlayers; i++) {
+    if (i != skip1 && i != skip2) {
+      prob *= plan[i][nodeSequences[z*numPlayers+i]];
+    }
+  }
+  return prob;
+}
+
+double sfgame::getPurePayoff(int player, std::vector<int> &s) {
+  // The sequences made by each player's strategy in s
+  std::vector<std::vector<char> > made(numPlayers);
+  for (int i = 0; i < numPlayers; i++) {
+    made[i].assign(numSequences[i], 0);
+    made[i][0] = 1;
+    for (int j = strategyStart[i][s[i]]; j < strategyStart[i][s[i]+1]; j++) {
+      made[i][strategySequences[i][j]] = 1;
+    }
+  }
+
+  double payoff = 0.0;
+  for (int z = 0; z < numNodes; z++) {
+    int i;
+    for (i = 0; i < numPlayers && made[i][nodeSequences[z*numPlayers+i]]; i++);
+    if (i == numPlayers) {
+      payoff += nodeProbs[z] * nodePayoffs[z*numPlayers+player];
+    }
+  }
+  return payoff;
+}
+
+double sfgame::getMixedPayoff(int player, cvector &s) {
+  std::vector<std::vector<double> > plan;
+  realizationPlan(plan, s);
+  double payoff = 0.0;
+  for (int z = 0; z < numNodes; z++) {
+    payoff += nodeProb(plan, z, -1, -1) * nodePayoffs[z*numPlayers+player];
+  }
+  return payoff;
+}
+
+void sfgame::getPayoffVector(cvector &dest, int player, const cvector &s) {
+  std::vector<std::vector<double> > plan;
+  realizationPlan(plan, s);
+
+  // The payoff to each sequence of the player, against the others
+  std::vector<double> values(numSequences[player], 0.0);
+  for (int z = 0; z < numNodes; z++) {
+    values[nodeSequences[z*numPlayers+player]] +=
+      nodeProb(plan, z, player, -1) * nodePayoffs[z*numPlayers+player];
+  }
+
+  for (int k = 0; k < actions[player]; k++) {
+    double payoff = values[0];
+    for (int j = strategyStart[player][k]; j < strategyStart[player][k+1]; j++) {
+      payoff += values[strategySequences[player][j]];
+    }
+    dest[k] = payoff;
+  }
+}
+
+void sfgame::payoffMatrix(cmatrix &dest, cvector &s, double fuzz) {
+  std::vector<std::vector<double> > plan;
+  realizationPlan(plan, s);
+
+  std::vector<double> weights(numNodes), row;
+  for (int rown = 0; rown < numPlayers; rown++) {
+    for (int coln = 0; coln < numPlayers; coln++) {
+      if (rown == coln) {
+	double fuzzcount = fuzz;
+	for (int rowi = firstAction(rown); rowi < lastAction(rown); rowi++) {
+	  for (int coli = firstAction(coln); coli < lastAction(coln); coli++) {
+	    dest[rowi][coli] = fuzzcount;
+	    fuzzcount += fuzz;
+	  }
+	}
+	continue;
+      }
+
+      for (int z = 0; z < numNodes; z++) {
+	weights[z] = nodeProb(plan, z, rown, coln) * nodePayoffs[z*numPlayers+rown];
+      }
+      // For each strategy of rown, sum the weights of the nodes its
+      // sequences lead to, by the sequence of coln leading there; then
+      // sum these over the sequences of each strategy of coln
+      auto addNodes = [&](int seq) {
+	const std::vector<int> &nodes = nodesBySequence[rown][seq];
+	for (size_t n = 0; n < nodes.size(); n++) {
+	  row[nodeSequences[nodes[n]*numPlayers+coln]] += weights[nodes[n]];
+	}
+      };
+      for (int k = 0; k < actions[rown]; k++) {
+	row.assign(numSequences[coln], 0.0);
+	addNodes(0);
+	for (int j = strategyStart[rown][k]; j < strategyStart[rown][k+1]; j++) {
+	  addNodes(strategySequences[rown][j]);
+	}
+	for (int l = 0; l < actions[coln]; l++) {
+	  double payoff = row[0];
+	  for (int j = strategyStart[coln][l]; j < strategyStart[coln][l+1]; j++) {
+	    payoff += row[strategySequences[coln][j]];
+	  }
+	  dest[firstAction(rown) + k][firstAction(coln) + l] = payoff;
+	}
+      }
+    }
+  }
+}
+
+}  // end namespace Gambit::gametracer
+}  // end namespace Gambit
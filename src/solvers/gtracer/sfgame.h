@@ -0,0 +1,125 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2022, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/solvers/gtracer/sfgame.h
+// Reduced strategies of game trees, with payoffs from the sequence form
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef GAMBIT_GTRACER_SFGAME_H
+#define GAMBIT_GTRACER_SFGAME_H
+
+#include <vector>
+#include "cmatrix.h"
+#include "gnmgame.h"
+#include "gambit.h"
+
+namespace Gambit {
+namespace gametracer {
+
+// A game tree with perfect recall, as a game in reduced strategies.
+// This is not a sequence-form solver: the actions seen by GNM and IPA
+// are still the reduced strategies of the players, in the order of the
+// game, and the Jacobian they work with is square in their total
+// number.  Making the realization plans themselves the variables would
+// take a path following over the polytopes of realization plans, with
+// their constraints at each information set, where GNM and IPA follow
+// it over simplices.  The reduced strategies are enumerated lazily, and
+// only the payoffs are computed from the sequence form, so that the
+// normal form, whose size is the product of the numbers of strategies,
+// is never tabulated.
+//
+// This pays off only in a window: a tree is solved here when its normal
+// form has more than MAX_TABLE payoffs (see isTooLargeForTable()), and
+// refused when the square of its total number of reduced strategies is
+// more than MAX_JACOBIAN, which allows up to 4096 of them.  A mixed strategy of a player induces
+// a realization plan, the probability of each of the player's sequences
+// of moves; the payoff at a profile is the sum over the nodes with
+// payoffs of their payoffs, weighted by the chance probability and the
+// realization probability of each player's sequence leading to them.
+//
+// Each strategy is stored as the list of sequences it makes, and each
+// node as the sequence of each player leading to it, so that the work
+// in each evaluation is in proportion to the size of the tree and the
+// number of strategies, not their product.
+//
+// The representation is only read after construction, so one sfgame
+// may be used from several threads at once.
+class sfgame : public gnmgame {
+ public:
+  // Payoffs are taken as scale * (u + offset), where u is the payoff
+  // in the game; as terminal nodes are reached with total probability
+  // one, this is the same transformation of the normal form payoffs.
+  sfgame(const Gambit::Game &game, double offset = 0.0, double scale = 1.0);
+  ~sfgame() { }
+
+  // The largest normal form tabulated rather than represented here, in
+  // payoffs, and the largest Jacobian of the payoffs, in entries, which
+  // GNM and IPA keep several of
+  static const int MAX_TABLE = 1 << 20;
+  static const int MAX_JACOBIAN = 1 << 24;
+
+  // Whether the normal form of the game has more than MAX_TABLE payoffs;
+  // on smaller games a table (nfgame) is faster to evaluate
+  static bool isTooLargeForTable(const Gambit::Game &game);
+
+  double getPurePayoff(int player, std::vector<int> &s);
+
+  inline void setPurePayoff(int, std::vector<int> &, double) {
+    throw Gambit::UndefinedException();
+  }
+
+  double getMixedPayoff(int player, cvector &s);
+  void payoffMatrix(cmatrix &dest, cvector &s, double fuzz);
+  void getPayoffVector(cvector &dest, int player, const cvector &s);
+
+ private:
+  sfgame(const Gambit::Game &game, std::vector<int> actions,
+	 double offset, double scale);
+  static std::vector<int> countStrategies(const Gambit::Game &game);
+
+  // computes the realization plan of each player under s
+  void realizationPlan(std::vector<std::vector<double> > &dest,
+		       const cvector &s) const;
+  // the chance and realization probability of node z, leaving out
+  // players skip1 and skip2
+  double nodeProb(const std::vector<std::vector<double> > &plan,
+		  int z, int skip1, int skip2) const;
+
+  // numSequences[i] = number of sequences of player i, counting the
+  // empty sequence, which is sequence 0
+  std::vector<int> numSequences;
+  // the (nonempty) sequences made by the k'th strategy of player i are
+  // strategySequences[i][strategyStart[i][k]] up to, but not including,
+  // strategySequences[i][strategyStart[i][k+1]]
+  std::vector<std::vector<int> > strategyStart, strategySequences;
+
+  // the nodes with payoffs: the terminal nodes, and any other nodes with
+  // outcomes.  nodeSequences[z*numPlayers+i] is the sequence of player i
+  // leading to node z, and nodePayoffs[z*numPlayers+i] the payoff to
+  // player i at z.  nodesBySequence[i][seq] lists the nodes reached by
+  // player i's sequence seq.
+  int numNodes;
+  std::vector<double> nodeProbs, nodePayoffs;
+  std::vector<int> nodeSequences;
+  std::vector<std::vector<std::vector<int> > > nodesBySequence;
+};
+
+}  // end namespace Gambit::gametracer
+}  // end namespace Gambit
+
+#endif  // GAMBIT_GTRACER_SFGAME_H
@@ -20,6 +20,10 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
+#include <atomic>
+#include <exception>
+#include <thread>
+
 #include "gambit.h"
 #include "solvers/ipa/ipa.h"
 #include "solvers/gtracer/gtracer.h"
@@ -29,6 +33,45 @@ using namespace Gambit::gametracer;
 namespace Gambit {
 namespace Nash {
 
+std::shared_ptr<gnmgame>
+NashIPAStrategySolver::BuildRepresentation(const Game &p_game) const
+{
+  if (p_game->IsAgg()) {
+    return std::shared_ptr<gnmgame>(new aggame(dynamic_cast<GameAggRep &>(*p_game)));
+  }
+  // A table or sequence form is only read while solving, so one is kept
+  // with the game, to be shared by all calls until the game changes
+  return p_game->GetRepresentation<gnmgame>("ipa",
+    [&p_game]() { return NewGnmGame(p_game); });
+}
+
+//
+// Runs IPA once on p_rep along the (normalized) perturbation ray p_pert,
+// storing the equilibrium in p_answer.  Without a starting profile, the
+// initial approximation zh is the vector of all ones, which retracts to
+// the centroid.  Given a starting profile s, zh is s plus the payoffs to
+// each action against s, which is the point retracting to s; IPA then
+// takes up from there.
+//
+bool
+NashIPAStrategySolver::Solve(gnmgame &p_rep, const cvector &p_pert,
+			     const cvector *p_start, cvector &p_answer) const
+{
+  const double ALPHA = 0.2;
+  const double EQERR = 1e-6;
+
+  cvector g(p_pert);
+  cvector zh(p_rep.getNumActions(), 1.0);
+  if (p_start) {
+    cvector payoffs(p_rep.getNumActions());
+    p_rep.getPayoffVectors(payoffs, *p_start);
+    for (int i = 0; i < p_rep.getNumActions(); i++) {
+      zh[i] = (*p_start)[i] + payoffs[i];
+    }
+  }
+  return IPA(p_rep, g, zh, ALPHA, EQERR, p_answer) != 0;
+}
+
 List<MixedStrategyProfile<double> >
 NashIPAStrategySolver::Solve(const Game &p_game) const
 {
@@ -42,67 +85,114 @@ NashIPAStrategySolver::Solve(const Game &p_game) const
 List<MixedStrategyProfile<double> >
 NashIPAStrategySolver::Solve(const Game &p_game,
 			     const Array<double> &p_pert) const
+{
+  List<Array<double> > perts;
+  perts.push_back(p_pert);
+  return Solve(p_game, perts, List<MixedStrategyProfile<double> >());
+}
+
+List<MixedStrategyProfile<double> >
+NashIPAStrategySolver::Solve(const Game &p_game,
+			     const Array<double> &p_pert,
+			     const MixedStrategyProfile<double> &p_start) const
+{
+  List<Array<double> > perts;
+  perts.push_back(p_pert);
+  List<MixedStrategyProfile<double> > starts;
+  starts.push_back(p_start);
+  return Solve(p_game, perts, starts);
+}
+
+List<MixedStrategyProfile<double> >
+NashIPAStrategySolver::Solve(const Game &p_game,
+			     const List<Array<double> > &p_perts,
+			     const List<MixedStrategyProfile<double> > &p_starts) const
 {
   if (!p_game->IsPerfectRecall()) {
     throw UndefinedException("Computing equilibria of games with imperfect recall is not supported.");
   }
-
-  Gambit::shared_ptr<gnmgame> A;
-  List<MixedStrategyProfile<double> > solutions;
-  
-  if (p_game->IsAgg()){
-    A = new aggame(dynamic_cast<GameAggRep &>(*p_game));
+  if (p_starts.size() != 0 && p_starts.size() != p_perts.size()) {
+    throw DimensionException();
   }
-  else {
-    std::vector<int> actions(p_game->NumPlayers());
-    int veclength = p_game->NumPlayers();
-    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-      actions[pl-1] = p_game->GetPlayer(pl)->NumStrategies();
-      veclength *= p_game->GetPlayer(pl)->NumStrategies();
-    }
-    cvector payoffs(veclength);
-  
-    A = new nfgame(p_game->NumPlayers(), actions, payoffs);
-  
-    std::vector<int> profile(p_game->NumPlayers());
-    for (StrategyProfileIterator iter(p_game); !iter.AtEnd(); iter++) {
-      for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-	profile[pl-1] = (*iter)->GetStrategy(pl)->GetNumber() - 1;
-      }
 
-      for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-	A->setPurePayoff(pl-1, profile, (*iter)->GetPayoff(pl));
+  // The table representation is only read while solving, and is shared
+  // by all the runs.  An aggame carries its own scratch space for
+  // evaluating the AGG, so each thread builds one of its own.
+  std::shared_ptr<gnmgame> A = BuildRepresentation(p_game);
+  int numRuns = p_perts.size();
+  // The runs only read the perturbations and starting points, so these
+  // are unpacked here, once, rather than by each thread
+  std::vector<cvector> perts, starts;
+  for (int run = 1; run <= numRuns; run++) {
+    cvector g(A->getNumActions()); // perturbation ray
+    for (int i = 0; i < A->getNumActions(); i++) {
+      g[i] = p_perts[run][i+1];
+    }
+    g /= g.norm(); // normalized
+    perts.push_back(g);
+    if (p_starts.size() != 0) {
+      cvector s(A->getNumActions());
+      for (int i = 0; i < A->getNumActions(); i++) {
+	s[i] = p_starts[run][i+1];
       }
+      starts.push_back(s);
     }
   }
+  std::vector<cvector> answers(numRuns, cvector(A->getNumActions()));
+  std::vector<char> found(numRuns, 0);
+  std::vector<std::exception_ptr> errors(numRuns);
+  std::atomic<int> next(0);
 
-  cvector g(A->getNumActions()); // perturbation ray
-  int numEq;
+  auto work = [&](bool p_ownRep) {
+    // A is held by this call until all the threads are joined, so the
+    // threads only borrow it
+    std::unique_ptr<gnmgame> ownRep;
+    if (p_ownRep) {
+      ownRep.reset(new aggame(dynamic_cast<GameAggRep &>(*p_game)));
+    }
+    gnmgame &rep = (ownRep) ? *ownRep : *A;
+    for (int run = next++; run < numRuns; run = next++) {
+      try {
+	found[run] = Solve(rep, perts[run],
+			   (starts.empty()) ? 0 : &starts[run], answers[run]);
+      }
+      catch (...) {
+	errors[run] = std::current_exception();
+      }
+    }
+  };
 
-  cvector ans(A->getNumActions());
-  cvector zh(A->getNumActions(),1.0);
-  do {
-    const double ALPHA = 0.2;
-    const double EQERR = 1e-6;
+  int numThreads = GetNumThreads();
+  numThreads = std::min(numThreads, numRuns);
+  std::vector<std::thread> threads;
+  for (int i = 1; i < numThreads; i++) {
+    threads.push_back(std::thread([&]() {
+	  SetWorkerThread();
+	  work(p_game->IsAgg());
+	}));
+  }
+  work(false);
+  for (size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
 
-    for (int i = 0; i < A->getNumActions(); i++) {
-      g[i] = p_pert[i+1];
+  List<MixedStrategyProfile<double> > solutions;
+  for (int run = 0; run < numRuns; run++) {
+    if (errors[run]) {
+      std::rethrow_exception(errors[run]);
     }
-    g /= g.norm(); // normalized
-    numEq = IPA(*A, g, zh, ALPHA, EQERR, ans);
-  } while(numEq == 0);
-
-  MixedStrategyProfile<double> eqm = p_game->NewMixedStrategyProfile(0.0);
-  for (int i = 1; i <= eqm.MixedProfileLength(); i++) {
-    eqm[i] = ans[i-1];
+    if (!found[run]) {
+      continue;
+    }
+    MixedStrategyProfile<double> eqm = p_game->NewMixedStrategyProfile(0.0);
+    for (int i = 1; i <= eqm.MixedProfileLength(); i++) {
+      eqm[i] = answers[run][i-1];
+    }
+    m_onEquilibrium->Render(eqm);
+    solutions.push_back(eqm);
   }
-  m_onEquilibrium->Render(eqm);
-  solutions.push_back(eqm);
   return solutions;
 }
 
 }  // end namespace Gambit::Nash
 }  // end namespace Gambit
-
-
-    
@@ -24,6 +24,7 @@
 #define GAMBIT_NASH_IPA_H
 
 #include "games/nash.h"
+#include "solvers/gtracer/gtracer.h"
 
 namespace Gambit {
 namespace Nash {
@@ -38,6 +39,26 @@ public:
   List<MixedStrategyProfile<double> > Solve(const Game &p_game) const;
   List<MixedStrategyProfile<double> > Solve(const Game &p_game,
 					    const Array<double> &p_pert) const;
+  /// Restart IPA from a prior equilibrium (or any profile) p_start,
+  /// for instance one computed for a nearby game or perturbation
+  List<MixedStrategyProfile<double> > Solve(const Game &p_game,
+					    const Array<double> &p_pert,
+					    const MixedStrategyProfile<double> &p_start) const;
+  /// Run IPA once for each perturbation in p_perts, spreading the runs
+  /// over the available hardware threads.  All runs share a single
+  /// representation of the game.  If p_starts is not empty, it gives
+  /// the profile from which each run starts; otherwise, each run starts
+  /// from the centroid.  The equilibria are returned, and rendered, in
+  /// the order of the runs; a run which fails contributes none.
+  List<MixedStrategyProfile<double> > Solve(const Game &p_game,
+					    const List<Array<double> > &p_perts,
+					    const List<MixedStrategyProfile<double> > &p_starts) const;
+
+private:
+  std::shared_ptr<gametracer::gnmgame> BuildRepresentation(const Game &p_game) const;
+  bool Solve(gametracer::gnmgame &p_rep, const gametracer::cvector &p_pert,
+	     const gametracer::cvector *p_start,
+	     gametracer::cvector &p_answer) const;
 };
 
 }  // end namespace Gambit::Nash
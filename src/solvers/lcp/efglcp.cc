@@ -24,6 +24,7 @@
 #include <cstdio>
 #include <iostream>
 #include "gambit.h"
+#include "games/gametree.h"
 #include "solvers/linalg/lemketab.h"
 #include "solvers/linalg/lhtab.h"
 #include "solvers/lcp/lcp.h"
@@ -111,8 +112,9 @@ NashLcpBehaviorSolver<T>::Solve(const BehaviorSupportProfile &p_support) const
     }
   }
 
-  FillTableau(p_support, A, p_support.GetGame()->GetRoot(), prob, 1, 1, 0, 0,
-	      solution);
+  FillTableau(p_support, A,
+	      dynamic_cast<GameTreeNodeRep *>(p_support.GetGame()->GetRoot().operator->()),
+	      prob, 1, 1, 0, 0, solution);
   for (i = A.MinRow(); i <= A.MaxRow(); i++) { 
     A(i,0) = -(T) 1;
   }
@@ -232,7 +234,7 @@ NashLcpBehaviorSolver<T>::AllLemke(const BehaviorSupportProfile &p_support,
 template <class T>
 void NashLcpBehaviorSolver<T>::FillTableau(const BehaviorSupportProfile &p_support, 
 					Matrix<T> &A,
-					const GameNode &n, T prob,
+					const GameTreeNodeRep *n, T prob,
 					int s1, int s2, int i1, int i2,
 					Solution &p_solution) const
 {
@@ -248,18 +250,19 @@ void NashLcpBehaviorSolver<T>::FillTableau(const BehaviorSupportProfile &p_suppo
     A(ns1+s2,s1) = Rational(A(ns1+s2,s1)) +
       Rational(prob) * (outcome->GetPayoff<Rational>(2) - p_solution.maxpay);
   }
-  if (n->GetInfoset()) {
-    if (n->GetPlayer()->IsChance()) {
-      GameInfoset infoset = n->GetInfoset();
-      for (int i = 1; i <= n->NumChildren(); i++) {
-	FillTableau(p_support, A, n->GetChild(i),
+  GameInfoset infoset = n->GetInfoset();
+  if (infoset) {
+    const Array<GameTreeNodeRep *> &children = n->Children();
+    int pl = infoset->GetPlayer()->GetNumber(), iset = infoset->GetNumber();
+    if (pl == 0) {
+      for (int i = 1; i <= children.Length(); i++) {
+	FillTableau(p_support, A, children[i],
 		    Rational(prob) * infoset->GetActionProb(i, Rational(0)),
 		    s1, s2, i1, i2, p_solution);
       }
     }
-    int pl = n->GetPlayer()->GetNumber();
     if (pl==1) {
-      i1=p_solution.isets1.Find(n->GetInfoset());
+      i1=p_solution.isets1.Find(infoset);
       snew=1;
       for (int i = 1; i < i1; i++) {
 	snew+=p_support.NumActions(p_solution.isets1[i]->GetPlayer()->GetNumber(),
@@ -267,14 +270,14 @@ void NashLcpBehaviorSolver<T>::FillTableau(const BehaviorSupportProfile &p_suppo
       }
       A(s1,ns1+ns2+i1+1) = -(T)1;
       A(ns1+ns2+i1+1,s1) = (T)1;
-      for (int i = 1; i <= p_support.NumActions(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber()); i++) {
+      for (int i = 1; i <= p_support.NumActions(pl, iset); i++) {
 	A(snew+i,ns1+ns2+i1+1) = (T)1;
 	A(ns1+ns2+i1+1,snew+i) = -(T)1;
-	FillTableau(p_support, A, n->GetChild(p_support.GetAction(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber(), i)->GetNumber()),prob,snew+i,s2,i1,i2, p_solution);
+	FillTableau(p_support, A, children[p_support.GetAction(pl, iset, i)->GetNumber()],prob,snew+i,s2,i1,i2, p_solution);
       }
     }
     if(pl==2) {
-      i2=p_solution.isets2.Find(n->GetInfoset());
+      i2=p_solution.isets2.Find(infoset);
       snew=1;
       for (int i = 1; i < i2; i++) {
 	snew+=p_support.NumActions(p_solution.isets2[i]->GetPlayer()->GetNumber(),
@@ -282,10 +285,10 @@ void NashLcpBehaviorSolver<T>::FillTableau(const BehaviorSupportProfile &p_suppo
       }
       A(ns1+s2,ns1+ns2+ni1+i2+1) = -(T)1;
       A(ns1+ns2+ni1+i2+1,ns1+s2) = (T)1;
-      for (int i = 1; i <= p_support.NumActions(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber()); i++) {
+      for (int i = 1; i <= p_support.NumActions(pl, iset); i++) {
 	A(ns1+snew+i,ns1+ns2+ni1+i2+1) = (T)1;
 	A(ns1+ns2+ni1+i2+1,ns1+snew+i) = -(T)1;
-	FillTableau(p_support, A, n->GetChild(p_support.GetAction(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber(), i)->GetNumber()),prob,s1,snew+i,i1,i2, p_solution);
+	FillTableau(p_support, A, children[p_support.GetAction(pl, iset, i)->GetNumber()],prob,s1,snew+i,i1,i2, p_solution);
       }
     }
     
@@ -69,7 +69,7 @@ private:
 
   class Solution;
 
-  void FillTableau(const BehaviorSupportProfile &, Matrix<T> &, const GameNode &, T,
+  void FillTableau(const BehaviorSupportProfile &, Matrix<T> &, const GameTreeNodeRep *, T,
 		   int, int, int, int, Solution &) const;
   void AllLemke(const BehaviorSupportProfile &, int dup, Gambit::linalg::LemkeTableau<T> &B,
 	       int depth, Matrix<T> &, Solution &) const; 
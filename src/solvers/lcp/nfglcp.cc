@@ -39,26 +39,10 @@ template <class T> Matrix<T> Make_A1(const Game &p_game)
   int n2 = p_game->Players()[2]->Strategies().size();
   Matrix<T> A1(1, n1, n1+1, n1+n2);
 
-  PureStrategyProfile profile = p_game->NewPureStrategyProfile();
-
-  Rational min = p_game->GetMinPayoff();
-  if (min > Rational(0)) {
-    min = Rational(0);
-  }
-  min -= Rational(1);
-
-  Rational max = p_game->GetMaxPayoff();
-  if (max < Rational(0)) {
-    max = Rational(0);
-  }
-
-  Rational fac(1, max - min);
-
+  std::shared_ptr<NormalizedBimatrix<T> > bimatrix = NormalizedBimatrix<T>::Get(p_game);
   for (int i = 1; i <= n1; i++)  {
-    profile->SetStrategy(p_game->Players()[1]->Strategies()[i]);
     for (int j = 1; j <= n2; j++)  {
-      profile->SetStrategy(p_game->Players()[2]->Strategies()[j]);
-      A1(i, n1 + j) = fac * (profile->GetPayoff(1) - min);
+      A1(i, n1 + j) = bimatrix->A1(i, j);
     }
   }
   return A1;
@@ -70,26 +54,10 @@ template <class T> Matrix<T> Make_A2(const Game &p_game)
   int n2 = p_game->Players()[2]->Strategies().size();
   Matrix<T> A2(n1+1, n1+n2, 1, n1);
 
-  PureStrategyProfile profile = p_game->NewPureStrategyProfile();
-  
-  Rational min = p_game->GetMinPayoff();
-  if (min > Rational(0)) {
-    min = Rational(0);
-  }
-  min -= Rational(1);
-
-  Rational max = p_game->GetMaxPayoff();
-  if (max < Rational(0)) {
-    max = Rational(0);
-  }
-
-  Rational fac(1, max - min);
-
-  for (int i = 1; i <= n1; i++)  {
-    profile->SetStrategy(p_game->Players()[1]->Strategies()[i]);
-    for (int j = 1; j <= n2; j++)  {
-      profile->SetStrategy(p_game->Players()[2]->Strategies()[j]);
-      A2(n1 + j, i) = fac * (profile->GetPayoff(2) - min);
+  std::shared_ptr<NormalizedBimatrix<T> > bimatrix = NormalizedBimatrix<T>::Get(p_game);
+  for (int j = 1; j <= n2; j++)  {
+    for (int i = 1; i <= n1; i++)  {
+      A2(n1 + j, i) = bimatrix->A2(j, i);
     }
   }
   return A2;
@@ -26,6 +26,7 @@
 
 using namespace Gambit;
 
+#include "suppipe.h"
 #include "efgensup.h"
 #include "sfg.h"
 #include "gpoly.h"
@@ -386,29 +387,107 @@ void PrintSupport(std::ostream &p_stream,
   p_stream << std::endl;
 }
 
+namespace {
+
+//
+// The actions in a support, as flags over all actions of the game,
+// listed by player and information set; this identifies the support
+// on any copy of the game.
+//
+Array<int> SupportFlags(const BehaviorSupportProfile &p_support)
+{
+  Game efg = p_support.GetGame();
+  Array<int> flags(efg->BehavProfileLength());
+  int index = 1;
+  for (int pl = 1; pl <= efg->NumPlayers(); pl++) {
+    GamePlayer player = efg->GetPlayer(pl);
+    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
+      GameInfoset infoset = player->GetInfoset(iset);
+      for (int act = 1; act <= infoset->NumActions(); act++) {
+	flags[index++] = p_support.Contains(infoset->GetAction(act)) ? 1 : 0;
+      }
+    }
+  }
+  return flags;
+}
+
+BehaviorSupportProfile SupportFromFlags(const Game &p_efg,
+					const Array<int> &p_flags)
+{
+  BehaviorSupportProfile support(p_efg);
+  int index = 1;
+  for (int pl = 1; pl <= p_efg->NumPlayers(); pl++) {
+    GamePlayer player = p_efg->GetPlayer(pl);
+    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
+      GameInfoset infoset = player->GetInfoset(iset);
+      for (int act = 1; act <= infoset->NumActions(); act++) {
+	if (!p_flags[index++]) {
+	  support.RemoveAction(infoset->GetAction(act));
+	}
+      }
+    }
+  }
+  return support;
+}
+
+//
+// The equilibria found on a support, as behavior profiles over the
+// full set of actions
+//
+struct SupportSolution {
+  List<Vector<double> > m_profiles;
+  bool m_singular;
+};
+
+SupportSolution SolveOnSupport(const Game &p_efg, const Array<int> &p_flags)
+{
+  SupportSolution solution;
+  solution.m_singular = false;
+  List<MixedBehaviorProfile<double> > newsolns = 
+    SolveSupport(SupportFromFlags(p_efg, p_flags), solution.m_singular);
+
+  for (int j = 1; j <= newsolns.Length(); j++) {
+    MixedBehaviorProfile<double> fullProfile = ToFullSupport(newsolns[j]);
+    if (fullProfile.GetLiapValue(true) < 1.0e-6) {
+      Vector<double> probs(fullProfile.Length());
+      for (int i = 1; i <= probs.Length(); i++) {
+	probs[i] = fullProfile[i];
+      }
+      solution.m_profiles.Append(probs);
+    }
+  }
+  return solution;
+}
+
+}  // end anonymous namespace
+
 void SolveExtensive(const Game &p_game)
 {
   List<BehaviorSupportProfile> supports = PossibleNashSubsupports(p_game);
 
-  for (int i = 1; i <= supports.Length(); i++) {
+  // Supports are solved concurrently on the threads allowed by
+  // SetNumThreads(); the output is the same as, and in the same order
+  // as, solving them one by one.
+  SupportPipeline<Array<int>, SupportSolution> 
+    pipeline(Gambit::GetNumThreads(), 4 * Gambit::GetNumThreads());
+  pipeline.Run(p_game, supports.Length(),
+	       [&supports](int i) { return SupportFlags(supports[i]); },
+	       SolveOnSupport,
+	       [&p_game, &supports](int i, const SupportSolution &p_solution) {
     if (g_verbose) {
       PrintSupport(std::cout, "candidate", supports[i]);
     }
-      
-    bool isSingular = false;
-    List<MixedBehaviorProfile<double> > newsolns = 
-      SolveSupport(supports[i], isSingular);
-
-    for (int j = 1; j <= newsolns.Length(); j++) {
-      MixedBehaviorProfile<double> fullProfile = ToFullSupport(newsolns[j]);
-      if (fullProfile.GetLiapValue(true) < 1.0e-6) {
-	PrintProfile(std::cout, "NE", fullProfile);
+
+    for (int j = 1; j <= p_solution.m_profiles.Length(); j++) {
+      MixedBehaviorProfile<double> profile(p_game);
+      for (int k = 1; k <= profile.Length(); k++) {
+	profile[k] = p_solution.m_profiles[j][k];
       }
+      PrintProfile(std::cout, "NE", profile);
     }
       
-    if (isSingular && g_verbose) {
+    if (p_solution.m_singular && g_verbose) {
       PrintSupport(std::cout, "singular", supports[i]);
     }
-  }
+  });
 }
-
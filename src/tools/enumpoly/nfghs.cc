@@ -24,10 +24,15 @@
 
 #include <iostream>
 #include <fstream> 
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 #include "gambit.h"
 #include "nfgcpoly.h"
 #include "nfghs.h"
 
+
 extern MixedStrategyProfile<double> 
 ToFullSupport(const MixedStrategyProfile<double> &p_profile);
 
@@ -36,6 +41,402 @@ void PrintProfile(std::ostream &p_stream,
 		  const std::string &p_label,
 		  const MixedStrategyProfile<double> &p_profile);
 
+//---------------------------------------------------------------------------
+//                 gbtNfgHsBimatrix: two-player supports
+//---------------------------------------------------------------------------
+
+//
+// In a two-player game the indifference conditions for a support profile
+// are linear in the opponent's probabilities, and when both supports have
+// the same size (which is always the case for equilibria of nondegenerate
+// games) they form a square system for each player.  This class solves
+// those systems against dense payoff matrices, built once for each version
+// of the game, so that no restricted game or polynomial system is set up
+// per support.
+//
+class gbtNfgHsBimatrix {
+private:
+  Gambit::Array < Matrix < double > > m_payoffs;
+
+  bool SolvePlayer(int p_player,
+		   const Gambit::Array < GameStrategy > & p_own,
+		   const Gambit::Array < GameStrategy > & p_other,
+		   Vector < double > & p_probs) const;
+
+public:
+  gbtNfgHsBimatrix(const Game &p_game);
+
+  /// Solves the indifference conditions on the support profile, returning
+  /// the full-support profile in p_solution.  Returns false if the supports
+  /// are unbalanced or the system is singular, in which case the general
+  /// method must be used.  If the solution has a negative probability,
+  /// returns true with no profile, as the supports carry no equilibrium.
+  bool Solve(const Game &p_game,
+	     const Gambit::Array < Gambit::Array < GameStrategy > > & p_supports,
+	     Gambit::List < MixedStrategyProfile < double > > & p_solutions) const;
+};
+
+gbtNfgHsBimatrix::gbtNfgHsBimatrix(const Game &p_game)
+  : m_payoffs(2)
+{
+  int rows = p_game->GetPlayer(1)->NumStrategies();
+  int cols = p_game->GetPlayer(2)->NumStrategies();
+  PureStrategyProfile profile = p_game->NewPureStrategyProfile();
+  for (int pl = 1; pl <= 2; pl++) {
+    m_payoffs[pl] = Matrix < double > (rows, cols);
+  }
+  for (int i = 1; i <= rows; i++) {
+    profile->SetStrategy(p_game->GetPlayer(1)->GetStrategy(i));
+    for (int j = 1; j <= cols; j++) {
+      profile->SetStrategy(p_game->GetPlayer(2)->GetStrategy(j));
+      for (int pl = 1; pl <= 2; pl++) {
+	m_payoffs[pl](i, j) = (double) profile->GetPayoff(pl);
+      }
+    }
+  }
+}
+
+//
+// Computes the probabilities with which p_player plays the strategies in
+// p_own, so that the opponent is indifferent among the strategies in
+// p_other.  The unknowns are the probabilities and the opponent's payoff;
+// p_probs must have the length of p_own.
+//
+bool gbtNfgHsBimatrix::SolvePlayer(int p_player,
+				   const Gambit::Array < GameStrategy > & p_own,
+				   const Gambit::Array < GameStrategy > & p_other,
+				   Vector < double > & p_probs) const
+{
+  const Matrix < double > & payoffs = m_payoffs[3 - p_player];
+  int n = p_own.Length() + 1;
+  Matrix < double > A(n, n);
+  Vector < double > b(n);
+
+  for (int r = 1; r < n; r++) {
+    for (int c = 1; c < n; c++) {
+      if (p_player == 1) {
+	A(r, c) = payoffs(p_own[c]->GetNumber(), p_other[r]->GetNumber());
+      }
+      else {
+	A(r, c) = payoffs(p_other[r]->GetNumber(), p_own[c]->GetNumber());
+      }
+    }
+    A(r, n) = -1.0;
+    b[r] = 0.0;
+  }
+  for (int c = 1; c < n; c++) {
+    A(n, c) = 1.0;
+  }
+  A(n, n) = 0.0;
+  b[n] = 1.0;
+
+  // Gaussian elimination with partial pivoting
+  double scale = 0.0;
+  for (int r = 1; r <= n; r++) {
+    for (int c = 1; c <= n; c++) {
+      if (std::fabs(A(r, c)) > scale) {
+	scale = std::fabs(A(r, c));
+      }
+    }
+  }
+  for (int k = 1; k <= n; k++) {
+    int pivot = k;
+    for (int r = k + 1; r <= n; r++) {
+      if (std::fabs(A(r, k)) > std::fabs(A(pivot, k))) {
+	pivot = r;
+      }
+    }
+    if (std::fabs(A(pivot, k)) <= 1.0e-10 * scale) {
+      return false;
+    }
+    if (pivot != k) {
+      A.SwitchRows(k, pivot);
+      std::swap(b[k], b[pivot]);
+    }
+    for (int r = k + 1; r <= n; r++) {
+      double factor = A(r, k) / A(k, k);
+      for (int c = k; c <= n; c++) {
+	A(r, c) -= factor * A(k, c);
+      }
+      b[r] -= factor * b[k];
+    }
+  }
+  for (int k = n; k >= 1; k--) {
+    for (int c = k + 1; c <= n; c++) {
+      b[k] -= A(k, c) * b[c];
+    }
+    b[k] /= A(k, k);
+  }
+
+  for (int c = 1; c < n; c++) {
+    p_probs[c] = b[c];
+  }
+  return true;
+}
+
+//
+// Sets probabilities which are negative only by rounding error to zero.
+// Returns false if any probability is further below zero.
+//
+static bool ClampProbabilities(Vector < double > & p_probs)
+{
+  const double tolerance = 1.0e-8;
+  for (int c = 1; c <= p_probs.Length(); c++) {
+    if (p_probs[c] < -tolerance) {
+      return false;
+    }
+    else if (p_probs[c] <= 0.0) {
+      // this also replaces a negative zero, which prints as -0.000000
+      p_probs[c] = 0.0;
+    }
+  }
+  return true;
+}
+
+bool gbtNfgHsBimatrix::Solve(const Game &p_game,
+			     const Gambit::Array < Gambit::Array < GameStrategy > > & p_supports,
+			     Gambit::List < MixedStrategyProfile < double > > & p_solutions) const
+{
+  if (p_supports[1].Length() != p_supports[2].Length()) {
+    return false;
+  }
+
+  Vector < double > probs1(p_supports[1].Length()), probs2(p_supports[2].Length());
+  if (!SolvePlayer(1, p_supports[1], p_supports[2], probs1) ||
+      !SolvePlayer(2, p_supports[2], p_supports[1], probs2)) {
+    return false;
+  }
+
+  // The solution is unique, so if it has a negative probability, the
+  // supports carry no equilibrium
+  if (!ClampProbabilities(probs1) || !ClampProbabilities(probs2)) {
+    return true;
+  }
+
+  MixedStrategyProfile < double > profile(p_game->NewMixedStrategyProfile(0.0));
+  for (int i = 1; i <= profile.MixedProfileLength(); profile[i++] = 0.0);
+  for (int c = 1; c <= probs1.Length(); c++) {
+    profile[p_supports[1][c]] = probs1[c];
+  }
+  for (int c = 1; c <= probs2.Length(); c++) {
+    profile[p_supports[2][c]] = probs2[c];
+  }
+  p_solutions.Append(profile);
+  return true;
+}
+
+//---------------------------------------------------------------------------
+//                  gbtNfgHsScheduler: parallel search
+//---------------------------------------------------------------------------
+
+//
+// Coordinates the worker threads of a parallel search.  A unit of work
+// is one top-level branch of the backtracking search on a support size
+// profile, identified by the index of the profile and the index of the
+// first player's support in its domain.  Profiles are taken in the order
+// the sequential search visits them.  Each worker owns the range of
+// branches of the profile it took last, and a worker which runs out of
+// work steals the upper half of the remaining range of another worker
+// before moving on to the next profile.
+//
+// Work items are plain indices, so each worker searches on its own copy
+// of the game, and no game objects are shared between threads.
+// Equilibria are mapped back to the original game as they are found.
+//
+class gbtNfgHsScheduler {
+private:
+  struct Worker {
+    std::mutex m_mutex;      // guards the range of branches below
+    int m_profile, m_next, m_last;
+    Game m_game;
+
+    Worker(const Game &p_game)
+      : m_profile(0), m_next(1), m_last(0), m_game(p_game) { }
+  };
+
+  gbtNfgHs &m_solver;
+  Game m_game;
+  const Gambit::List < Gambit::Array < int > > &m_profiles;
+  Gambit::Array < Worker * > m_workers;
+
+  std::mutex m_mutex;        // guards the fields below
+  int m_nextProfile;
+  Gambit::List < MixedStrategyProfile < double > > m_solutions;
+  std::exception_ptr m_exception;
+
+  std::atomic<bool> m_cancelled;
+
+  int NumBranches(Worker &p_worker, const Gambit::Array < int > & p_profile) const;
+  bool TakeLocal(Worker &p_worker, int &p_profile, int &p_branch);
+  bool Steal(int p_thief, int &p_profile, int &p_branch);
+  bool TakeProfile(Worker &p_worker, int &p_profile, int &p_branch);
+
+public:
+  gbtNfgHsScheduler(gbtNfgHs &p_solver, const Game &p_game,
+		    const Gambit::List < Gambit::Array < int > > & p_profiles);
+  ~gbtNfgHsScheduler();
+
+  bool IsCancelled(void) const { return m_cancelled; }
+  bool RecordSolution(const MixedStrategyProfile < double > & p_solution);
+  const Gambit::List < MixedStrategyProfile < double > > &GetSolutions(void) const
+    { return m_solutions; }
+  void RethrowException(void) const
+    { if (m_exception) std::rethrow_exception(m_exception); }
+
+  void Work(int p_worker);
+};
+
+gbtNfgHsScheduler::gbtNfgHsScheduler(gbtNfgHs &p_solver, const Game &p_game,
+				     const Gambit::List < Gambit::Array < int > > & p_profiles)
+  : m_solver(p_solver), m_game(p_game), m_profiles(p_profiles),
+    m_workers(p_solver.NumThreads()), m_nextProfile(1), m_cancelled(false)
+{
+  for (int w = 1; w <= m_workers.Length(); w++) {
+    m_workers[w] = new Worker(p_game->Copy());
+  }
+}
+
+gbtNfgHsScheduler::~gbtNfgHsScheduler()
+{
+  for (int w = 1; w <= m_workers.Length(); w++) {
+    delete m_workers[w];
+  }
+}
+
+//
+// The number of entries GetInitialDomains places in the domain of the
+// first player.  This is counted by running the same enumeration, since
+// UpdatePlayerSupport does not produce exactly the subsets of the given
+// size for every size.
+//
+int gbtNfgHsScheduler::NumBranches(Worker &p_worker,
+				   const Gambit::Array < int > & p_profile) const
+{
+  Gambit::PVector < int > playerSupport(p_profile);
+  for (int i = 1; i <= m_solver.numPlayers; i++) {
+    for (int j = 1; j <= p_profile[i]; j++) {
+      playerSupport(i, j) = j;
+    }
+  }
+  int count = 1;
+  while (m_solver.UpdatePlayerSupport(p_worker.m_game, 1, playerSupport)) {
+    count++;
+  }
+  return count;
+}
+
+bool gbtNfgHsScheduler::TakeLocal(Worker &p_worker, int &p_profile, int &p_branch)
+{
+  std::lock_guard<std::mutex> lock(p_worker.m_mutex);
+  if (p_worker.m_next > p_worker.m_last) {
+    return false;
+  }
+  p_profile = p_worker.m_profile;
+  p_branch = p_worker.m_next++;
+  return true;
+}
+
+bool gbtNfgHsScheduler::Steal(int p_thief, int &p_profile, int &p_branch)
+{
+  Worker &thief = *m_workers[p_thief];
+  for (int i = 1; i < m_workers.Length(); i++) {
+    Worker &victim = *m_workers[(p_thief + i - 1) % m_workers.Length() + 1];
+    int profile, first, last;
+    {
+      std::lock_guard<std::mutex> lock(victim.m_mutex);
+      int remaining = victim.m_last - victim.m_next + 1;
+      if (remaining <= 0) {
+	continue;
+      }
+      profile = victim.m_profile;
+      last = victim.m_last;
+      first = last - (remaining + 1) / 2 + 1;
+      victim.m_last = first - 1;
+    }
+    std::lock_guard<std::mutex> lock(thief.m_mutex);
+    thief.m_profile = profile;
+    thief.m_next = first + 1;
+    thief.m_last = last;
+    p_profile = profile;
+    p_branch = first;
+    return true;
+  }
+  return false;
+}
+
+bool gbtNfgHsScheduler::TakeProfile(Worker &p_worker, int &p_profile, int &p_branch)
+{
+  int profile;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_nextProfile > m_profiles.Length()) {
+      return false;
+    }
+    profile = m_nextProfile++;
+  }
+  int branches = NumBranches(p_worker, m_profiles[profile]);
+  std::lock_guard<std::mutex> lock(p_worker.m_mutex);
+  p_worker.m_profile = profile;
+  p_worker.m_next = 2;
+  p_worker.m_last = branches;
+  p_profile = profile;
+  p_branch = 1;
+  return true;
+}
+
+bool gbtNfgHsScheduler::RecordSolution(const MixedStrategyProfile < double > & p_solution)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_cancelled) {
+    return true;
+  }
+  // Profiles found by a worker are defined on its copy of the game;
+  // both copies number their strategies identically.
+  MixedStrategyProfile < double > solution(m_game->NewMixedStrategyProfile(0.0));
+  for (int i = 1; i <= solution.MixedProfileLength(); i++) {
+    solution[i] = p_solution[i];
+  }
+  PrintProfile(std::cout, "NE", solution);
+  m_solutions.Append(solution);
+  if (m_solver.m_stopAfter > 0 && m_solutions.Length() >= m_solver.m_stopAfter) {
+    m_cancelled = true;
+  }
+  return m_cancelled;
+}
+
+void gbtNfgHsScheduler::Work(int p_worker)
+{
+  SetWorkerThread();
+  Worker &worker = *m_workers[p_worker];
+  int numPlayers = m_solver.numPlayers;
+  Gambit::Array < Gambit::Array < GameStrategy > > uninstantiatedSupports(numPlayers);
+  Gambit::Array < gbtNfgHsDomain > domains(numPlayers);
+  Gambit::List < MixedStrategyProfile < double > > solutions;
+  int builtProfile = 0, profile, branch;
+
+  try {
+    while (!m_cancelled &&
+	   (TakeLocal(worker, profile, branch) ||
+	    Steal(p_worker, profile, branch) ||
+	    TakeProfile(worker, profile, branch))) {
+      if (profile != builtProfile) {
+	domains = Gambit::Array < gbtNfgHsDomain > (numPlayers);
+	m_solver.GetInitialDomains(worker.m_game, m_profiles[profile], domains);
+	builtProfile = profile;
+      }
+      m_solver.InstantiateSupport(worker.m_game, solutions,
+				  uninstantiatedSupports, domains, 1, branch);
+    }
+  }
+  catch (...) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_exception) {
+      m_exception = std::current_exception();
+    }
+    m_cancelled = true;
+  }
+}
+
 //---------------------------------------------------------------------------
 //                      gbtNfgHs: member functions
 //---------------------------------------------------------------------------
@@ -76,14 +477,25 @@ void gbtNfgHs::Solve(Game game) {
 
   maxdiff = maxActions - 1;
 
+  //In a parallel search, the support size profiles are collected in the
+  //order the sequential search visits them, and handed out to the workers.
+  //A search started on a worker of another parallel layer is sequential.
+  bool parallel = (m_numThreads > 1 && !IsWorkerThread());
+  Gambit::List < Gambit::Array < int > > profiles;
+
   size = numPlayers;
   diff = 0;
   while ((size <= maxsize) && (diff <= maxdiff)) {
 
-    SolveSizeDiff(game, solutions, size, diff);
-    if ((m_stopAfter > 0) && (solutions.Length() >= m_stopAfter)) {
-      size = maxsize + 1;
-      diff = maxdiff + 1;
+    if (parallel) {
+      GetSupportSizeProfiles(size, diff, profiles);
+    }
+    else {
+      SolveSizeDiff(game, solutions, size, diff);
+      if (IsFinished(solutions)) {
+	size = maxsize + 1;
+	diff = maxdiff + 1;
+      }
     }
 
     if (preferBalance) {
@@ -102,6 +514,10 @@ void gbtNfgHs::Solve(Game game) {
     }
   }
 
+  if (parallel) {
+    SolveParallel(game, solutions, profiles);
+  }
+
   Cleanup(game);
 }
 
@@ -127,15 +543,28 @@ void gbtNfgHs::Initialize(Game p_game) {
     }
   }
 
+  if (m_cacheGame != p_game || m_cacheVersion != p_game->GetVersion()) {
+    ClearCache();
+    m_cacheGame = p_game;
+    m_cacheVersion = p_game->GetVersion();
+    delete m_bimatrix;
+    m_bimatrix = (numPlayers == 2) ? new gbtNfgHsBimatrix(p_game) : 0;
+  }
 }
 
 void gbtNfgHs::Cleanup(Game game) {
 }
 
+void gbtNfgHs::ClearCache(void) {
+  std::lock_guard<std::mutex> lock(m_cacheMutex);
+  m_cache.clear();
+}
+
 
 gbtNfgHs::gbtNfgHs(int p_stopAfter) 
   : m_iteratedRemoval(true), m_removalWhenUninstantiated(1),
-    m_ordering("automatic")
+    m_ordering("automatic"), m_numThreads(GetNumThreads()), m_scheduler(0), m_bimatrix(0),
+    m_cacheVersion(0)
 #ifdef DEBUG
   , m_logfile(std::cerr.rdbuf())
 #endif // DEBUG
@@ -143,6 +572,10 @@ gbtNfgHs::gbtNfgHs(int p_stopAfter)
   m_stopAfter = p_stopAfter;
 }
 
+gbtNfgHs::~gbtNfgHs() {
+  delete m_bimatrix;
+}
+
 void gbtNfgHs::SolveSizeDiff(Game game, Gambit::List < MixedStrategyProfile < double > > & solutions,
 			     int size, int diff) {
 
@@ -153,6 +586,33 @@ void gbtNfgHs::SolveSizeDiff(Game game, Gambit::List < MixedStrategyProfile < do
 #endif
   //------------------------------------
 
+  Gambit::List < Gambit::Array < int > > profiles;
+  GetSupportSizeProfiles(size, diff, profiles);
+  for (int i = 1; i <= profiles.Length(); i++) {
+    SolveSupportSizeProfile(game, solutions, profiles[i]);
+    if (IsFinished(solutions)) {
+      //------------------------------------
+      // Logging
+#ifdef DEBUG
+      m_logfile << "Exiting SolveSizeDiff1\n";
+#endif
+      //------------------------------------
+      return;
+    }
+  }
+
+  //------------------------------------
+  // Logging
+#ifdef DEBUG
+  m_logfile << "Exiting SolveSizeDiff2\n";
+#endif
+  //------------------------------------
+  return;
+}
+
+void gbtNfgHs::GetSupportSizeProfiles(int size, int diff,
+				      Gambit::List < Gambit::Array < int > > & profiles) {
+
   int i, j;
   Gambit::Array < int > supportSizeProfile(numPlayers);
   for (i = 1; i <= numPlayers; i++) {
@@ -208,26 +668,9 @@ void gbtNfgHs::SolveSizeDiff(Game game, Gambit::List < MixedStrategyProfile < do
       continue;
     }
     if (supportSizeProfile[numPlayers] <= numActions[numPlayers]) {
-      SolveSupportSizeProfile(game, solutions, supportSizeProfile);
-    }
-    if (m_stopAfter > 0 && solutions.Length() >= m_stopAfter) {
-      //------------------------------------
-      // Logging
-#ifdef DEBUG
-      m_logfile << "Exiting SolveSizeDiff1\n";
-#endif
-      //------------------------------------
-      return;
+      profiles.Append(supportSizeProfile);
     }
   }
-
-  //------------------------------------
-  // Logging
-#ifdef DEBUG
-  m_logfile << "Exiting SolveSizeDiff2\n";
-#endif
-  //------------------------------------
-  return;
 }
 
 
@@ -247,11 +690,18 @@ bool gbtNfgHs::SolveSupportSizeProfile(Game game,
   //------------------------------------
 
   Gambit::Array < Gambit::Array < GameStrategy > > uninstantiatedSupports(numPlayers);
-  Gambit::Array < Gambit::Array < Gambit::Array < GameStrategy > > > domains(numPlayers);
+  Gambit::Array < gbtNfgHsDomain > domains(numPlayers);
+  GetInitialDomains(game, supportSizeProfile, domains);
+  return RecursiveBacktracking(game, solutions, uninstantiatedSupports, domains, 1);
+
+}
+
+void gbtNfgHs::GetInitialDomains(Game game, const Gambit::Array < int > & supportSizeProfile,
+				 Gambit::Array < gbtNfgHsDomain > & domains) {
+
   Gambit::PVector < int > playerSupport(supportSizeProfile);
 
   for (int i = 1; i <= numPlayers; i++) {
-    uninstantiatedSupports[i] = 0;
     int m = 1;
     for (int j = 1; j <= supportSizeProfile[i]; j++) {
       playerSupport(i, j) = m;
@@ -270,8 +720,6 @@ bool gbtNfgHs::SolveSupportSizeProfile(Game game,
     }
     while (success);
   }
-  return RecursiveBacktracking(game, solutions, uninstantiatedSupports, domains, 1);
-
 }
 
 
@@ -355,7 +803,7 @@ bool gbtNfgHs::UpdatePlayerSupport(Game game, int playerIdx, Gambit::PVector < i
 
 bool gbtNfgHs::RecursiveBacktracking(Game game,
 				     Gambit::List < MixedStrategyProfile < double > > & solutions, Gambit::Array < Gambit::Array < GameStrategy > > & uninstantiatedSupports,
-				     Gambit::Array < Gambit::Array < Gambit::Array < GameStrategy > > > & domains, int idxNextSupport2Instantiate) {
+				     Gambit::Array < gbtNfgHsDomain > & domains, int idxNextSupport2Instantiate) {
 
   //------------------------------------
   // Logging
@@ -404,51 +852,62 @@ bool gbtNfgHs::RecursiveBacktracking(Game game,
     //m_logfile << "Player " << idx << " domains length: " << domains[idx].Length() << " @@\n";
     int domainLength = domains[idx].Length();
     for (int k = 1; k <= domainLength; k++) {
-      uninstantiatedSupports[idx] = domains[idx] [k];
-      //------------------------------------
-      // Logging
-#ifdef DEBUG
-      m_logfile << "\nNow instantiate strategy for player " << idx << " :";
-      for (int i = 1; i <= uninstantiatedSupports[idx].Length(); i++) {
-	m_logfile << uninstantiatedSupports[idx] [i]->GetNumber() << ' ';
+      if (InstantiateSupport(game, solutions, uninstantiatedSupports, domains, idx, k)) {
+	return true;
       }
-      m_logfile << "\n";
+    }
+
+    return false;
+  }
+}
+
+bool gbtNfgHs::InstantiateSupport(Game game,
+				  Gambit::List < MixedStrategyProfile < double > > & solutions, Gambit::Array < Gambit::Array < GameStrategy > > & uninstantiatedSupports,
+				  Gambit::Array < gbtNfgHsDomain > & domains, int idx, int k) {
+
+  if (IsFinished(solutions)) {
+    return true;
+  }
+
+  uninstantiatedSupports[idx] = domains[idx] [k];
+  //------------------------------------
+  // Logging
+#ifdef DEBUG
+  m_logfile << "\nNow instantiate strategy for player " << idx << " :";
+  for (int i = 1; i <= uninstantiatedSupports[idx].Length(); i++) {
+    m_logfile << uninstantiatedSupports[idx] [i]->GetNumber() << ' ';
+  }
+  m_logfile << "\n";
 #endif
-      //------------------------------------
+  //------------------------------------
 
-      Gambit::Array < Gambit::Array < Gambit::Array < GameStrategy > > > newDomains(numPlayers);
-      for (int ii = 1; ii <= idx; ii++) {
-	newDomains[ii].Append(uninstantiatedSupports[ii]);
-      }
-      for (int ii = idx + 1; ii <= numPlayers; ii++) {
-	newDomains[ii] = domains[ii];
-      }
-      bool success = true;
-      if (IteratedRemoval()) {
-	success = IteratedRemovalStrictlyDominatedStrategies(game, newDomains);
-      }
-      if (success) {
-	// update domain
-	//for (int ii = idx + 1; ii <= numPlayers; ii++) {
-	//  domains[ii] = newDomains[ii];
-	//  }
-
-	if (RecursiveBacktracking(game, solutions, uninstantiatedSupports, newDomains, idx + 1)) {
-	  if ((m_stopAfter > 0) && (solutions.Length() >= m_stopAfter)) {
-	    return true;
-	  }
-	}
+  // Domains of players not yet instantiated are shared with the parent
+  // until iterated removal prunes them.
+  Gambit::Array < gbtNfgHsDomain > newDomains(numPlayers);
+  for (int ii = 1; ii <= idx; ii++) {
+    newDomains[ii].Append(uninstantiatedSupports[ii]);
+  }
+  for (int ii = idx + 1; ii <= numPlayers; ii++) {
+    newDomains[ii] = domains[ii];
+  }
+  bool success = true;
+  if (IteratedRemoval()) {
+    success = IteratedRemovalStrictlyDominatedStrategies(game, newDomains);
+  }
+  if (success) {
+    if (RecursiveBacktracking(game, solutions, uninstantiatedSupports, newDomains, idx + 1)) {
+      if (IsFinished(solutions)) {
+	return true;
       }
     }
-
-    return false;
   }
+  return false;
 }
 
 
 
 bool gbtNfgHs::IteratedRemovalStrictlyDominatedStrategies(Game game,
-							  Gambit::Array < Gambit::Array < Gambit::Array < GameStrategy > > > & domains) {
+							  Gambit::Array < gbtNfgHsDomain > & domains) {
 
   //------------------------------------
   // Logging
@@ -576,7 +1035,7 @@ bool gbtNfgHs::IteratedRemovalStrictlyDominatedStrategies(Game game,
   return true;
 }
 
-void gbtNfgHs::GetDomainStrategies(Gambit::Array < Gambit::Array < Gambit::Array < GameStrategy > > > & domains,
+void gbtNfgHs::GetDomainStrategies(Gambit::Array < gbtNfgHsDomain > & domains,
 				   Gambit::Array < Gambit::Array < GameStrategy > > & domainStrategies) {
 
   for (int i = 1; i <= numPlayers; i++) {
@@ -644,7 +1103,7 @@ bool gbtNfgHs::IsConditionalDominated(StrategySupportProfile & dominatedGame,
 
 
 
-bool gbtNfgHs::RemoveFromDomain(Gambit::Array < Gambit::Array < Gambit::Array < GameStrategy > > > & domains,
+bool gbtNfgHs::RemoveFromDomain(Gambit::Array < gbtNfgHsDomain > & domains,
 				Gambit::Array < Gambit::Array < GameStrategy > > & domainStrategies, int player, int removeStrategyIdx) {
 
   GameStrategy removeStrategy = domainStrategies[player] [removeStrategyIdx];
@@ -664,41 +1123,118 @@ bool gbtNfgHs::RemoveFromDomain(Gambit::Array < Gambit::Array < Gambit::Array <
   }
 }
 
+// Bound on the number of support profiles whose feasibility is remembered
+static const size_t MaxCacheSize = 1 << 20;
+
+std::vector<uint64_t> gbtNfgHs::SupportKey(Gambit::Array < Gambit::Array < GameStrategy > > & supports) const {
+  int length = 0;
+  for (int pl = 1; pl <= numPlayers; pl++) {
+    length += numActions[pl];
+  }
+  std::vector<uint64_t> key((length + 63) / 64, 0);
+  for (int pl = 1, offset = 0; pl <= numPlayers; offset += numActions[pl++]) {
+    for (int j = 1; j <= supports[pl].Length(); j++) {
+      int bit = offset + supports[pl][j]->GetNumber() - 1;
+      key[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+  }
+  return key;
+}
+
 bool gbtNfgHs::FeasibilityProgram(Game game,
 				  Gambit::List < MixedStrategyProfile < double > > & solutions, Gambit::Array < Gambit::Array < GameStrategy > > & uninstantiatedSupports) {
 
-
-  StrategySupportProfile restrictedGame(game);
-  for (int pl = 1; pl <= numPlayers; pl++) {
-    for (int st = 1; st <= game->GetPlayer(pl)->NumStrategies(); st++) {
-      if (!uninstantiatedSupports[pl].Contains(game->GetPlayer(pl)->GetStrategy(st))) {
-	restrictedGame.RemoveStrategy(game->GetPlayer(pl)->GetStrategy(st));
-      }
+  std::vector<uint64_t> key = SupportKey(uninstantiatedSupports);
+  FeasibilityResult result;
+  bool cached = false;
+  {
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    std::map < std::vector<uint64_t>, FeasibilityResult >::const_iterator entry = m_cache.find(key);
+    if (entry != m_cache.end() && (entry->second.m_complete || m_stopAfter == 1)) {
+      result = entry->second;
+      cached = true;
     }
   }
+
+  if (!cached) {
+    Gambit::List < MixedStrategyProfile < double > > newSolutions;
+    result.m_complete = true;
+    if (!m_bimatrix || !m_bimatrix->Solve(game, uninstantiatedSupports, newSolutions)) {
+      StrategySupportProfile restrictedGame(game);
+      for (int pl = 1; pl <= numPlayers; pl++) {
+	for (int st = 1; st <= game->GetPlayer(pl)->NumStrategies(); st++) {
+	  if (!uninstantiatedSupports[pl].Contains(game->GetPlayer(pl)->GetStrategy(st))) {
+	    restrictedGame.RemoveStrategy(game->GetPlayer(pl)->GetStrategy(st));
+	  }
+	}
+      }
      
-  Gambit::List < MixedStrategyProfile < double > > newSolutions;
-  HeuristicPolEnumModule module(restrictedGame, (m_stopAfter == 1) ? 1 : 0);
-  module.PolEnum();
-  newSolutions = module.GetSolutions();
-
-  bool gotSolutions = false;
-  for (int k = 1; k <= newSolutions.Length(); k++) {
-    MixedStrategyProfile < double > solutionToTest = ToFullSupport(newSolutions[k]);
-    if (solutionToTest.GetLiapValue() <.01) {
-      gotSolutions = true;
-      PrintProfile(std::cout, "NE", solutionToTest);
-      solutions.Append(solutionToTest);
-      if ((m_stopAfter > 0) && (solutions.Length() >= m_stopAfter)) {
-	return true;
+      HeuristicPolEnumModule module(restrictedGame, (m_stopAfter == 1) ? 1 : 0);
+      module.PolEnum();
+      for (int k = 1; k <= module.GetSolutions().Length(); k++) {
+	newSolutions.Append(ToFullSupport(module.GetSolutions()[k]));
+      }
+      result.m_complete = (m_stopAfter != 1);
+    }
+
+    for (int k = 1; k <= newSolutions.Length(); k++) {
+      if (newSolutions[k].GetLiapValue() <.01) {
+	result.m_solutions.Append(newSolutions[k]);
       }
     }
+
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    if (m_cache.size() < MaxCacheSize) {
+      m_cache[key] = result;
+    }
   }
-  if (gotSolutions) {
-    return true;
+
+  for (int k = 1; k <= result.m_solutions.Length(); k++) {
+    MixedStrategyProfile < double > solution(game->NewMixedStrategyProfile(0.0));
+    for (int i = 1; i <= solution.MixedProfileLength(); i++) {
+      solution[i] = result.m_solutions[k][i];
+    }
+    if (RecordSolution(solutions, solution)) {
+      return true;
+    }
   }
-  else {
-    return false;
+  return (result.m_solutions.Length() > 0);
+}
+
+
+bool gbtNfgHs::IsFinished(const Gambit::List < MixedStrategyProfile < double > > & solutions) const {
+  if (m_scheduler) {
+    return m_scheduler->IsCancelled();
   }
+  return (m_stopAfter > 0) && (solutions.Length() >= m_stopAfter);
 }
 
+bool gbtNfgHs::RecordSolution(Gambit::List < MixedStrategyProfile < double > > & solutions,
+			      const MixedStrategyProfile < double > & solution) {
+  if (m_scheduler) {
+    return m_scheduler->RecordSolution(solution);
+  }
+  PrintProfile(std::cout, "NE", solution);
+  solutions.Append(solution);
+  return IsFinished(solutions);
+}
+
+void gbtNfgHs::SolveParallel(Game game, Gambit::List < MixedStrategyProfile < double > > & solutions,
+			     const Gambit::List < Gambit::Array < int > > & profiles) {
+
+  gbtNfgHsScheduler scheduler(*this, game, profiles);
+  m_scheduler = &scheduler;
+
+  Gambit::Array < std::thread * > threads(m_numThreads);
+  for (int w = 1; w <= m_numThreads; w++) {
+    threads[w] = new std::thread(&gbtNfgHsScheduler::Work, &scheduler, w);
+  }
+  for (int w = 1; w <= m_numThreads; w++) {
+    threads[w]->join();
+    delete threads[w];
+  }
+
+  m_scheduler = 0;
+  scheduler.RethrowException();
+  solutions = scheduler.GetSolutions();
+}
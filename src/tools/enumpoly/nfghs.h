@@ -26,16 +26,77 @@
 #ifndef NFGHS_H
 #define NFGHS_H
 
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
 #include "gambit.h"
 
 using namespace Gambit;
 
+/// The domain of a player in the backtracking search: the list of
+/// candidate supports of the current size which have not yet been
+/// pruned.  A child of a search node usually inherits its parent's
+/// domain unchanged, so the underlying array is shared, and is only
+/// copied when a strategy is removed from it.
+class gbtNfgHsDomain {
+private:
+  Gambit::shared_ptr<Gambit::Array<Gambit::Array<GameStrategy> > > m_supports;
+
+  /// Ensure this domain holds the only reference to its supports
+  void Detach(void)
+  {
+    if (!m_supports.unique()) {
+      m_supports = new Gambit::Array<Gambit::Array<GameStrategy> >(*m_supports);
+    }
+  }
+
+public:
+  gbtNfgHsDomain(void) 
+    : m_supports(new Gambit::Array<Gambit::Array<GameStrategy> >) { }
+
+  int Length(void) const { return m_supports->Length(); }
+  const Gambit::Array<GameStrategy> &operator[](int i) const
+    { return (*m_supports)[i]; }
+
+  void Append(const Gambit::Array<GameStrategy> &p_support)
+    { Detach(); m_supports->Append(p_support); }
+  void Remove(int i) { Detach(); m_supports->Remove(i); }
+};
+
+class gbtNfgHsScheduler;
+class gbtNfgHsBimatrix;
+
 class gbtNfgHs {
+  friend class gbtNfgHsScheduler;
 private:
+  /// Result of the feasibility program on one support profile, stored
+  /// as the full-support probability vectors of the equilibria found
+  struct FeasibilityResult {
+    /// False if the polynomial solver stopped after the first root
+    bool m_complete;
+    Gambit::List < Gambit::Vector < double > > m_solutions;
+  };
+
   int m_stopAfter;
   bool m_iteratedRemoval;
   int m_removalWhenUninstantiated;
   std::string m_ordering;
+  int m_numThreads;
+
+  /// Shared state of a parallel search; null when solving sequentially
+  gbtNfgHsScheduler *m_scheduler;
+
+  /// Direct solver for two-player games; null for other games.  Like
+  /// the cache, it is kept across calls to Solve() on the same game
+  gbtNfgHsBimatrix *m_bimatrix;
+
+  /// Feasibility results by support bitmask, kept across calls to Solve()
+  /// on the same game, as long as the game has not changed since
+  Game m_cacheGame;
+  unsigned long m_cacheVersion;
+  std::map < std::vector<uint64_t>, FeasibilityResult > m_cache;
+  std::mutex m_cacheMutex;
 
 #ifdef DEBUG
   std::ostream m_logfile;
@@ -55,9 +116,15 @@ private:
   void SolveSizeDiff(Game game, Gambit::List < MixedStrategyProfile < double > > & solutions,
 			       int size, int diff);
 
+  void GetSupportSizeProfiles(int size, int diff,
+			      Gambit::List < Gambit::Array < int > > & profiles);
+
   bool SolveSupportSizeProfile(Game game, Gambit::List < MixedStrategyProfile < double > > & solutions,
 			       const Gambit::Array < int > & supportSizeProfile);
 
+  void GetInitialDomains(Game game, const Gambit::Array < int > & supportSizeProfile,
+			 Gambit::Array < gbtNfgHsDomain > & domains);
+
   void GetSupport(Game game, int playerIdx, const Vector < int > & support,
 		  Gambit::Array<GameStrategy> & supportBlock);
 
@@ -65,12 +132,16 @@ private:
 
   bool RecursiveBacktracking(Game game, Gambit::List < MixedStrategyProfile < double > > & solutions,
 			     Gambit::Array < Gambit::Array < GameStrategy > > & uninstantiatedSupports,
-			     Gambit::Array < Gambit::Array < Gambit::Array < GameStrategy > > > & domains, int idxNextSupport2Instantiate);
+			     Gambit::Array < gbtNfgHsDomain > & domains, int idxNextSupport2Instantiate);
+
+  bool InstantiateSupport(Game game, Gambit::List < MixedStrategyProfile < double > > & solutions,
+			  Gambit::Array < Gambit::Array < GameStrategy > > & uninstantiatedSupports,
+			  Gambit::Array < gbtNfgHsDomain > & domains, int idx, int k);
 
   bool IteratedRemovalStrictlyDominatedStrategies(Game game,
-						  Gambit::Array < Gambit::Array < Gambit::Array < GameStrategy > > > & domains);
+						  Gambit::Array < gbtNfgHsDomain > & domains);
 
-  void GetDomainStrategies(Gambit::Array < Gambit::Array < Gambit::Array < GameStrategy > > > & domains,
+  void GetDomainStrategies(Gambit::Array < gbtNfgHsDomain > & domains,
 			   Gambit::Array < Gambit::Array < GameStrategy > > & domainStrategies);
 
   bool IsConditionalDominatedBy(StrategySupportProfile & dominatedGame, Gambit::Array < Gambit::Array < GameStrategy > > & domainStrategies,
@@ -80,18 +151,28 @@ private:
 			      Gambit::Array<Gambit::Array<GameStrategy> > & domainStrategies,
 			      const GameStrategy &strategy, bool strict);
 
-  bool RemoveFromDomain(Gambit::Array<Gambit::Array<Gambit::Array<GameStrategy> > > & domains,
+  bool RemoveFromDomain(Gambit::Array<gbtNfgHsDomain> & domains,
 			Gambit::Array<Gambit::Array<GameStrategy> > & domainStrategies, int player, int removeStrategyIdx);
 
   bool FeasibilityProgram(Game game, Gambit::List<MixedStrategyProfile < double > > & solutions,
 			  Gambit::Array < Gambit::Array < GameStrategy > > & uninstantiatedSupports);
 
+  /// The supports as a bitmask, one bit per strategy, packed in words
+  std::vector<uint64_t> SupportKey(Gambit::Array < Gambit::Array < GameStrategy > > & supports) const;
+
+  bool RecordSolution(Gambit::List<MixedStrategyProfile < double > > & solutions,
+		      const MixedStrategyProfile<double> &solution);
+
+  bool IsFinished(const Gambit::List<MixedStrategyProfile < double > > & solutions) const;
+
+  void SolveParallel(Game game, Gambit::List < MixedStrategyProfile < double > > & solutions,
+		     const Gambit::List < Gambit::Array < int > > & profiles);
+
 
 public:
   gbtNfgHs(int = 1);
 
-  virtual ~gbtNfgHs() {
-  }
+  virtual ~gbtNfgHs();
 
   int StopAfter(void)const {
     return m_stopAfter;
@@ -125,6 +206,24 @@ public:
     m_ordering = p_ordering;
   }
 
+  /// Number of worker threads used by the search; with more than one,
+  /// support size profiles and the top-level branches of the backtracking
+  /// search are shared out among the workers.  This defaults to the
+  /// number of threads allowed by Gambit::SetNumThreads() when the
+  /// solver is constructed.
+  int NumThreads(void)const {
+    return m_numThreads;
+  }
+
+  /// Sets the number of worker threads for this solver alone
+  void SetNumThreads(int p_numThreads) {
+    m_numThreads = (p_numThreads > 0) ? p_numThreads : 1;
+  }
+
+  /// Forget the feasibility results of earlier calls to Solve().  This
+  /// must be called if the payoffs of the game are changed in between.
+  void ClearCache(void);
+
   void Solve(Game);
 };
 
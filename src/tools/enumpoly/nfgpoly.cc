@@ -24,6 +24,7 @@
 #include <iostream>
 #include <iomanip>
 
+#include "suppipe.h"
 #include "nfgensup.h"
 #include "gpoly.h"
 #include "gpolylst.h"
@@ -478,37 +479,106 @@ void PrintSupport(std::ostream &p_stream,
   p_stream << std::endl;
 }
 
-void SolveStrategic(const Gambit::Game &p_nfg)
-{
-  Gambit::List<Gambit::StrategySupportProfile> supports = PossibleNashSubsupports(p_nfg);
+namespace {
 
-  for (int i = 1; i <= supports.Length(); i++) {
-    long newevals = 0;
-    double newtime = 0.0;
-    Gambit::List<Gambit::MixedStrategyProfile<double> > newsolns;
-    bool is_singular = false;
-    
-    if (g_verbose) {
-      PrintSupport(std::cout, "candidate", supports[i]);
+//
+// The strategies in a support, as flags over all strategies of the
+// game, listed by player; this identifies the support on any copy
+// of the game.
+//
+Gambit::Array<int> SupportFlags(const Gambit::StrategySupportProfile &p_support)
+{
+  Gambit::Game nfg = p_support.GetGame();
+  Gambit::Array<int> flags(nfg->MixedProfileLength());
+  int index = 1;
+  for (int pl = 1; pl <= nfg->NumPlayers(); pl++) {
+    Gambit::GamePlayer player = nfg->GetPlayer(pl);
+    for (int st = 1; st <= player->NumStrategies(); st++) {
+      flags[index++] = p_support.Contains(player->GetStrategy(st)) ? 1 : 0;
     }
+  }
+  return flags;
+}
 
-    PolEnum(supports[i], newsolns, newevals, newtime, is_singular);
-      
-    for (int j = 1; j <= newsolns.Length(); j++) {
-      Gambit::MixedStrategyProfile<double> fullProfile = ToFullSupport(newsolns[j]);
-      if (fullProfile.GetLiapValue() < 1.0e-6) {
-	PrintProfile(std::cout, "NE", fullProfile);
+Gambit::StrategySupportProfile SupportFromFlags(const Gambit::Game &p_nfg,
+						const Gambit::Array<int> &p_flags)
+{
+  Gambit::StrategySupportProfile support(p_nfg);
+  int index = 1;
+  for (int pl = 1; pl <= p_nfg->NumPlayers(); pl++) {
+    Gambit::GamePlayer player = p_nfg->GetPlayer(pl);
+    for (int st = 1; st <= player->NumStrategies(); st++) {
+      if (!p_flags[index++]) {
+	support.RemoveStrategy(player->GetStrategy(st));
       }
     }
+  }
+  return support;
+}
 
-    if (is_singular && g_verbose) {
-      PrintSupport(std::cout, "singular", supports[i]);
+//
+// The equilibria found on a support, as probability vectors over the
+// full set of strategies
+//
+struct SupportSolution {
+  Gambit::List<Gambit::Vector<double> > m_profiles;
+  bool m_singular;
+};
+
+SupportSolution SolveOnSupport(const Gambit::Game &p_nfg,
+			       const Gambit::Array<int> &p_flags)
+{
+  long newevals = 0;
+  double newtime = 0.0;
+  Gambit::List<Gambit::MixedStrategyProfile<double> > newsolns;
+  SupportSolution solution;
+  solution.m_singular = false;
+    
+  PolEnum(SupportFromFlags(p_nfg, p_flags), newsolns, newevals, newtime,
+	  solution.m_singular);
+      
+  for (int j = 1; j <= newsolns.Length(); j++) {
+    Gambit::MixedStrategyProfile<double> fullProfile = ToFullSupport(newsolns[j]);
+    if (fullProfile.GetLiapValue() < 1.0e-6) {
+      Gambit::Vector<double> probs(fullProfile.MixedProfileLength());
+      for (int i = 1; i <= probs.Length(); i++) {
+	probs[i] = fullProfile[i];
+      }
+      solution.m_profiles.Append(probs);
     }
   }
+  return solution;
 }
 
+}  // end anonymous namespace
 
+void SolveStrategic(const Gambit::Game &p_nfg)
+{
+  Gambit::List<Gambit::StrategySupportProfile> supports = PossibleNashSubsupports(p_nfg);
 
+  // Supports are solved concurrently on the threads allowed by
+  // SetNumThreads(); the output is the same as, and in the same order
+  // as, solving them one by one.
+  SupportPipeline<Gambit::Array<int>, SupportSolution> 
+    pipeline(Gambit::GetNumThreads(), 4 * Gambit::GetNumThreads());
+  pipeline.Run(p_nfg, supports.Length(),
+	       [&supports](int i) { return SupportFlags(supports[i]); },
+	       SolveOnSupport,
+	       [&p_nfg, &supports](int i, const SupportSolution &p_solution) {
+    if (g_verbose) {
+      PrintSupport(std::cout, "candidate", supports[i]);
+    }
 
+    for (int j = 1; j <= p_solution.m_profiles.Length(); j++) {
+      Gambit::MixedStrategyProfile<double> profile(p_nfg->NewMixedStrategyProfile(0.0));
+      for (int k = 1; k <= profile.MixedProfileLength(); k++) {
+	profile[k] = p_solution.m_profiles[j][k];
+      }
+      PrintProfile(std::cout, "NE", profile);
+    }
 
-
+    if (p_solution.m_singular && g_verbose) {
+      PrintSupport(std::cout, "singular", supports[i]);
+    }
+  });
+}
@@ -33,7 +33,10 @@
 /************** Implementation of class Pelview **************/
 /*************************************************************/
 
-node SaveList=0; 
+// Pelican's working storage (symbol table, node store, qhull state,
+// the save list below) is kept per thread, so that systems may be 
+// solved concurrently on different threads.
+thread_local node SaveList=0; 
 
 void PelView::InitializePelicanMemory() const
 {
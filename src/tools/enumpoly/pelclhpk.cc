@@ -15,6 +15,13 @@ ALL RIGHTS RESERVED
   it as a starting point for path continuation.
 --------------------------------------------------------------------*/
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/threads.h"
 #include "pelclhpk.h"
 
 #define X(i) (DVref(X,i))
@@ -22,10 +29,10 @@ ALL RIGHTS RESERVED
 int HPK_cont(Dvector X, int tweak)
 {
     int i, ist, dst,N,N1;
-    static int iflag,trace,nfe,*pivot,*ipar;
-    static double *yold,*a,arcae;
-    static double *qr, arclen, *wp, *yp, *tz,*par,*z0,*z1;
-    static double ansre, *ypold, *sspar,*alpha,ansae,*w,*y,arcre;
+    int iflag,trace,nfe,*pivot,*ipar;
+    double *yold,*a,arcae;
+    double *qr, arclen, *wp, *yp, *tz,*par,*z0,*z1;
+    double ansre, *ypold, *sspar,*alpha,ansae,*w,*y,arcre;
     /* extern int fixpnf_(); IN Homotopies.h */
     
     if (Hom_defd!=1) return 0;
@@ -105,3 +112,165 @@ return 0;
 } 
 
 #undef X
+
+/*-------------------------------------------------------------------
+ Parallel path tracking.
+
+ Paths are independent once the homotopy is fixed, so they are handed 
+ to a pool of worker threads.  Each worker has its own HOMPACK 
+ workspace; the homotopy defined on the calling thread is copied with
+ Hom_state_save and installed on a worker by Hom_state_load the first
+ time the worker picks up one of its paths.  Each path's end point is 
+ written back into its own Dvector, so the solution list keeps the 
+ order it would have had if the paths were tracked one by one.
+
+ Between HPK_begin and HPK_end, HPK_track returns as soon as the paths
+ are queued, so that the caller can go on building the next homotopy 
+ (G_Solve does this for the start systems of the mixed cells) while 
+ earlier paths are being tracked.
+
+ The pool is opt-in: paths are tracked on the calling thread unless
+ Gambit::SetNumThreads() allows more than one thread, and always when
+ the caller is itself a worker thread of the library, such as one of
+ the support pipeline or the heuristic search.
+--------------------------------------------------------------------*/
+
+/* the number of threads to track paths on */
+static int HPK_threads(void)
+{
+  return Gambit::GetNumThreads();
+}
+
+class HPK_Batch {
+private:
+  struct Homotopy {
+    Hom_state m_state;
+    int m_id, m_remaining;
+  };
+  struct Path {
+    Homotopy *m_hom;
+    Dvector m_point;
+  };
+
+  int m_tweak, m_nextId;
+  bool m_closed;
+  std::mutex m_mutex;
+  std::condition_variable m_queued, m_finished;
+  std::deque<Path> m_paths;
+  int m_pending;        // homotopies with paths still to be tracked
+  std::vector<std::thread> m_workers;
+
+  void Work(void)
+  {
+    Gambit::SetWorkerThread();
+    int loaded = -1;
+    for (;;) {
+      Path path;
+      {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_queued.wait(lock, [this]() { return !m_paths.empty() || m_closed; });
+	if (m_paths.empty()) return;
+	path = m_paths.front();
+	m_paths.pop_front();
+      }
+      if (path.m_hom->m_id != loaded) {
+	Hom_state_load(path.m_hom->m_state);
+	loaded = path.m_hom->m_id;
+      }
+      HPK_cont(path.m_point, m_tweak);
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (--path.m_hom->m_remaining == 0) {
+	Hom_state_free(path.m_hom->m_state);
+	delete path.m_hom;
+	m_pending--;
+	m_finished.notify_all();
+      }
+    }
+  }
+
+public:
+  HPK_Batch(int p_tweak, int p_threads)
+    : m_tweak(p_tweak), m_nextId(0), m_closed(false), m_pending(0)
+  {
+    for (int i = 0; i < p_threads; i++) {
+      m_workers.push_back(std::thread(&HPK_Batch::Work, this));
+    }
+  }
+  ~HPK_Batch() { Finish(); }
+
+  int Tweak(void) const { return m_tweak; }
+
+  /* queue the paths starting at the points in the list, for the 
+     homotopy currently defined on the calling thread */
+  void Track(node point_list)
+  {
+    if (point_list == 0) return;
+    Homotopy *hom = new Homotopy;
+    hom->m_state = Hom_state_save();
+    hom->m_id = m_nextId++;
+    hom->m_remaining = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    /* bound the number of homotopies held in memory at once */
+    m_finished.wait(lock, [this]() { 
+	return m_pending < 4 * (int) m_workers.size(); 
+      });
+    for (node ptr = point_list; ptr != 0; ptr = Cdr(ptr)) {
+      Path path;
+      path.m_hom = hom;
+      path.m_point = (Dmatrix) Car(Car(ptr));
+      m_paths.push_back(path);
+      hom->m_remaining++;
+    }
+    m_pending++;
+    m_queued.notify_all();
+  }
+
+  void Finish(void)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_closed = true;
+    }
+    m_queued.notify_all();
+    for (std::thread &worker : m_workers) {
+      worker.join();
+    }
+    m_workers.clear();
+  }
+};
+
+static thread_local HPK_Batch *HPK_batch = 0;
+
+void HPK_begin(int tweak)
+{
+  if (HPK_batch != 0 || HPK_threads() <= 1) return;
+  HPK_batch = new HPK_Batch(tweak, HPK_threads());
+}
+
+void HPK_end(void)
+{
+  if (HPK_batch == 0) return;
+  HPK_Batch *batch = HPK_batch;
+  HPK_batch = 0;
+  batch->Finish();
+  delete batch;
+}
+
+int HPK_track(node point_list, int tweak)
+{
+  if (Hom_defd != 1) return 0;
+  if (HPK_batch != 0 && HPK_batch->Tweak() == tweak) {
+    HPK_batch->Track(point_list);
+    return 0;
+  }
+  if (HPK_threads() <= 1 || point_list == 0 || Cdr(point_list) == 0) {
+    for (node ptr = point_list; ptr != 0; ptr = Cdr(ptr)) {
+      HPK_cont((Dmatrix) Car(Car(ptr)), tweak);
+    }
+    return 0;
+  }
+  HPK_Batch batch(tweak, HPK_threads());
+  batch.Track(point_list);
+  batch.Finish();
+  return 0;
+}
@@ -44,4 +44,13 @@ void print_proj_trans();
 
 int HPK_cont(Dvector X, int tweak);
 
+/* tracks the paths starting at the points in the list for the
+   homotopy currently defined, writing the end points in place */
+int HPK_track(node point_list, int tweak);
+
+/* between HPK_begin and HPK_end, HPK_track only queues the paths;
+   HPK_end waits until all of them have been tracked */
+void HPK_begin(int tweak);
+void HPK_end(void);
+
 #endif  /* CALL_HPK_H */
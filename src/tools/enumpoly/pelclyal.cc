@@ -10,35 +10,37 @@
 /*
 ******************************************************************
 ** Global  Variables
+**   (one copy per thread, so that solves on different threads 
+**    do not interfere)
 ******************************************************************
 */
-int cly_Npts=0;      /* the number of points in the config */
-int cly_N=0;        /* the dimension of the cayley point config */
-int cly_R=0;        /* the number of point configs */
-int cly_Dim=0;        /* the dimension of the Aset */
-int next_id=1; /*for debuging cells are labled by a unique id*/
+thread_local int cly_Npts=0;      /* the number of points in the config */
+thread_local int cly_N=0;        /* the dimension of the cayley point config */
+thread_local int cly_R=0;        /* the number of point configs */
+thread_local int cly_Dim=0;        /* the dimension of the Aset */
+thread_local int next_id=1; /*for debuging cells are labled by a unique id*/
 
 /*
 ** The matrices here are used for now to avoid problems,
 ** they will eventually be stored with the individual cells.
 */
 
-HMatrix cly_U=0;   /* factor matrix */ 
-HMatrix cly_M=0;   /* an n+1xn+1 matrix   */
-HMatrix cly_L=0;   /* an n+1 vector   */
-Imatrix cly_T=0;   /* an R vector */
+thread_local HMatrix cly_U=0;   /* factor matrix */ 
+thread_local HMatrix cly_M=0;   /* an n+1xn+1 matrix   */
+thread_local HMatrix cly_L=0;   /* an n+1 vector   */
+thread_local Imatrix cly_T=0;   /* an R vector */
 
 /*
 ** two temporary variables used by the Hint macroes
 */
-Hint cly_temp;
-int cly_det;
+thread_local Hint cly_temp;
+thread_local int cly_det;
 /*
 ** controll parameters
 **
 */
-int cly_order=TRUE;
-int cly_lift=TRUE;
+thread_local int cly_order=TRUE;
+thread_local int cly_lift=TRUE;
 
 
 /* 
@@ -1027,15 +1029,15 @@ static node relift(node *, int tweak);
 static void norm_reset(cell ncell);
 int cell_find_lift(cell,Ipnt);
 
-static psys     Poly_Sys=0;
-static node     Poly_Sols=0;
-static Imatrix  Poly_Type=0;
-static Imatrix  Poly_Norm=0;
-static Imatrix  Poly_TNorm=0;
-static Ipnt     *Poly_Pnts=0;
+static thread_local psys     Poly_Sys=0;
+static thread_local node     Poly_Sols=0;
+static thread_local Imatrix  Poly_Type=0;
+static thread_local Imatrix  Poly_Norm=0;
+static thread_local Imatrix  Poly_TNorm=0;
+static thread_local Ipnt     *Poly_Pnts=0;
 #define PPnts(i) (Poly_Pnts[(i)-1])
-static HMatrix   Poly_H=0;
-static HMatrix   Poly_U=0;
+static thread_local HMatrix   Poly_H=0;
+static thread_local HMatrix   Poly_U=0;
 #define Poly_Type(i) (*IVref(Poly_Type,i))
 #define Poly_Norm(i) (*IVref(Poly_Norm,i))
 #define Poly_TNorm(i) (*IVref(Poly_TNorm,i))
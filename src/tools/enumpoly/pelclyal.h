@@ -92,29 +92,29 @@ the files cly* in the original distribution.
 /*
 ** Global  Variables
 */ 
-extern int cly_Npts;   /* The number of points in the pt config*/
-extern int cly_N;       /* the dimension of the cayley point config */
-extern int cly_R;       /* the number of point configs */
-extern int cly_Dim;      /* the dimension of the Aset */
-extern int next_id;     /* unique id#s for cells (for debugging)*/
+extern thread_local int cly_Npts;   /* The number of points in the pt config*/
+extern thread_local int cly_N;       /* the dimension of the cayley point config */
+extern thread_local int cly_R;       /* the number of point configs */
+extern thread_local int cly_Dim;      /* the dimension of the Aset */
+extern thread_local int next_id;     /* unique id#s for cells (for debugging)*/
 extern FILE *cly_out;
 
 /* 
 ** The matrices here are used for now to avoid problems,
 ** they will eventually be stored with the individual cells.
 */
-extern HMatrix cly_U;   /* factor matrix */
-extern HMatrix cly_M;   /* an n+1xn+1 matrix   */
-extern HMatrix cly_L;   /* an n+1 vector   */
-extern Imatrix cly_T;   /* an R vector */
-extern Hint cly_temp;
-extern int cly_det;
+extern thread_local HMatrix cly_U;   /* factor matrix */
+extern thread_local HMatrix cly_M;   /* an n+1xn+1 matrix   */
+extern thread_local HMatrix cly_L;   /* an n+1 vector   */
+extern thread_local Imatrix cly_T;   /* an R vector */
+extern thread_local Hint cly_temp;
+extern thread_local int cly_det;
 /*
 ** controll parameters
 **
 */
-extern int cly_order;
-extern int cly_lift;
+extern thread_local int cly_order;
+extern thread_local int cly_lift;
 
 /* end cly_globals.h */
 
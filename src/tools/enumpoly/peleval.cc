@@ -4,7 +4,7 @@
 
 #include "peleval.h"
 
-int EvLev=0;
+thread_local int EvLev=0;
 
 Gen_node Eval(Gen_node g)
 { Gen_node (*proc)(Gen_node),arg,ptr,ans;
@@ -5,14 +5,14 @@
 #include <iostream>
 #include "pelgennd.h"
 
-extern node SaveList;
+extern thread_local node SaveList;
 node Dlist_add(node,node);
 node Dlist_del(node,node);
 node Dlist_data(node);
 
 
-Pring Def_Ring;
-int N;
+thread_local Pring Def_Ring;
+thread_local int N;
 
 
 Gen_node gen_node()
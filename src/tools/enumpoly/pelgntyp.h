@@ -79,8 +79,8 @@ struct Gen_node_tag {
 	 struct Gen_node_tag *lval;
        } Genval;
      };
-extern Pring Def_Ring;
-extern int N;
+extern thread_local Pring Def_Ring;
+extern thread_local int N;
 
 Gen_node gen_node(); /* constructor for Gen_node */
 Gen_node free_Gen_node(Gen_node); 
@@ -30,7 +30,7 @@ void print_Hom_params(FILE *outfile){
 #define TRUE_ (1)
 #define FALSE_ (0)
 double get_abs_homog();
-double coord_r, coord_i;
+thread_local double coord_r, coord_i;
 
 /* Table of constant values */
 
@@ -75,19 +75,19 @@ static integer c__1 = 1;
     // integer s_wsfe(), do_fio(), e_wsfe(); /* in Hom_params.c these are int's */
 
     /* Local variables */
-    static int nfec;
-    static double hold;
-    static int iter;
+    static thread_local int nfec;
+    static thread_local double hold;
+    static thread_local int iter;
     extern double dnrm2_(integer    *n, 
 			 doublereal *dx, 
 			 integer    *incx);
-    static double h, s;
-    static long int crash;
-    static int limit;
+    static thread_local double h, s;
+    static thread_local long int crash;
+    static thread_local int limit;
     extern double d1mach_(integer *);
-    static long int start;
-    static int nc, iflagc, jw;
-    static double abserr, relerr;
+    static thread_local long int start;
+    static thread_local int nc, iflagc, jw;
+    static thread_local double abserr, relerr;
     extern /* Subroutine */ int stepnf_(integer    *n, 
 					integer    *nfe, 
 					integer    *iflag, 
@@ -115,7 +115,7 @@ static integer c__1 = 1;
 					doublereal *par, 
 					integer    *ipar);
 
-    static double curtol;
+    static thread_local double curtol;
 
     extern /* Subroutine */ int rootnf_(int    *n, 
 					int    *nfe, 
@@ -135,8 +135,8 @@ static integer c__1 = 1;
 					double *wp, 
 					double *par, 
 					int    *ipar);
-    static int np1;
-    static long int polsys;
+    static thread_local int np1;
+    static thread_local long int polsys;
 
 
 
@@ -721,12 +721,15 @@ P ONLY. */
 -------------------------------------------------------------------*/
 #define TOPN 20       /*Assume no more than 20 variables*/
 #define TOPM 500      /* Assume no more than 500 monomials total*/
-static int Istore[TOPM*(TOPN+1)+3*TOPN+2+TOPM];
-static double Dstore[TOPM*2+12*(TOPN+1)+8+TOPN*(TOPN+2)+1];
-static int didx=0,iidx=0;
+#define ISTORE_SIZE (TOPM*(TOPN+1)+3*TOPN+2+TOPM)
+#define DSTORE_SIZE (TOPM*2+12*(TOPN+1)+8+TOPN*(TOPN+2)+1)
+static thread_local int Istore[ISTORE_SIZE];
+static thread_local double Dstore[DSTORE_SIZE];
+static thread_local int didx=0,iidx=0;
 
 /* initialization for storage  currently static should be
-   made dynamic*/
+   made dynamic.  The store is per thread, so that paths may be
+   tracked concurrently (see Hom_state below) */
 
 /* access funtions to double storage */
 double *Dres(int sz){ int v=didx; didx+=sz; return Dstore+v;}
@@ -750,8 +753,8 @@ doublereal d1mach_(integer *i)
 {
     /* Initialized data */
 
-    static integer sc = 987;
-    static struct {
+    static thread_local integer sc = 987;
+    static thread_local struct {
 	integer e_1[10];
 	doublereal e_2;
     } equiv_4 = { { 0, 1048576, -1, 2146435071, 0, 1017118720, 0, 
@@ -1164,7 +1167,7 @@ L999:
     integer i__1;
 
     /* Local variables */
-    static integer i, m, ix, iy, mp1;
+    static thread_local integer i, m, ix, iy, mp1;
 
 
 /*     constant times a vector plus a vector. */
@@ -1254,7 +1257,7 @@ L40:
     integer i__1;
 
     /* Local variables */
-    static integer i, m, ix, iy, mp1;
+    static thread_local integer i, m, ix, iy, mp1;
 
 
 /*     copies a vector, x, to a vector, y. */
@@ -1355,17 +1358,17 @@ L40:
     /*     double sqrt(double);  CANT DECLARE BUILTINS UNDER C++ */
 
     /* Local variables */
-    static doublereal beta;
-    static integer jbar;
+    static thread_local doublereal beta;
+    static thread_local integer jbar;
     extern doublereal ddot_(integer    *n,
 		 doublereal *dx,
 		 integer    *incx,
 		 doublereal *dy,
 		 integer    *incy);
-    static doublereal qrkk;
-    static integer i, j, k;
-    static doublereal sigma, alphak;
-    static integer kp1, np1;
+    static thread_local doublereal qrkk;
+    static thread_local integer i, j, k;
+    static thread_local doublereal sigma, alphak;
+    static thread_local integer kp1, np1;
 
 
 /* SUBROUTINE  DCPOSE  IS A MODIFICATION OF THE ALGOL PROCEDURE */
@@ -1487,9 +1490,9 @@ doublereal ddot_(integer    *n,
     doublereal ret_val;
 
     /* Local variables */
-    static integer i, m;
-    static doublereal dtemp;
-    static integer ix, iy, mp1;
+    static thread_local integer i, m;
+    static thread_local doublereal dtemp;
+    static thread_local integer ix, iy, mp1;
 
 
 /*     forms the dot product of two vectors. */
@@ -1578,7 +1581,7 @@ static integer c__2 = 2;
 			   doublereal *zzzz, 
 			   integer    *ierr)
 {
-    static doublereal xnum, denom;
+    static thread_local doublereal xnum, denom;
     extern doublereal d1mach_(integer *i);
 
 
@@ -1653,16 +1656,16 @@ doublereal dnrm2_(integer    *n,
 {
     /* Initialized data */
 
-    static doublereal zero = 0.;
-    static doublereal one = 1.;
-    static doublereal cutlo = 8.232e-11;
-    static doublereal cuthi = 1.304e19;
+    static thread_local doublereal zero = 0.;
+    static thread_local doublereal one = 1.;
+    static thread_local doublereal cutlo = 8.232e-11;
+    static thread_local doublereal cuthi = 1.304e19;
 
     /* Format strings */
-    static char fmt_30[] = "";
-    static char fmt_50[] = "";
-    static char fmt_70[] = "";
-    static char fmt_110[] = "";
+    static thread_local char fmt_30[] = "";
+    static thread_local char fmt_50[] = "";
+    static thread_local char fmt_70[] = "";
+    static thread_local char fmt_110[] = "";
 
     /* System generated locals */
     integer i__1;
@@ -1672,9 +1675,9 @@ doublereal dnrm2_(integer    *n,
     /*    double sqrt(double); CANT DECLARE BUILTINS UNDER C++ */
 
     /* Local variables */
-    static doublereal xmax;
-    static integer next, i, j, ix;
-    static doublereal hitest, sum;
+    static thread_local doublereal xmax;
+    static thread_local integer next, i, j, ix;
+    static thread_local doublereal hitest, sum;
 
     /* Assigned format variables */
     char *next_fmt;
@@ -1867,7 +1870,7 @@ L300:
     integer i__1, i__2;
 
     /* Local variables */
-    static integer i, m, nincx, mp1;
+    static thread_local integer i, m, nincx, mp1;
 
 
 /*     scales a vector by a constant. */
@@ -1987,8 +1990,8 @@ integer idamax_(integer    *n,
     doublereal d__1;
 
     /* Local variables */
-    static doublereal dmax_;
-    static integer i, ix;
+    static thread_local doublereal dmax_;
+    static thread_local integer i, ix;
 
 
 /*     finds the index of element having max. absolute value. */
@@ -2078,12 +2081,12 @@ static doublereal c_b17 = 1.;
     double d_sign(double *arg1, double *arg2);
 
     /* Local variables */
-    static doublereal acmb, acbs, a, p, q, u;
+    static thread_local doublereal acmb, acbs, a, p, q, u;
     extern doublereal d1mach_(integer *i);
-    static integer kount;
-    static doublereal ae, fa, fb, fc;
-    static integer ic;
-    static doublereal re, fx, cmb, tol;
+    static thread_local integer kount;
+    static thread_local doublereal ae, fa, fb, fc;
+    static thread_local integer ic;
+    static thread_local doublereal re, fx, cmb, tol;
 
 
 /*  ROOT COMPUTES A ROOT OF THE NONLINEAR EQUATION F(X)=0 */
@@ -2336,8 +2339,8 @@ static int c__1 = 1;
     double d__1;
 
     /* Local variables */
-    static double dels, aerr, rerr;
-    static int judy;
+    static thread_local double dels, aerr, rerr;
+    static thread_local int judy;
     extern /* Subroutine */ int root_(doublereal *t, 
 				      doublereal *ft, 
 				      doublereal *b, 
@@ -2345,17 +2348,17 @@ static int c__1 = 1;
 				      doublereal *relerr, 
 				      doublereal *abserr, 
 				      integer    *iflag);
-    static double sout;
+    static thread_local double sout;
     extern double dnrm2_(integer    *n, 
 			 doublereal *dx, 
 			 integer    *incx);
-    static double u;
-    static int lcode;
+    static thread_local double u;
+    static thread_local int lcode;
     extern double d1mach_(integer *);
-    static double qsout, sa, sb;
-    static int jw;
+    static thread_local double qsout, sa, sb;
+    static thread_local int jw;
     /* extern */ /* Subroutine */ /* int tangnf_(); IN pelutils.h */
-    static int np1;
+    static thread_local int np1;
 
 
 /* ROOTNF  FINDS THE POINT  YBAR = (1, XBAR)  ON THE ZERO CURVE OF THE */
@@ -2620,22 +2623,22 @@ static integer c__1 = 1;
     /*    double sqrt(double), pow(double,double); CANT DECLARE BUILTINS UNDER C++ */
 
     /* Local variables */
-    static logical fail;
-    static doublereal temp;
-    static integer judy;
-    static doublereal twou;
+    static thread_local logical fail;
+    static thread_local doublereal temp;
+    static thread_local integer judy;
+    static thread_local doublereal twou;
     extern doublereal dnrm2_(integer    *n, 
 			     doublereal *dx, 
 			     integer    *incx);
-    static doublereal dcalc;
-    static integer j;
-    static doublereal lcalc, hfail, rcalc;
-    static integer itnum;
+    static thread_local doublereal dcalc;
+    static thread_local integer j;
+    static thread_local doublereal lcalc, hfail, rcalc;
+    static thread_local integer itnum;
     extern doublereal d1mach_(integer *i);
-    static doublereal fouru, ht;
+    static thread_local doublereal fouru, ht;
     /*extern */ /* Subroutine */ /* int tangnf_(); IN pelutils.h */
-    static doublereal rholen;
-    static integer np1;
+    static thread_local doublereal rholen;
+    static thread_local integer np1;
 
 
 /*  STEPNF  TAKES ONE STEP ALONG THE ZERO CURVE OF THE HOMOTOPY MAP */
@@ -3306,20 +3309,21 @@ to that used by hompack and described in Morgans book.
 -----------------------------------------------------------------*/
 
 /* parameters affecting the homotopy */
-int Hom_defd = 0;         /* 0 no homotopy initialized , 1 else*/
+thread_local int Hom_defd = 0;  /* 0 no homotopy initialized , 1 else*/
 int Hom_use_proj = 1;     /* 0 dont use proj trans, 1 else*/
-int Hom_num_vars = 0;     /* number of complex vars in curr hom*/
-
-/* private variables defining homotopy */
-static int NV,N,N1,M; 
-static int *Starting_Monomial; 
-static int *Number_of_Monomials;
-static int *Exponents; 
-static int *Hdegree;
-static int *Edegree;
-static double *Coefitients; 
-static int *Deformation; 
-static double *Proj_Trans;
+thread_local int Hom_num_vars = 0;  /* number of complex vars in curr hom*/
+
+/* private variables defining homotopy; like the workspace they
+   live in, these are per thread */
+static thread_local int NV,N,N1,M; 
+static thread_local int *Starting_Monomial; 
+static thread_local int *Number_of_Monomials;
+static thread_local int *Exponents; 
+static thread_local int *Hdegree;
+static thread_local int *Edegree;
+static thread_local double *Coefitients; 
+static thread_local int *Deformation; 
+static thread_local double *Proj_Trans;
 
 /* index in monomial list (starting at 0) of equation i*/
 #define monst(i,j) ((Starting_Monomial[(i)-1])+(j)-1)
@@ -3349,7 +3353,7 @@ static double *Proj_Trans;
 /* degree of equation i */
 #define Edeg(i) Edegree[i-1]
 
-extern Pring Def_Ring;
+extern thread_local Pring Def_Ring;
 Pvector psys_to_Pvec(psys sys){
  polynomial1 tmpm,tmpp;
  int j;
@@ -3421,11 +3425,7 @@ Hdegree=Ires(M);
 Edegree=Ires(NV);
 Proj_Trans=Dres(2*NV+2);
 
-#if defined(HAVE_SRAND48)
-srand48(seed);
-#else
-srand(seed);
-#endif  /* defined(HAVE_SRAND48) */
+rand_seed(seed);
 
 for(i=1;i<=NV;i++){                             
     j=1; ptr=*PMref(P,1,i); Edeg(i)=0;
@@ -3447,9 +3447,9 @@ for(i=1;i<=NV;i++){
 /*Define Projective transformation */
 for(j=1;j<=NV+1;j++){
 #if defined(HAVE_DRAND48)
-  t=drand48()*2*PI;
+  t=pel_drand48()*2*PI;
 #else
-  t=rand()*2*PI;
+  t=pel_rand()*2*PI;
 #endif  /* defined(HAVE_DRAND48) */
   RPtrans(j)=cos(t);
   IPtrans(j)=sin(t); 
@@ -3459,6 +3459,63 @@ Pvector_free(P);
 return Hom_defd;
 }
 
+/*-------------------------------------------------------------------
+ Hom_state_save copies the homotopy defined (by init_hom) on the 
+           calling thread, so that Hom_state_load can install it on 
+           another thread before tracking paths there.  Since init_hom
+           places the homotopy at the bottom of the workspace, it is
+           enough to copy the used part of the store and record where
+           the arrays start.
+-------------------------------------------------------------------*/
+struct Hom_state_t {
+  int defd, nv, n, n1, m;
+  int itop, dtop;
+  int *istore;
+  double *dstore;
+  int sm, nm, ex, hd, ed, df;    /* offsets into istore */
+  int cf, pt;                    /* offsets into dstore */
+};
+
+Hom_state Hom_state_save(void){
+  Hom_state S;
+  int i;
+  /* plain malloc, since states may be freed on a worker thread */
+  S=(Hom_state)malloc(sizeof(struct Hom_state_t));
+  S->defd=Hom_defd; 
+  S->nv=NV; S->n=N; S->n1=N1; S->m=M;
+  S->itop=iidx; S->dtop=didx;
+  S->istore=(int *)malloc((iidx+1)*sizeof(int));
+  S->dstore=(double *)malloc((didx+1)*sizeof(double));
+  for(i=0;i<iidx;i++) S->istore[i]=Istore[i];
+  for(i=0;i<didx;i++) S->dstore[i]=Dstore[i];
+  S->sm=Starting_Monomial-Istore; S->nm=Number_of_Monomials-Istore;
+  S->ex=Exponents-Istore; S->hd=Hdegree-Istore; 
+  S->ed=Edegree-Istore; S->df=Deformation-Istore;
+  S->cf=Coefitients-Dstore; S->pt=Proj_Trans-Dstore;
+  return S;
+}
+
+void Hom_state_load(Hom_state S){
+  int i;
+  for(i=0;i<S->itop;i++) Istore[i]=S->istore[i];
+  for(i=0;i<S->dtop;i++) Dstore[i]=S->dstore[i];
+  iidx=S->itop; didx=S->dtop;
+  NV=S->nv; N=S->n; N1=S->n1; M=S->m;
+  Starting_Monomial=Istore+S->sm; Number_of_Monomials=Istore+S->nm;
+  Exponents=Istore+S->ex; Hdegree=Istore+S->hd;
+  Edegree=Istore+S->ed; Deformation=Istore+S->df;
+  Coefitients=Dstore+S->cf; Proj_Trans=Dstore+S->pt;
+  Hom_num_vars=NV;
+  Hom_defd=S->defd;
+}
+
+void Hom_state_free(Hom_state S){
+  if (S==0) return;
+  free(S->istore);
+  free(S->dstore);
+  free(S);
+}
+
 void print_homog(double *x,double *coord_r,double *coord_i){
  int i;
  fcomplex PN;
@@ -3691,19 +3748,19 @@ return 0;
 
     /* Local variables */
     /*    extern */ /* Subroutine */ /* int fjac_(); */
-    static double beta;
-    static int jbar;
+    static thread_local double beta;
+    static thread_local int jbar;
     /*     extern double ddot_(); */
-    static double qrkk;
+    static thread_local double qrkk;
     /*    extern double dnrm2_(); */
     /*    extern */ /* Subroutine */ /* int f_(); */
-    static int i, j, k;
-    static double sigma, lambda, alphak;
+    static thread_local int i, j, k;
+    static thread_local double sigma, lambda, alphak;
     /*    extern */ /* Subroutine */ /* int rhojac_(); */
-    static int kp1, np1, np2;
-    static double ypnorm;
+    static thread_local int kp1, np1, np2;
+    static thread_local double ypnorm;
     /*    extern */ /* Subroutine */ /* int rho_(); */
-    static double sum;
+    static thread_local double sum;
 
 
 /* THIS SUBROUTINE BUILDS THE JACOBIAN MATRIX OF THE HOMOTOPY MAP, */
@@ -37,10 +37,10 @@ subdirectory of the source directory of the original Pelican 0.80
 
 #define Hom_LogFile stdout /* was Pel_Log */
 #define Hom_OutFile stdout /* was Pel_Out */
-extern int     Hom_defd; 
+extern thread_local int Hom_defd; 
 extern int     Hom_use_proj;
 extern int     Hom_use_scale;
-extern int     Hom_num_vars;
+extern thread_local int Hom_num_vars;
 extern char    Hom_LogName[];
 extern FILE   *Pel_Log;
 extern FILE   *Pel_Out;
@@ -341,6 +341,13 @@ void Htransform(Dvector X);
 void Huntransform(Dvector X);
 int HPK_cont(Dvector X);
 
+/* a copy of the homotopy defined on the calling thread, which can be
+   installed on another thread to track paths there */
+typedef struct Hom_state_t *Hom_state;
+Hom_state Hom_state_save(void);
+void Hom_state_load(Hom_state S);
+void Hom_state_free(Hom_state S);
+
 /* end, original Homotopies.h */
 
 /************************************************************************/
@@ -9,7 +9,7 @@
 
 #include "pelprgen.h"
 
-static int time0 = 0; /* initialized to 0 to get rid of warning - AMM */
+static thread_local int time0 = 0; /* initialized to 0 to get rid of warning - AMM */
 
 /* --------------------------------------------------------------
  Install_Command(Gen_node (*G)(),char *s)
@@ -578,10 +578,14 @@ Gen_node G_Solve(Gen_node g, int tweak){
    P=Gen_to_psys(Gen_elt(g,1));
    Nl=Gen_to_Ivector_list(Gen_lval(Gen_elt(g,2)));
    time0=set_mark();
+   /* paths of each cell are tracked while the start systems of 
+      the remaining cells are set up */
+   HPK_begin(tweak);
    while (Nl!=0){
      Sl=list_cat(psys_solve(P,(Imatrix)Car(Car(Nl)),tweak),Sl);
      Nl=Cdr(Nl);
    }
+   HPK_end();
    /*   Pel_New_Log(strcat(FilePrefix,".start")); */
 #ifdef G_SOLVE_PRINT 
   fprintf(stdout /* was Pel_Log */,"%% Pelican Output File: Generic System and Solutions\n");
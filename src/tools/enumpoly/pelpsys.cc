@@ -844,7 +844,7 @@ void psys_save_mon(psys sys, int i){
 /*
 ** Display functions
 */
-extern Pring Def_Ring;
+extern thread_local Pring Def_Ring;
 
 
 psys psys_fprint(FILE *fout,psys sys){
@@ -1243,7 +1243,7 @@ return M;}
 /******************* implementation code from psys_hom.c ******************/
 /**************************************************************************/
 
-static Imatrix Norm=0;
+static thread_local Imatrix Norm=0;
 
 node psys_hom(psys sys, node point_list, int tweak){
   node ptr=point_list;   
@@ -1256,10 +1256,7 @@ node psys_hom(psys sys, node point_list, int tweak){
 
   if (Cont_Alg==USE_HOMPACK){
      init_hom(sys);
-     while(ptr!=0){
-       HPK_cont((Dmatrix)Car(Car(ptr)), tweak);
-       ptr=Cdr(ptr);
-     }
+     HPK_track(ptr, tweak);
   }
   else {
     while(ptr!=0){
@@ -39,6 +39,7 @@ typedef struct psys_t *psys;
 
 /* These declarations are added to get compilation.  Linking is another matter... */
 int HPK_cont(Dvector, int tweak);
+int HPK_track(node, int tweak);
 int init_hom(psys);
 
 /* creator/destructor*/
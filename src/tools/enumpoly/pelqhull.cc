@@ -46,7 +46,7 @@ Geometry Center.
     see mem.h for definition
 */
 
-qhmemT qhmem= {0};     /* remove "= {0}" if this causes a compiler error */
+thread_local qhmemT qhmem= {0};     /* remove "= {0}" if this causes a compiler error */
 
 /* internal functions */
   
@@ -2777,9 +2777,9 @@ pointT *qh_voronoi_center (int dim, setT *points) {
 */
 
 #if qh_QHpointer
-qhstatT *qh_qhstat=NULL;  /* global data structure */
+thread_local qhstatT *qh_qhstat=NULL;  /* global data structure */
 #else
-qhstatT qh_qhstat;   /* remove "={0}" if this causes a compiler error */
+thread_local qhstatT qh_qhstat;   /* remove "={0}" if this causes a compiler error */
 #endif
 
 
@@ -7370,9 +7370,9 @@ void qh_vertexridges_facet (vertexT *vertex, facetT *facet, setT **ridges) {
 */
 
 #if qh_QHpointer
-qhT *qh_qh=  NULL;
+thread_local qhT *qh_qh=  NULL;
 #else
-qhT qh_qh; /*= {0};*/ /* remove "= {0}" if this causes a compiler error.  Also
+thread_local qhT qh_qh; /*= {0};*/ /* remove "= {0}" if this causes a compiler error.  Also
 		     qh_qhstat in stat.c and qhmem in mem.c.  */
 #endif
 
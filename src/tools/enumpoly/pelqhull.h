@@ -256,10 +256,10 @@ typedef struct qhT qhT;
 #define qh_QHpointer 0  /* 1 for dynamic allocation, 0 for global structure */
 #if qh_QHpointer
 #define qh qh_qh->
-extern qhT *qh_qh;     /* allocated in global.c */
+extern thread_local qhT *qh_qh;     /* allocated in global.c */
 #else
 #define qh qh_qh.
-extern qhT qh_qh;
+extern thread_local qhT qh_qh;
 #endif
 
 struct qhT {
@@ -665,8 +665,12 @@ void    qh_printstatistics (FILE *fp, const char *string);
 #define qh_RANDOMmax 2147483647  /* Kludge added, ignorantly, by AMM */
 
                                 /* WARNING: Sun produces 31 bits from rand() */
-#define qh_RANDOMint  rand()
-#define qh_RANDOMseed_(seed) srand((unsigned)seed);
+/* Pelican's per-thread generator (pelutils.cc), so that qhull runs on
+   different threads do not share random state */
+int pel_rand(void);
+void rand_seed(long int seedval);
+#define qh_RANDOMint  pel_rand()
+#define qh_RANDOMseed_(seed) rand_seed((long int)seed);
 #endif
 
 #define qh_MEMalign fmax_(sizeof(realT), sizeof(void *))
@@ -717,7 +721,7 @@ void    qh_printstatistics (FILE *fp, const char *string);
 */
 
 typedef struct qhmemT qhmemT;
-extern qhmemT qhmem;  /* allocated in mem.c */
+extern thread_local qhmemT qhmem;  /* allocated in mem.c */
 
 struct qhmemT {               /* global memory management variables */
   int      BUFsize;	      /* size of memory allocation buffer */
@@ -1766,10 +1770,10 @@ typedef union intrealT intrealT;    /* union of int and realT */
 
 #if qh_QHpointer
 #define qhstat qh_qhstat->
-extern qhstatT *qh_qhstat;  /* allocated in stat.c */
+extern thread_local qhstatT *qh_qhstat;  /* allocated in stat.c */
 #else
 #define qhstat qh_qhstat.
-extern qhstatT qh_qhstat;  /* allocated in stat.c */
+extern thread_local qhstatT qh_qhstat;  /* allocated in stat.c */
 #endif
 
 /*-------------------------------------------
@@ -5,7 +5,7 @@
 #include "pelsymbl.h"
 
 #define HASHSIZE 100
-static Sym_ent hashtab[HASHSIZE];
+static thread_local Sym_ent hashtab[HASHSIZE];
 
 /*-----------------------------------------------------------------
 empty_symbol_table()
@@ -77,11 +77,11 @@ struct node_block_t {
 
 
 
-static int N_MALLOC = 0;	/*number of mallocs called from module */
-static int N_FREE = 0;		/*number of frees called from this module */
-static node_block Node_Store = 0;	/*beginning of node storage */
-static node Free_List = 0;	/*top of free node list */
-static local_v Locals_Stack = 0;	/*stack of  declared pointers 
+static thread_local int N_MALLOC = 0;	/*number of mallocs called from module */
+static thread_local int N_FREE = 0;		/*number of frees called from this module */
+static thread_local node_block Node_Store = 0;	/*beginning of node storage */
+static thread_local node Free_List = 0;	/*top of free node list */
+static thread_local local_v Locals_Stack = 0;	/*stack of  declared pointers 
 					   into node storage */
 
 
@@ -505,16 +505,68 @@ fprintf(stderr /* was Pel_Err */,"Warning:%s\n",m)
 /*********************** implementations from Rand.c **********************/
 /**************************************************************************/
 
+/*
+** The generator state is per thread, so that solves running on 
+** different threads neither interfere with each other nor change 
+** each other's results.  pel_rand and pel_drand48 produce the same
+** sequences as glibc's rand() and drand48() would after the same seed.
+*/
+static thread_local int rand_state[34];
+static thread_local int rand_pos = 0;
+static thread_local int rand_seeded = FALSE;
+static thread_local unsigned short rand48_state[3] = { 0x330E, 0, 0 };
+
 /*
 ** rand_seed  -- seed the random number generator with seedval.
 */
 void rand_seed(long int seedval)
 {
-#if defined(HAVE_SRAND48)
-srand48(seedval);
+  int i;
+  long long r;
+  /* additive feedback generator r[i]=r[i-3]+r[i-31], seeded by a
+     multiplicative congruential generator */
+  rand_state[0] = (int)((unsigned int) seedval);
+  if (rand_state[0] == 0) rand_state[0] = 1;
+  for (i = 1; i < 31; i++) {
+    r = (16807LL * rand_state[i-1]) % 2147483647;
+    if (r < 0) r += 2147483647;
+    rand_state[i] = (int) r;
+  }
+  for (i = 31; i < 34; i++) rand_state[i] = rand_state[i-31];
+  rand_pos = 0;
+  rand_seeded = TRUE;
+  for (i = 34; i < 344; i++) pel_rand();
+  rand48_state[0] = 0x330E;
+  rand48_state[1] = (unsigned short) seedval;
+  rand48_state[2] = (unsigned short) (seedval >> 16);
+}
+
+/*
+** pel_rand -- the next integer between 0 and 2^31-1
+*/
+int pel_rand(void)
+{
+  unsigned int r;
+  if (!rand_seeded) rand_seed(1);
+  /* with 34 slots, slot rand_pos holds r[i-34]; r[i-31] and r[i-3] 
+     are at offsets 3 and 31 */
+  r = (unsigned int) rand_state[(rand_pos + 3) % 34] +
+      (unsigned int) rand_state[(rand_pos + 31) % 34];
+  rand_state[rand_pos] = (int) r;
+  rand_pos = (rand_pos + 1) % 34;
+  return (int) (r >> 1);
+}
+
+/*
+** pel_drand48 -- the next double in [0,1)
+*/
+double pel_drand48(void)
+{
+#if defined(HAVE_DRAND48)
+  return erand48(rand48_state);
 #else
-srand(seedval);
-#endif  /* defined(HAVE_SRAND48) */
+  return pel_rand() / 2147483648.0;
+#endif  /* defined(HAVE_DRAND48) */
 }
 
 /*
@@ -527,9 +579,9 @@ srand(seedval);
 int rand_int(int low, int high)
 {
 #if defined(HAVE_DRAND48)
-  return (int)(low+drand48()*(high-low)+.499999999999); 
+  return (int)(low+pel_drand48()*(high-low)+.499999999999); 
 #else
-  return (int)(low+rand()*(high-low)+.499999999999); 
+  return (int)(low+pel_rand()*(high-low)+.499999999999); 
 #endif  /* defined(HAVE_DRAND48) */
 }
 
@@ -539,9 +591,9 @@ int rand_int(int low, int high)
 double rand_double(int low, int high)
 {
 #if defined(HAVE_DRAND48)
-  return (drand48()*(high-low)+low);
+  return (pel_drand48()*(high-low)+low);
 #else
-  return (rand()*(high-low)+low);
+  return (pel_rand()*(high-low)+low);
 #endif  /* defined(HAVE_DRAND48) */
 }
 
@@ -3168,7 +3220,7 @@ Imatrix aset_M(node A, Imatrix M)
 /********************** implementations from Types.c **********************/
 /**************************************************************************/
 
-static int level=0;
+static thread_local int level=0;
 node node_print(node N)
 {
   /*DEBUG */
@@ -3432,9 +3484,9 @@ void xpnt_normalize(xpnt X){
 /*
 ** global storage for Lin prog solver
 */
-int LP_M=0, LP_N=0;
-Dmatrix LP_A=0, LP_B=0, LP_C=0, LP_X=0,LP_Q=0, LP_R=0, LP_T1=0, LP_T2=0;
-Ivector LP_basis=0, LP_nonbasis=0;
+thread_local int LP_M=0, LP_N=0;
+thread_local Dmatrix LP_A=0, LP_B=0, LP_C=0, LP_X=0,LP_Q=0, LP_R=0, LP_T1=0, LP_T2=0;
+thread_local Ivector LP_basis=0, LP_nonbasis=0;
 extern double RS_zt;
 
 #define X(i) (DVref(LP_X,i))
@@ -4072,10 +4124,10 @@ fprintf(msd_out,": ")
 **                    --+-----      --+-----
 **                     Face_1       Face_2
 */
- node List_Store=0;
- int List_R=0;
- node *List_Start;
- node *List_Ptrs;
+ thread_local node List_Store=0;
+ thread_local int List_R=0;
+ thread_local node *List_Start;
+ thread_local node *List_Ptrs;
  #define LStart(i)  (List_Start[(i)-1])
  #define LPtr(i)    (List_Ptrs[(i)-1])
 
@@ -4172,10 +4224,10 @@ int next_face(Cell_I *C,Aset_I A, int r){
 ** Intermediate testing -- handles testing for all incomplete cells
 */
 
-static int MSD_LP_M=0, MSD_LP_N=0;
-static Dmatrix MSD_LP_A=0, MSD_LP_B=0, MSD_LP_C=0, MSD_LP_X=0;
-static Dmatrix MSD_LP_Q=0, MSD_LP_R=0, MSD_LP_T1=0, MSD_LP_T2=0;
-static Ivector MSD_LP_basis=0, MSD_LP_nonbasis=0;
+static thread_local int MSD_LP_M=0, MSD_LP_N=0;
+static thread_local Dmatrix MSD_LP_A=0, MSD_LP_B=0, MSD_LP_C=0, MSD_LP_X=0;
+static thread_local Dmatrix MSD_LP_Q=0, MSD_LP_R=0, MSD_LP_T1=0, MSD_LP_T2=0;
+static thread_local Ivector MSD_LP_basis=0, MSD_LP_nonbasis=0;
 
 /*
 ** set_up_LP
@@ -4310,10 +4362,10 @@ void Load_LP(int st,int tp,Cell_I C, Aset_I A){
 /*
 ** Final testing -- Verification of complete cells
 */
-Imatrix M;
-Imatrix U; 
-Imatrix Norm;
-int vol;
+thread_local Imatrix M;
+thread_local Imatrix U; 
+thread_local Imatrix Norm;
+thread_local int vol;
 void set_up_Final(int n){
  M=Imatrix_new(n,n+1);
  U=Imatrix_new(n,n);
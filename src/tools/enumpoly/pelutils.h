@@ -229,6 +229,8 @@ void warning(const char *);
 /**************************************************************************/
 
 void rand_seed(long int seedval);
+int pel_rand(void);
+double pel_drand48(void);
 int rand_int(int low, int high);
 double rand_double(int low, int high);
 
@@ -0,0 +1,192 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2022, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/enumpoly/suppipe.h
+// Solve a sequence of supports on a pool of threads
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef SUPPIPE_H
+#define SUPPIPE_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gambit.h"
+
+//
+// Supports are produced on the calling thread, solved by a pool of
+// worker threads, and their results are consumed on the calling thread
+// again, in the order in which the supports were produced.
+//
+// Game objects are not safe to share among threads, so each worker
+// solves on its own copy of the game.  A task passed from the producer
+// to a worker, and a result passed back, must therefore be plain data
+// which does not refer to any game object.
+//
+// At most p_window supports are queued, being solved, or waiting for
+// the results of earlier supports at any time; this bounds the memory
+// held by the pipeline when one support takes much longer than those
+// after it.
+//
+// With one thread, or when called on a worker of another parallel layer,
+// each support is produced, solved on p_game, and consumed in turn on the
+// calling thread.
+//
+template <class Task, class Result>
+class SupportPipeline {
+public:
+  typedef std::function<Task (int)> Producer;
+  typedef std::function<Result (const Gambit::Game &, const Task &)> Solver;
+  typedef std::function<void (int, const Result &)> Consumer;
+
+  SupportPipeline(int p_numThreads, int p_window)
+    : m_numThreads(p_numThreads), m_window(p_window) { }
+
+  void Run(const Gambit::Game &p_game, int p_numSupports,
+	   Producer p_producer, Solver p_solver, Consumer p_consumer);
+
+private:
+  int m_numThreads, m_window;
+
+  std::mutex m_mutex;
+  std::condition_variable m_queued, m_solved;
+  std::deque<std::pair<int, Task> > m_tasks;
+  std::map<int, Result> m_results;
+  std::exception_ptr m_exception;
+  bool m_closed;
+
+  void Work(const Gambit::Game &p_game, const Solver &p_solver);
+};
+
+template <class Task, class Result>
+void SupportPipeline<Task, Result>::Work(const Gambit::Game &p_game,
+					 const Solver &p_solver)
+{
+  Gambit::SetWorkerThread();
+  while (true) {
+    std::pair<int, Task> task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_queued.wait(lock, [this]() { return !m_tasks.empty() || m_closed; });
+      if (m_tasks.empty()) {
+	return;
+      }
+      task = m_tasks.front();
+      m_tasks.pop_front();
+    }
+    try {
+      Result result = p_solver(p_game, task.second);
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_results.insert(std::make_pair(task.first, result));
+    }
+    catch (...) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_exception) {
+	m_exception = std::current_exception();
+      }
+    }
+    m_solved.notify_one();
+  }
+}
+
+template <class Task, class Result>
+void SupportPipeline<Task, Result>::Run(const Gambit::Game &p_game,
+					int p_numSupports,
+					Producer p_producer,
+					Solver p_solver,
+					Consumer p_consumer)
+{
+  if (m_numThreads <= 1 || Gambit::IsWorkerThread()) {
+    for (int i = 1; i <= p_numSupports; i++) {
+      p_consumer(i, p_solver(p_game, p_producer(i)));
+    }
+    return;
+  }
+
+  // Copies are made here, as copying reads the original game
+  std::vector<Gambit::Game> games;
+  for (int t = 0; t < m_numThreads; t++) {
+    games.push_back(p_game->Copy());
+  }
+
+  m_closed = false;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < m_numThreads; t++) {
+    workers.push_back(std::thread(&SupportPipeline::Work, this,
+				  std::cref(games[t]), std::cref(p_solver)));
+  }
+
+  int next = 1;
+  try {
+    for (int consumed = 1; consumed <= p_numSupports; consumed++) {
+      while (true) {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (m_exception) {
+	  std::rethrow_exception(m_exception);
+	}
+	typename std::map<int, Result>::iterator solved = m_results.find(consumed);
+	if (solved != m_results.end()) {
+	  Result result = solved->second;
+	  m_results.erase(solved);
+	  lock.unlock();
+	  p_consumer(consumed, result);
+	  break;
+	}
+	if (next <= p_numSupports && next - consumed < m_window) {
+	  lock.unlock();
+	  Task task = p_producer(next);
+	  lock.lock();
+	  m_tasks.push_back(std::make_pair(next++, task));
+	  m_queued.notify_one();
+	}
+	else {
+	  m_solved.wait(lock);
+	}
+      }
+    }
+  }
+  catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_tasks.clear();
+      m_closed = true;
+    }
+    m_queued.notify_all();
+    for (size_t t = 0; t < workers.size(); t++) {
+      workers[t].join();
+    }
+    throw;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+  }
+  m_queued.notify_all();
+  for (size_t t = 0; t < workers.size(); t++) {
+    workers[t].join();
+  }
+}
+
+#endif  // SUPPIPE_H
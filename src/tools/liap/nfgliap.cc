@@ -59,18 +59,20 @@ StrategicLyapunovFunction::LiapDerivValue(int i1, int j1,
   double x = 0.0;
   for (int i = 1; i <= m_game->NumPlayers(); i++)  {
     double psum = 0.0;
-    GamePlayer player = m_game->Players()[i];
+    GamePlayerRep *player = m_game->Players()[i];
+    // These do not depend on the strategy of player i
+    double payoff = p.GetPayoff(i);
+    double wrtDeriv = p.GetPayoffDeriv(i, wrt_strategy);
     for (int j = 1; j <= player->NumStrategies(); j++)  {
       GameStrategy strategy = player->Strategies()[j];
       psum += p[strategy];
-      double x1 = p.GetPayoff(strategy) - p.GetPayoff(i);
+      double x1 = p.GetPayoffDeriv(i, strategy) - payoff;
       if (i1 == i) {
 	if (x1 > 0.0)
-	  x -= x1 * p.GetPayoffDeriv(i, wrt_strategy);
+	  x -= x1 * wrtDeriv;
       }
       else if (x1 > 0.0) {
-	x += x1 * (p.GetPayoffDeriv(i, strategy, wrt_strategy) - 
-		   p.GetPayoffDeriv(i, wrt_strategy));
+	x += x1 * (p.GetPayoffDeriv(i, strategy, wrt_strategy) - wrtDeriv);
       }
     }
     if (i == i1)  {
@@ -81,8 +81,8 @@ protected:
   //@{
   void GetPayoff(GameTreeNodeRep *, const T &, int, T &) const;
   
-  void ComputeSolutionDataPass2(const GameNode &node) const;
-  void ComputeSolutionDataPass1(const GameNode &node) const;
+  void ComputeSolutionDataPass2(const GameTreeNodeRep *node) const;
+  void ComputeSolutionDataPass1(const GameTreeNodeRep *node) const;
   void ComputeSolutionData(void) const;
   //@}
 